@@ -22,6 +22,107 @@
  * ...do stuff with it...
  * 
  * JIIObjFreeData(&model);
+ *
+ * Faces come out as JIIObjFace16 when there are few enough vertices, check model.indexType.
+ * JII_OBJ_INDEX_32 in the load options keeps them 32 bit no matter what.
+ *
+ * JIIObjLoadOptions options = {};
+ * options.hints = JII_OBJ_INDEX_32;
+ * JIIObjStatus status = JIIObjLoadData("path/to/obj", &model, &options);
+ *
+ * Exporters love duplicating positions on uv seams, JII_OBJ_WELD_POSITIONS merges the ones
+ * closer than options.weldEpsilon and options.weldedPositions says how many went away.
+ * JII_OBJ_COMPACT throws out degenerate triangles and unused v/vt/vn, options.compactedBytes
+ * says how much memory that gave back.
+ *
+ * When the memory has to come from somewhere else (staging buffers, mapped gpu memory), query
+ * first, allocate whatever the query asks for, then fill. Nothing gets copied on the way.
+ *
+ * JIIObjModelQuery query;
+ * JIIObjStatus status = JIIObjQueryData("path/to/obj", &query);
+ * JIIObjModelData model = {};
+ * model.vertices = (JIIObjVertex*)MyAlloc(query.verticesSize);
+ * model.faces = (JIIObjFace*)MyAlloc(query.facesSize);
+ * status = JIIObjFillData(&query, &model);
+ *
+ * Loading lots of files in a row goes through a loader, it keeps its buffers between loads and
+ * the model it hands out lives until its next load.
+ *
+ * JIIObjLoader* loader = JIIObjCreateLoader();
+ * JIIObjStatus status = JIIObjLoadDataWith(loader, "path/to/obj", &model);
+ * JIIObjDestroyLoader(loader);
+ *
+ * From C++ JIIObjModel owns the data, it is move only and frees itself. Give it a JIIObjAllocator
+ * and the arrays are queried and filled straight into that memory.
+ *
+ * JIIObjModel model;
+ * JIIObjStatus status = model.Load("path/to/obj");
+ * for (JIIObjVertex& vertex : model.Vertices()) { ... }
+ *
+ * For live editing, the reloader watches files (inotify on linux, modification times elsewhere)
+ * and only reparses a file when its content hash changed, the new model shows up on the next get.
+ *
+ * JIIObjReloader* reloader = JIIObjCreateReloader();
+ * u32 asset;
+ * JIIObjStatus status = JIIObjWatchFile(reloader, "path/to/obj", &asset);
+ * ...every frame...
+ * JIIObjModelData* model = JIIObjGetReloadedData(reloader, asset);
+ *
+ * Big scenes where only a few objects are needed get indexed once (a single scan for the o/g lines,
+ * JII_OBJ_INDEX_SIDECAR keeps the result in path/to/obj.jiidx for next time) and then the objects
+ * are parsed one at a time.
+ *
+ * JIIObjIndex* index;
+ * JIIObjStatus status = JIIObjOpenIndex("path/to/obj", &index, JII_OBJ_INDEX_SIDECAR);
+ * status = JIIObjLoadObject(index, JIIObjFindObject(index, "Chair"), &model);
+ * JIIObjCloseIndex(index);
+ *
+ * Gzipped files (.obj.gz) load with JIIObjLoadGzip, inflating happens on its own thread while
+ * the parser eats whatever came out so far. JIIObjLoadDataPipelined does the same with plain files
+ * that are not in the page cache yet, parsing starts with the first chunk off the disk.
+ *
+ * Lots of small files (a level's worth of props) load together, the reads are batched through
+ * io_uring on linux (JII_OBJ_NO_IO_URING turns that off) and parsing starts as files come in.
+ *
+ * JIIObjModelData models[3];
+ * JIIObjStatus statuses[3];
+ * const char* paths[3] = { "a.obj", "b.obj", "c.obj" };
+ * JIIObjStatus status = JIIObjLoadDataBatch(paths, 3, models, statuses);
+ *
+ * Point clouds (files with nothing but v lines, maybe with colors) skip the whole face and vertex
+ * business, the points come out as separate x/y/z (and r/g/b) arrays.
+ *
+ * JIIObjPointCloud cloud;
+ * JIIObjStatus status = JIIObjLoadPointCloud("path/to/obj", &cloud);
+ * for (u32 i = 0; i < cloud.numberOfPoints; ++i) { cloud.x[i]... }
+ * JIIObjFreePointCloud(&cloud);
+ *
+ * Mesh processing usually needs to know what touches what, JIIObjBuildAdjacency builds vertex to
+ * face, vertex to vertex and edge to face tables as compressed rows straight from the faces.
+ *
+ * JIIObjAdjacency adjacency;
+ * JIIObjStatus status = JIIObjBuildAdjacency(&model, &adjacency);
+ * for (u32 i = adjacency.vertexFaceOffsets[v]; i < adjacency.vertexFaceOffsets[v + 1]; ++i) { ... }
+ * JIIObjFreeAdjacency(&adjacency);
+ *
+ * Meshes bigger than memory get cut into a grid of tiles on disk, each tile is a regular obj that
+ * loads on its own, the index says which tiles exist and where they are.
+ *
+ * JIIObjTileOptions tileOptions = {};
+ * tileOptions.tilesX = tileOptions.tilesZ = 16;
+ * tileOptions.tilesY = 1;
+ * JIIObjStatus status = JIIObjTileFile("path/to/city.obj", "path/to/tiles/city", &tileOptions);
+ * JIIObjTileIndex tiles;
+ * status = JIIObjLoadTileIndex("path/to/tiles/city.jiitiles", &tiles);
+ * char tilePath[4096];
+ * JIIObjGetTilePath("path/to/tiles/city", &tiles.tiles[0], tilePath, sizeof(tilePath));
+ * status = JIIObjLoadData(tilePath, &model);
+ * JIIObjFreeTileIndex(&tiles);
+ *
+ * Writing goes the other way around, JII_OBJ_WRITE_DEDUPLICATE shares v/vt/vn lines
+ * between vertices that have the same values instead of writing them per vertex.
+ *
+ * JIIObjStatus status = JIIObjWriteData("path/to/obj", &model, JII_OBJ_WRITE_DEDUPLICATE);
  */
 
 #pragma once
@@ -31,12 +132,20 @@
 #ifndef JII_PRIMITIVE_DEFINES
 #define JII_PRIMITIVE_DEFINES
 #include <stdint.h>
+typedef int64_t i64;
 typedef int32_t i32;
+typedef int16_t i16;
 typedef int8_t i8;
+typedef uint64_t u64;
 typedef uint32_t u32;
+typedef uint16_t u16;
 typedef uint8_t u8;
 #endif
 
+#ifdef JII_TRACE_ENABLED
+#include "jii_trace.h"
+#endif
+
 struct JIIObjPosition {
 	float x;
 	float y;
@@ -82,6 +191,22 @@ struct JIIObjFace {
 	};
 };
 
+struct JIIObjFace16 {
+	union {
+		struct {
+			u16 index0;
+			u16 index1;
+			u16 index2;
+		};
+		u16 indices[3];
+	};
+};
+
+enum JIIObjIndexType {
+	Index32,
+	Index16
+};
+
 struct JIIObjModelData {
 	JIIObjPosition* positions;
 	i32 numberOfPositions;
@@ -92,8 +217,13 @@ struct JIIObjModelData {
 	JIIObjUV* uvs;
 	i32 numberOfUVs;
 
-	JIIObjFace* faces;
+	// look at indexType before touching these
+	union {
+		JIIObjFace* faces;
+		JIIObjFace16* faces16;
+	};
 	i32 numberOfFaces;
+	JIIObjIndexType indexType;
 
 	JIIObjVertex* vertices;
 	i32 numberOfVertices;
@@ -118,605 +248,8017 @@ extern "C" {
 #endif
 #endif
 
-JIIDef JIIObjStatus JIIObjLoadData(const char* path, JIIObjModelData* data);
-JIIDef JIIObjStatus JIIObjLoadDataW(const wchar_t* path, JIIObjModelData* data);
+typedef u32 JIIObjHint;
+
+static const JIIObjHint JII_OBJ_NO_HINT = 0;
+static const JIIObjHint JII_OBJ_WRITE_DEDUPLICATE = 1 << 0;
+// by default faces are 16 bit whenever the vertices fit, these force one or the other
+static const JIIObjHint JII_OBJ_INDEX_32 = 1 << 1;
+static const JIIObjHint JII_OBJ_INDEX_16 = 1 << 2;
+// merges positions closer than weldEpsilon and the vertices/faces that end up identical
+static const JIIObjHint JII_OBJ_WELD_POSITIONS = 1 << 3;
+// drops degenerate triangles and whatever isn't referenced by a face anymore
+static const JIIObjHint JII_OBJ_COMPACT = 1 << 4;
+// JIIObjOpenIndex keeps the index in a file next to the obj
+static const JIIObjHint JII_OBJ_INDEX_SIDECAR = 1 << 5;
+
+struct JIIObjLoadOptions {
+	JIIObjHint hints;
+
+	// for JII_OBJ_WELD_POSITIONS, 0 only merges positions that are exactly the same
+	float weldEpsilon;
+
+	// filled in by the loader
+	u32 weldedPositions;
+	u64 compactedBytes;
+};
+
+JIIDef JIIObjStatus JIIObjLoadData(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadDataW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
 
 JIIDef void JIIObjFreeData(JIIObjModelData* data);
 
-#ifdef __cplusplus
-}
-#endif
+// exact counts and byte sizes of what JIIObjFillData is going to write
+struct JIIObjModelQuery {
+	i32 numberOfPositions;
+	i32 numberOfUVs;
+	i32 numberOfNormals;
+	i32 numberOfVertices;
+	i32 numberOfFaces;
+	JIIObjIndexType indexType;
 
-#ifdef JII_OBJ_IMPLMENTATION
+	u64 positionsSize;
+	u64 uvsSize;
+	u64 normalsSize;
+	u64 verticesSize;
+	// faces or faces16 depending on indexType
+	u64 facesSize;
 
-#ifndef JIIPrivate
-#define JIIPrivate static
-#endif
+	// the mapped file, kept until JIIObjFillData or JIIObjReleaseQuery
+	void* internal;
+};
 
-#ifndef JIIAssert
-#include <assert.h>
-#define JIIAssert(...) assert(__VA_ARGS__)
-#endif
+// JII_OBJ_WELD_POSITIONS and JII_OBJ_COMPACT can't know their counts up front so they are not supported here
+JIIDef JIIObjStatus JIIObjQueryData(const char* path, JIIObjModelQuery* query, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjQueryDataW(const wchar_t* path, JIIObjModelQuery* query, JIIObjLoadOptions* options=NULL);
+// parses straight into the arrays of data, they belong to the caller and must be at least as big as
+// the query says, positions/uvs/normals can be NULL if only the vertices are needed, releases the query
+JIIDef JIIObjStatus JIIObjFillData(JIIObjModelQuery* query, JIIObjModelData* data);
+JIIDef void JIIObjReleaseQuery(JIIObjModelQuery* query);
+
+// keeps the file buffer, the output arrays and the deduplication tables between loads, they only
+// grow when a file needs more, so loading lots of files in a row barely touches the allocator
+struct JIIObjLoader;
+
+JIIDef JIIObjLoader* JIIObjCreateLoader();
+JIIDef void JIIObjDestroyLoader(JIIObjLoader* loader);
+// data points into the loader and stays valid until its next load, don't JIIObjFreeData it
+JIIDef JIIObjStatus JIIObjLoadDataWith(JIIObjLoader* loader, const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadDataWithW(JIIObjLoader* loader, const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+
+// keeps models in sync with the files on disk, a background thread reparses whatever changed
+struct JIIObjReloader;
+
+// options are copied and used for every load
+JIIDef JIIObjReloader* JIIObjCreateReloader(JIIObjLoadOptions* options=NULL);
+JIIDef void JIIObjDestroyReloader(JIIObjReloader* reloader);
+// loads the file right away, watching the same path twice gives back the same asset
+JIIDef JIIObjStatus JIIObjWatchFile(JIIObjReloader* reloader, const char* path, u32* asset);
+// the latest model of the asset, owned by the reloader, if a newer one is ready it gets swapped in
+// and the previous one is freed, so only call it from one thread and drop old pointers afterwards
+JIIDef JIIObjModelData* JIIObjGetReloadedData(JIIObjReloader* reloader, u32 asset, bool* changed=NULL);
+
+// byte ranges of every o/g section of an obj file, so single objects can be parsed on demand
+struct JIIObjIndex;
+
+static const u32 JII_OBJ_NO_OBJECT = 0xffffffff;
+
+// with JII_OBJ_INDEX_SIDECAR the index is read back from <path>.jiidx if that still matches the file,
+// otherwise the file is scanned and the sidecar gets (re)written next to it
+JIIDef JIIObjStatus JIIObjOpenIndex(const char* path, JIIObjIndex** index, JIIObjHint hints=JII_OBJ_NO_HINT);
+JIIDef void JIIObjCloseIndex(JIIObjIndex* index);
+JIIDef u32 JIIObjGetObjectCount(JIIObjIndex* index);
+// whatever comes before the first o/g is an object named ""
+JIIDef const char* JIIObjGetObjectName(JIIObjIndex* index, u32 object);
+// the first object with that name or JII_OBJ_NO_OBJECT
+JIIDef u32 JIIObjFindObject(JIIObjIndex* index, const char* name);
+// face indices resolve against the whole file, if they point into earlier objects every attribute up to
+// this object ends up in the arrays (JII_OBJ_COMPACT trims them), vertices are correct either way
+JIIDef JIIObjStatus JIIObjLoadObject(JIIObjIndex* index, u32 object, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+
+// binary little/big endian and ascii ply, binary stl, freed with JIIObjFreeData as well
+JIIDef JIIObjStatus JIIObjLoadSTL(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadSTLW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadPLY(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadPLYW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+
+// .obj.gz, the file is inflated on another thread and parsed as it comes out, nothing is written to disk
+JIIDef JIIObjStatus JIIObjLoadGzip(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadGzipW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+
+// same result as JIIObjLoadData, but a reader thread pulls the file in big chunks while the parser works
+// through the ones that already arrived, so for files that aren't cached disk and cpu overlap
+JIIDef JIIObjStatus JIIObjLoadDataPipelined(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+JIIDef JIIObjStatus JIIObjLoadDataPipelinedW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options=NULL);
+
+// loads count files at once, on linux the reads go through io_uring and files get parsed as soon as
+// they are in memory, elsewhere (or without io_uring) a pool of threads reads and parses them.
+// Every file gets its own status and a copy of the options, Error comes back if any of them failed
+JIIDef JIIObjStatus JIIObjLoadDataBatch(const char* const* paths, u32 count, JIIObjModelData* models, JIIObjStatus* statuses, JIIObjLoadOptions* options=NULL);
+
+// scans that are only v lines, every array holds numberOfPoints floats and they all share one allocation
+struct JIIObjPointCloud {
+	u32 numberOfPoints;
+
+	float* x;
+	float* y;
+	float* z;
+
+	// NULL unless the first point is written as v x y z r g b
+	float* r;
+	float* g;
+	float* b;
+};
 
-#ifndef JIIMalloc
-#include <stdlib.h>
-#define JIIMalloc(...) malloc(__VA_ARGS__)
-#endif
+// only v lines are looked at, faces and everything else are skipped without being parsed
+JIIDef JIIObjStatus JIIObjLoadPointCloud(const char* path, JIIObjPointCloud* cloud);
+JIIDef JIIObjStatus JIIObjLoadPointCloudW(const wchar_t* path, JIIObjPointCloud* cloud);
+JIIDef void JIIObjFreePointCloud(JIIObjPointCloud* cloud);
 
-#ifndef JIIFree
-#include <stdlib.h>
-#define JIIFree(...) free(__VA_ARGS__)
-#endif
+// every undirected edge once, vertex0 < vertex1
+struct JIIObjEdge {
+	u32 vertex0;
+	u32 vertex1;
+};
 
-struct JIIObjContext {
-	// for parsing
-	u8* fileBuffer;
-	u32 fileSize;
-	u32 fileCursor;
+static const u32 JII_OBJ_NO_EDGE = 0xffffffff;
 
-	// for indices
-	u32 usedPositions;
-	u32 usedNormals;
-	u32 usedUVs;
-	u32 usedVertices;
-	u32 usedFaces;
+// compressed rows, row r of a table goes from items[offsets[r]] up to items[offsets[r + 1]], all rows are sorted
+struct JIIObjAdjacency {
+	u32 numberOfVertices;
+	u32 numberOfFaces;
+	u32 numberOfEdges;
 
-	// for multiple objects
-	u32 positionsOffset;
-	u32 uvsOffset;
-	u32 normalsOffset;
+	// faces around every vertex
+	u32* vertexFaceOffsets;
+	u32* vertexFaces;
 
-	// the output
-	JIIObjModelData modelData;
-};
+	// vertices sharing a face with every vertex, not counting itself
+	u32* vertexVertexOffsets;
+	u32* vertexVertices;
 
-JIIPrivate JIIObjStatus JIIObjCopyFileContentsToMemory(FILE* file, u8** buffer, u32* size) {
-	JIIAssert(file && size && buffer);
+	JIIObjEdge* edges;
+	// the half edge going from corner c to the next corner of face f is edge faceEdges[f * 3 + c],
+	// JII_OBJ_NO_EDGE when both corners are the same vertex
+	u32* faceEdges;
 
-	fseek(file, 0, SEEK_END);
-	*size = ftell(file);
-	fseek(file, 0, SEEK_SET);
+	// faces around every edge, 2 everywhere on a closed manifold mesh
+	u32* edgeFaceOffsets;
+	u32* edgeFaces;
+};
 
-	*buffer = (u8*)JIIMalloc(*size);
+// built from the faces with parallel counting and prefix sums, freed with JIIObjFreeAdjacency
+JIIDef JIIObjStatus JIIObjBuildAdjacency(JIIObjModelData* data, JIIObjAdjacency* adjacency);
+JIIDef void JIIObjFreeAdjacency(JIIObjAdjacency* adjacency);
 
-	i32 bytesRead = fread(*buffer, 1, *size, file);
-	while (bytesRead != *size) {
-		bytesRead += fread(*buffer + bytesRead, 1, *size - bytesRead, file);
-	}
+JIIDef JIIObjStatus JIIObjWriteData(const char* path, JIIObjModelData* data, JIIObjHint hints=JII_OBJ_NO_HINT);
+JIIDef JIIObjStatus JIIObjWriteDataW(const wchar_t* path, JIIObjModelData* data, JIIObjHint hints=JII_OBJ_NO_HINT);
 
-	return JIIObjStatus::Ok;
-}
+// a cell of the grid JIIObjTileFile splits a mesh into, min/max cover the triangles that ended up in it
+struct JIIObjTile {
+	u32 x;
+	u32 y;
+	u32 z;
+	u32 numberOfTriangles;
 
-JIIPrivate JIIObjStatus JIIObjReadFile(const char* path, u8** buffer, u32* size) {
-	JIIAssert(path && size && buffer);
-	
-	FILE* file;
+	JIIObjPosition min;
+	JIIObjPosition max;
+};
 
-	if (fopen_s(&file, path, "rb") != 0) {
-		*buffer = NULL;
-		*size = 0;
-		return JIIObjStatus::Error;
-	}
+// what JIIObjTileFile writes next to the tiles, only tiles that got triangles are listed
+struct JIIObjTileIndex {
+	u32 tilesX;
+	u32 tilesY;
+	u32 tilesZ;
 
-	JIIObjStatus result = JIIObjCopyFileContentsToMemory(file, buffer, size);
+	// bounds of every position in the source file, the grid splits this box evenly
+	JIIObjPosition min;
+	JIIObjPosition max;
 
-	fclose(file);
+	JIIObjTile* tiles;
+	u32 numberOfTiles;
+};
 
-	return result;
-}
+struct JIIObjTileOptions {
+	// 0 means JII_OBJ_DEFAULT_TILES
+	u32 tilesX;
+	u32 tilesY;
+	u32 tilesZ;
 
-JIIPrivate JIIObjStatus JIIObjReadFileW(const wchar_t* path, u8** buffer, u32* size) {
-	JIIAssert(path && size && buffer);
-	
-	FILE* file;
+	// handed to JIIObjWriteData for every tile
+	JIIObjHint hints;
+};
 
-	if (_wfopen_s(&file, path, L"rb") != 0) {
-		*buffer = NULL;
-		*size = 0;
-		return JIIObjStatus::Error;
-	}
+// splits a mesh too big for memory into a grid of tiles, every triangle goes to the tile its center is in.
+// Tiles are written as <outputPath>_x_y_z.obj and the index as <outputPath>.jiitiles, the source is streamed
+// and everything in between goes through temporary files next to the output
+JIIDef JIIObjStatus JIIObjTileFile(const char* path, const char* outputPath, JIIObjTileOptions* options=NULL);
 
-	JIIObjStatus result = JIIObjCopyFileContentsToMemory(file, buffer, size);
+JIIDef JIIObjStatus JIIObjLoadTileIndex(const char* path, JIIObjTileIndex* index);
+JIIDef void JIIObjFreeTileIndex(JIIObjTileIndex* index);
 
-	fclose(file);
+// false if the path doesn't fit in maxSize
+JIIDef bool JIIObjGetTilePath(const char* outputPath, const JIIObjTile* tile, char* path, u32 maxSize);
 
-	return result;
+#ifdef __cplusplus
 }
+#endif
 
-JIIPrivate bool JIIObjIsDigit(char c) {
-	return c >= '0' && c <= '9';
-}
+#ifdef __cplusplus
 
-JIIPrivate bool JIIObjIsWhitespace(char c) {
-	return (c == ' ' || c == '\t');
-}
+#include <string.h>
 
-JIIPrivate bool JIIObjIsLineEnd(char c) {
-	return (c == '\n' || c == '\r');
-}
+// a view over one of the arrays of a model, works with range for
+template<typename T>
+struct JIIObjSpan {
+	T* data;
+	u64 size;
 
-JIIPrivate JIIObjStatus JIIObjEatLineEnd(JIIObjContext* context) {
-	JIIAssert(context);
+	T* begin() const { return data; }
+	T* end() const { return data + size; }
+	T& operator[](u64 index) const { return data[index]; }
+	bool empty() const { return size == 0; }
+};
 
-	while (context->fileBuffer[context->fileCursor] == '\n' ||
-		context->fileBuffer[context->fileCursor] == '\r') {
-		++context->fileCursor;
-		if (context->fileCursor >= context->fileSize) {
-			return JIIObjStatus::Eof;
-		}
-	}
+// where a JIIObjModel gets its arrays from, free gets the same size allocate was asked for
+struct JIIObjAllocator {
+	void* (*allocate)(u64 size, void* user);
+	void (*free)(void* memory, u64 size, void* user);
+	void* user;
+};
 
-	return JIIObjStatus::Ok;
-}
+// owns the model data, it can only be moved so it goes through containers and task queues without
+// copies and can't be freed twice, with an allocator the arrays are filled straight into its memory
+class JIIObjModel {
+public:
+	JIIObjModel() noexcept : data(), allocator() {}
+	explicit JIIObjModel(const JIIObjAllocator& allocator) noexcept : data(), allocator(allocator) {}
 
-JIIPrivate JIIObjStatus JIIObjSkipToNextLine(JIIObjContext* context) {
-	JIIAssert(context);
+	JIIObjModel(const JIIObjModel&) = delete;
+	JIIObjModel& operator=(const JIIObjModel&) = delete;
 
-	while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
-		++context->fileCursor;
-		if (context->fileCursor >= context->fileSize) {
-			return JIIObjStatus::Eof;
-		}
+	JIIObjModel(JIIObjModel&& other) noexcept : data(other.data), allocator(other.allocator) {
+		other.data = {};
 	}
-	
-	return JIIObjEatLineEnd(context);
-}
 
-JIIPrivate JIIObjStatus JIIObjReadLine(JIIObjContext* context, u8* lineBuffer, u32* size, u32 maxSize) {
-	JIIAssert(context);
+	JIIObjModel& operator=(JIIObjModel&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			data = other.data;
+			allocator = other.allocator;
+			other.data = {};
+		}
+		return *this;
+	}
 
-	// # is a comment, just skip the line
-	if (context->fileBuffer[context->fileCursor] == '#') {
-		return JIIObjSkipToNextLine(context);
+	~JIIObjModel() {
+		Reset();
 	}
 
-	u32 offset = 0;
-	while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
-		if (offset >= maxSize) {
-			return JIIObjStatus::OutOfSpace;
-		}
+	// whatever was loaded before gets freed first
+	JIIObjStatus Load(const char* path, JIIObjLoadOptions* options=NULL) { return LoadPath(path, options); }
+	JIIObjStatus Load(const wchar_t* path, JIIObjLoadOptions* options=NULL) { return LoadPath(path, options); }
 
-		lineBuffer[offset++] = context->fileBuffer[context->fileCursor];
-		++context->fileCursor;
-		if (context->fileCursor >= context->fileSize) {
-			return JIIObjStatus::Eof;
+	void Reset() noexcept {
+		if (!allocator.allocate) {
+			JIIObjFreeData(&data);
 		}
+		else {
+			Free(data.positions, sizeof(JIIObjPosition) * (u64)data.numberOfPositions);
+			Free(data.uvs, sizeof(JIIObjUV) * (u64)data.numberOfUVs);
+			Free(data.normals, sizeof(JIIObjNormal) * (u64)data.numberOfNormals);
+			Free(data.vertices, sizeof(JIIObjVertex) * (u64)data.numberOfVertices);
+			Free(data.faces, FacesSize(data.indexType, data.numberOfFaces));
+		}
+		data = {};
 	}
 
-	*size = offset;
+	// hands the arrays over to the caller, they go back through JIIObjFreeData or the allocator
+	JIIObjModelData Release() noexcept {
+		JIIObjModelData result = data;
+		data = {};
+		return result;
+	}
 
-	return JIIObjEatLineEnd(context);
-}
+	const JIIObjModelData& Data() const { return data; }
+	JIIObjIndexType IndexType() const { return data.indexType; }
+
+	JIIObjSpan<JIIObjPosition> Positions() { return {data.positions, (u64)data.numberOfPositions}; }
+	JIIObjSpan<const JIIObjPosition> Positions() const { return {data.positions, (u64)data.numberOfPositions}; }
+	JIIObjSpan<JIIObjUV> UVs() { return {data.uvs, (u64)data.numberOfUVs}; }
+	JIIObjSpan<const JIIObjUV> UVs() const { return {data.uvs, (u64)data.numberOfUVs}; }
+	JIIObjSpan<JIIObjNormal> Normals() { return {data.normals, (u64)data.numberOfNormals}; }
+	JIIObjSpan<const JIIObjNormal> Normals() const { return {data.normals, (u64)data.numberOfNormals}; }
+	JIIObjSpan<JIIObjVertex> Vertices() { return {data.vertices, (u64)data.numberOfVertices}; }
+	JIIObjSpan<const JIIObjVertex> Vertices() const { return {data.vertices, (u64)data.numberOfVertices}; }
+
+	// only one of these is not empty, depending on IndexType
+	JIIObjSpan<JIIObjFace> Faces() { return {data.faces, data.indexType == JIIObjIndexType::Index32 ? (u64)data.numberOfFaces : 0}; }
+	JIIObjSpan<const JIIObjFace> Faces() const { return {data.faces, data.indexType == JIIObjIndexType::Index32 ? (u64)data.numberOfFaces : 0}; }
+	JIIObjSpan<JIIObjFace16> Faces16() { return {data.faces16, data.indexType == JIIObjIndexType::Index16 ? (u64)data.numberOfFaces : 0}; }
+	JIIObjSpan<const JIIObjFace16> Faces16() const { return {data.faces16, data.indexType == JIIObjIndexType::Index16 ? (u64)data.numberOfFaces : 0}; }
+
+private:
+	JIIObjModelData data;
+	JIIObjAllocator allocator;
+
+	static u64 FacesSize(JIIObjIndexType indexType, i32 numberOfFaces) {
+		return (indexType == JIIObjIndexType::Index16 ? sizeof(JIIObjFace16) : sizeof(JIIObjFace)) * (u64)numberOfFaces;
+	}
 
-JIIPrivate void JIIObjEatWhitespaces(u8* lineBuffer, u32 lineSize, u32* offset) {
-	JIIAssert(lineBuffer);
+	static JIIObjStatus LoadFile(const char* path, JIIObjModelData* model, JIIObjLoadOptions* options) { return JIIObjLoadData(path, model, options); }
+	static JIIObjStatus LoadFile(const wchar_t* path, JIIObjModelData* model, JIIObjLoadOptions* options) { return JIIObjLoadDataW(path, model, options); }
+	static JIIObjStatus QueryFile(const char* path, JIIObjModelQuery* query, JIIObjLoadOptions* options) { return JIIObjQueryData(path, query, options); }
+	static JIIObjStatus QueryFile(const wchar_t* path, JIIObjModelQuery* query, JIIObjLoadOptions* options) { return JIIObjQueryDataW(path, query, options); }
 
-	while (JIIObjIsWhitespace(lineBuffer[*offset])) {
-		++(*offset);
-		if (*offset >= lineSize) {
-			return;
-		}
+	void* Allocate(u64 size) {
+		return size ? allocator.allocate(size, allocator.user) : NULL;
 	}
-}
 
-#define JII_ADVANCE_CHECK_RETURN(offset, size, returnValue) {\
-	++(offset);\
-	if ((offset) >= (size)) {\
-		return (returnValue);\
-	}\
-}
-#define JII_ADVANCE_CHECK_RETURN_NOVALUE(offset, size) {\
-	++(offset);\
-	if ((offset) >= (size)) {\
-		return;\
-	}\
-}
-#define JII_ADVANCE_CHECK_BREAK(offset, size) {\
-	++(offset);\
-	if ((offset) >= (size)) {\
-		break;\
-	}\
-}
+	void Free(void* memory, u64 size) {
+		if (memory) {
+			allocator.free(memory, size, allocator.user);
+		}
+	}
 
-JIIPrivate u32 JIIObjEatU32(u8* lineBuffer, u32 lineSize, u32* offset) {
-	u32 result = 0;
+	void* AllocateCopy(const void* source, u64 size) {
+		void* result = Allocate(size);
+		if (result) {
+			memcpy(result, source, (size_t)size);
+		}
+		return result;
+	}
 
-	JIIObjEatWhitespaces(lineBuffer, lineSize, offset);
+	template<typename Char>
+	JIIObjStatus LoadPath(const Char* path, JIIObjLoadOptions* options) {
+		Reset();
 
-	while (JIIObjIsDigit(lineBuffer[*offset])) {
-		result = result * 10 + (lineBuffer[*offset] - '0');
-		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, result);
-	}
+		if (!allocator.allocate) {
+			return LoadFile(path, &data, options);
+		}
 
-	return result;
-}
+		// the query can't know the counts of a welded or compacted model up front, those get loaded
+		// the usual way and copied over once
+		if (options && (options->hints & (JII_OBJ_WELD_POSITIONS | JII_OBJ_COMPACT))) {
+			JIIObjModelData loaded;
+			JIIObjStatus status = LoadFile(path, &loaded, options);
+			if (status != JIIObjStatus::Ok) {
+				return status;
+			}
 
-JIIPrivate float JIIObjEatFloat(u8* lineBuffer, u32 lineSize, u32* offset) {
-	JIIAssert(lineBuffer);
+			data = loaded;
+			data.positions = (JIIObjPosition*)AllocateCopy(loaded.positions, sizeof(JIIObjPosition) * (u64)loaded.numberOfPositions);
+			data.uvs = (JIIObjUV*)AllocateCopy(loaded.uvs, sizeof(JIIObjUV) * (u64)loaded.numberOfUVs);
+			data.normals = (JIIObjNormal*)AllocateCopy(loaded.normals, sizeof(JIIObjNormal) * (u64)loaded.numberOfNormals);
+			data.vertices = (JIIObjVertex*)AllocateCopy(loaded.vertices, sizeof(JIIObjVertex) * (u64)loaded.numberOfVertices);
+			data.faces = (JIIObjFace*)AllocateCopy(loaded.faces, FacesSize(loaded.indexType, loaded.numberOfFaces));
 
-	JIIObjEatWhitespaces(lineBuffer, lineSize, offset);
+			// empty arrays are NULL either way, anything else being NULL means the allocator ran out
+			bool copied = (data.positions || !loaded.numberOfPositions) && (data.uvs || !loaded.numberOfUVs) &&
+				(data.normals || !loaded.numberOfNormals) && (data.vertices || !loaded.numberOfVertices) &&
+				(data.faces || !loaded.numberOfFaces);
 
-	float result = 0;
-	float power = 1.0;
+			JIIObjFreeData(&loaded);
 
-	bool isFractionalPart = false;
+			if (!copied) {
+				// Free skips the arrays that never got allocated
+				Reset();
+				return JIIObjStatus::OutOfSpace;
+			}
 
-	i8 sign = 1;
+			return JIIObjStatus::Ok;
+		}
 
-	switch(lineBuffer[*offset]) {
-		case '-': {
-			sign = -1;
-			++(*offset);
-			break;
+		JIIObjModelQuery query;
+		JIIObjStatus status = QueryFile(path, &query, options);
+		if (status != JIIObjStatus::Ok) {
+			return status;
 		}
-		case '+': {
-			++(*offset);
-			break;
+
+		JIIObjModelData filled = {};
+		filled.positions = (JIIObjPosition*)Allocate(query.positionsSize);
+		filled.uvs = (JIIObjUV*)Allocate(query.uvsSize);
+		filled.normals = (JIIObjNormal*)Allocate(query.normalsSize);
+		filled.vertices = (JIIObjVertex*)Allocate(query.verticesSize);
+		filled.faces = (JIIObjFace*)Allocate(query.facesSize);
+
+		// fill only writes the counts on success, the arrays are freed by the sizes of the query
+		data = filled;
+		data.numberOfPositions = query.numberOfPositions;
+		data.numberOfUVs = query.numberOfUVs;
+		data.numberOfNormals = query.numberOfNormals;
+		data.numberOfVertices = query.numberOfVertices;
+		data.numberOfFaces = query.numberOfFaces;
+		data.indexType = query.indexType;
+
+		if ((!filled.positions && query.positionsSize) || (!filled.uvs && query.uvsSize) ||
+			(!filled.normals && query.normalsSize) || (!filled.vertices && query.verticesSize) ||
+			(!filled.faces && query.facesSize)) {
+			JIIObjReleaseQuery(&query);
+			Reset();
+			return JIIObjStatus::OutOfSpace;
 		}
-		default: {
-			break;
+
+		status = JIIObjFillData(&query, &filled);
+		if (status != JIIObjStatus::Ok) {
+			Reset();
+			return status;
 		}
-	}
 
-	if (*offset >= lineSize) {
-		return sign * (result / power);
+		data = filled;
+		return JIIObjStatus::Ok;
 	}
+};
 
-	while (JIIObjIsDigit(lineBuffer[*offset])) {
-		result = result * 10 + (lineBuffer[*offset] - '0');
-		
+#endif // __cplusplus
+
+#ifdef JII_OBJ_IMPLMENTATION
+
+#ifndef JIIPrivate
+#define JIIPrivate static
+#endif
+
+#ifndef JIIAssert
+#include <assert.h>
+#define JIIAssert(...) assert(__VA_ARGS__)
+#endif
+
+#ifndef JIIMalloc
+#include <stdlib.h>
+#define JIIMalloc(...) malloc(__VA_ARGS__)
+#endif
+
+#ifndef JIIFree
+#include <stdlib.h>
+#define JIIFree(...) free(__VA_ARGS__)
+#endif
+
+#ifndef JIITraceScope
+#define JIITraceScope(...)
+#endif
+
+#ifndef JIITraceCounter
+#define JIITraceCounter(...)
+#endif
+
+#ifndef JII_OBJ_MAX_THREADS
+#define JII_OBJ_MAX_THREADS 16
+#endif
+
+#ifndef JII_OBJ_MAX_RELOAD_ASSETS
+#define JII_OBJ_MAX_RELOAD_ASSETS 256
+#endif
+
+#ifndef JII_OBJ_RELOAD_POLL_MS
+// how often modification times are checked when inotify isn't around
+#define JII_OBJ_RELOAD_POLL_MS 250
+#endif
+
+#ifndef JII_OBJ_STREAM_CHUNK_SIZE
+// bytes handed from the producer thread to the parser at a time
+#define JII_OBJ_STREAM_CHUNK_SIZE (1 << 16)
+#endif
+
+#ifndef JII_OBJ_STREAM_QUEUE_SIZE
+// chunks that can be waiting for the parser before the producer blocks
+#define JII_OBJ_STREAM_QUEUE_SIZE 4
+#endif
+
+#ifndef JII_OBJ_PIPELINE_CHUNK_SIZE
+// bytes read from disk at a time by JIIObjLoadDataPipelined
+#define JII_OBJ_PIPELINE_CHUNK_SIZE (1 << 20)
+#endif
+
+#ifndef JII_OBJ_POINT_CLOUD_CHUNK_SIZE
+// bytes of a point cloud parsed by one task
+#define JII_OBJ_POINT_CLOUD_CHUNK_SIZE (1 << 22)
+#endif
+
+#ifndef JII_OBJ_DEFAULT_TILES
+// tiles per axis when JIIObjTileOptions leaves an axis at 0
+#define JII_OBJ_DEFAULT_TILES 4
+#endif
+
+#ifndef JII_OBJ_TILE_READ_SIZE
+// JIIObjTileFile reads the source this many bytes at a time, no line can be longer
+#define JII_OBJ_TILE_READ_SIZE (1 << 22)
+#endif
+
+#ifndef JII_OBJ_TILE_SCATTER_SIZE
+// memory shared by all the tiles for collecting their triangles before they go to disk
+#define JII_OBJ_TILE_SCATTER_SIZE (1 << 26)
+#endif
+
+#ifndef JII_OBJ_WRITE_CHUNK_SIZE
+// elements formatted by one thread before the buffers get flushed
+#define JII_OBJ_WRITE_CHUNK_SIZE (1 << 14)
+#endif
+
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
+#endif
+
+// io_uring goes through raw syscalls, liburing would be one more thing to link
+#if defined(__linux__) && !defined(JII_OBJ_NO_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define JII_OBJ_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define JIIObjAtomicLoad32(pointer) ((u32)_InterlockedOr((volatile long*)(pointer), 0))
+#define JIIObjAtomicStore32(pointer, value) _InterlockedExchange((volatile long*)(pointer), (long)(value))
+#define JIIObjAtomicAdd32(pointer, value) ((u32)_InterlockedExchangeAdd((volatile long*)(pointer), (long)(value)))
+#define JIIObjAtomicExchangePointer(pointer, value) _InterlockedExchangePointer((void* volatile*)(pointer), (value))
+#else
+#define JIIObjAtomicLoad32(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define JIIObjAtomicStore32(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+// returns the value from before, only used for counting so no ordering is needed
+#define JIIObjAtomicAdd32(pointer, value) __atomic_fetch_add((pointer), (value), __ATOMIC_RELAXED)
+#define JIIObjAtomicExchangePointer(pointer, value) __atomic_exchange_n((pointer), (value), __ATOMIC_ACQ_REL)
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define JIIObjPrefetch(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#elif defined(_MSC_VER)
+#define JIIObjPrefetch(address)
+#else
+#define JIIObjPrefetch(address) __builtin_prefetch(address)
+#endif
+
+typedef void(*JIIObjThreadProc)(void* data);
+
+// has to stay at the same address while the thread runs
+struct JIIObjThread {
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+	JIIObjThreadProc proc;
+	void* data;
+};
+
+#if defined(_WIN32) || defined(_WIN64)
+JIIPrivate DWORD WINAPI JIIObjThreadEntry(LPVOID data) {
+	JIIObjThread* thread = (JIIObjThread*)data;
+	thread->proc(thread->data);
+	return 0;
+}
+#else
+JIIPrivate void* JIIObjThreadEntry(void* data) {
+	JIIObjThread* thread = (JIIObjThread*)data;
+	thread->proc(thread->data);
+	return NULL;
+}
+#endif
+
+JIIPrivate bool JIIObjCreateThread(JIIObjThread* thread, JIIObjThreadProc proc, void* data) {
+	JIIAssert(thread && proc);
+
+	thread->proc = proc;
+	thread->data = data;
+
+#if defined(_WIN32) || defined(_WIN64)
+	thread->handle = CreateThread(NULL, 0, JIIObjThreadEntry, thread, 0, NULL);
+	return thread->handle != NULL;
+#else
+	return pthread_create(&thread->handle, NULL, JIIObjThreadEntry, thread) == 0;
+#endif
+}
+
+JIIPrivate void JIIObjJoinThread(JIIObjThread* thread) {
+	JIIAssert(thread);
+
+#if defined(_WIN32) || defined(_WIN64)
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+}
+
+JIIPrivate u32 JIIObjGetThreadCount() {
+#if defined(_WIN32) || defined(_WIN64)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	i64 count = info.dwNumberOfProcessors;
+#else
+	i64 count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	if (count < 1) {
+		count = 1;
+	}
+	if (count > JII_OBJ_MAX_THREADS) {
+		count = JII_OBJ_MAX_THREADS;
+	}
+	return (u32)count;
+}
+
+typedef void(*JIIObjRangeProc)(void* data, u32 begin, u32 end);
+
+struct JIIObjRangeTask {
+	JIIObjRangeProc proc;
+	void* data;
+	u32 begin;
+	u32 end;
+
+	JIIObjThread thread;
+};
+
+JIIPrivate void JIIObjRangeTaskProc(void* data) {
+	JIIObjRangeTask* task = (JIIObjRangeTask*)data;
+	task->proc(task->data, task->begin, task->end);
+}
+
+// splits [0, count) in contiguous ranges of at least grain elements, one per thread
+JIIPrivate void JIIObjParallelFor(u32 count, u32 grain, JIIObjRangeProc proc, void* data) {
+	JIIAssert(proc && grain);
+
+	u32 numberOfTasks = JIIObjGetThreadCount();
+	if (numberOfTasks > count / grain) {
+		numberOfTasks = count / grain;
+	}
+
+	if (numberOfTasks <= 1) {
+		proc(data, 0, count);
+		return;
+	}
+
+	JIIObjRangeTask tasks[JII_OBJ_MAX_THREADS];
+
+	u32 perTask = (count + numberOfTasks - 1) / numberOfTasks;
+	for (u32 i = 0; i < numberOfTasks; ++i) {
+		tasks[i].proc = proc;
+		tasks[i].data = data;
+		tasks[i].begin = i * perTask;
+		tasks[i].end = (i + 1) * perTask < count ? (i + 1) * perTask : count;
+	}
+
+	u32 startedTasks = 1;
+	for (; startedTasks < numberOfTasks; ++startedTasks) {
+		if (!JIIObjCreateThread(&tasks[startedTasks].thread, JIIObjRangeTaskProc, &tasks[startedTasks])) {
+			break;
+		}
+	}
+	for (u32 i = startedTasks; i < numberOfTasks; ++i) {
+		JIIObjRangeTaskProc(&tasks[i]);
+	}
+	JIIObjRangeTaskProc(&tasks[0]);
+	for (u32 i = 1; i < startedTasks; ++i) {
+		JIIObjJoinThread(&tasks[i].thread);
+	}
+}
+
+// a lock and a condition variable that goes with it
+struct JIIObjMonitor {
+#if defined(_WIN32) || defined(_WIN64)
+	SRWLOCK lock;
+	CONDITION_VARIABLE changed;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+#endif
+};
+
+JIIPrivate void JIIObjCreateMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	InitializeSRWLock(&monitor->lock);
+	InitializeConditionVariable(&monitor->changed);
+#else
+	pthread_mutex_init(&monitor->lock, NULL);
+	pthread_cond_init(&monitor->changed, NULL);
+#endif
+}
+
+JIIPrivate void JIIObjDestroyMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	(void)monitor;
+#else
+	pthread_cond_destroy(&monitor->changed);
+	pthread_mutex_destroy(&monitor->lock);
+#endif
+}
+
+JIIPrivate void JIIObjLockMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	AcquireSRWLockExclusive(&monitor->lock);
+#else
+	pthread_mutex_lock(&monitor->lock);
+#endif
+}
+
+JIIPrivate void JIIObjUnlockMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	ReleaseSRWLockExclusive(&monitor->lock);
+#else
+	pthread_mutex_unlock(&monitor->lock);
+#endif
+}
+
+// has to be called with the lock held
+JIIPrivate void JIIObjWaitMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	SleepConditionVariableSRW(&monitor->changed, &monitor->lock, INFINITE, 0);
+#else
+	pthread_cond_wait(&monitor->changed, &monitor->lock);
+#endif
+}
+
+JIIPrivate void JIIObjWakeMonitor(JIIObjMonitor* monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+	WakeAllConditionVariable(&monitor->changed);
+#else
+	pthread_cond_broadcast(&monitor->changed);
+#endif
+}
+
+struct JIIObjVertexKey {
+	u32 position;
+	u32 uv;
+	u32 normal;
+};
+
+// the corner layout of the faces, detected while peeking the file
+enum JIIObjFaceFormat {
+	FaceFormatUnknown,
+	FaceFormatP,	// f p p p
+	FaceFormatPT,	// f p/t p/t p/t
+	FaceFormatPN,	// f p//n p//n p//n
+	FaceFormatPTN,	// f p/t/n p/t/n p/t/n
+	FaceFormatMixed
+};
+
+struct JIIObjContext;
+typedef JIIObjStatus (*JIIObjFaceParser)(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset);
+
+struct JIIObjContext {
+	// for parsing
+	u8* fileBuffer;
+	u32 fileSize;
+	u32 fileCursor;
+
+	// for indices
+	u32 usedPositions;
+	u32 usedNormals;
+	u32 usedUVs;
+	u32 usedVertices;
+	u32 usedFaces;
+
+	// for multiple objects
+	u32 positionsOffset;
+	u32 uvsOffset;
+	u32 normalsOffset;
+
+	// for vertex deduplication, a vertex is the p/t/n triplet of a face corner
+	JIIObjVertexKey* vertexKeys;
+	u32* vertexTable;
+	u32 vertexTableSize;
+
+	// picked after peeking, mixed face formats go through the generic parser
+	JIIObjFaceFormat faceFormat;
+	JIIObjFaceParser faceParser;
+
+	// only counts the vertices and faces, nothing gets written to modelData
+	bool countOnly;
+
+	// face lines before this offset belong to other objects, only their attributes are parsed
+	u32 facesBegin;
+	// set when a face of an indexed object uses attributes declared before the object
+	bool indexBeforeObject;
+
+	// when streaming there is no peek, the arrays grow as the lines come in
+	u32 positionsCapacity;
+	u32 uvsCapacity;
+	u32 normalsCapacity;
+	u32 verticesCapacity;
+	u32 facesCapacity;
+
+	// the output
+	JIIObjModelData modelData;
+};
+
+JIIPrivate JIIObjStatus JIIObjCopyFileContentsToMemory(FILE* file, u8** buffer, u32* size) {
+	JIIAssert(file && size && buffer);
+
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	*buffer = (u8*)JIIMalloc(*size);
+
+	i32 bytesRead = fread(*buffer, 1, *size, file);
+	while (bytesRead != *size) {
+		bytesRead += fread(*buffer + bytesRead, 1, *size - bytesRead, file);
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// fopen_s only exists on windows, NULL when the file can't be opened
+JIIPrivate FILE* JIIObjOpenFile(const char* path, const char* mode) {
+	JIIAssert(path && mode);
+
+#if defined(_WIN32) || defined(_WIN64)
+	FILE* file;
+	if (fopen_s(&file, path, mode) != 0) {
+		return NULL;
+	}
+	return file;
+#else
+	return fopen(path, mode);
+#endif
+}
+
+JIIPrivate FILE* JIIObjOpenFileW(const wchar_t* path, const wchar_t* mode) {
+	JIIAssert(path && mode);
+
+#if defined(_WIN32) || defined(_WIN64)
+	FILE* file;
+	if (_wfopen_s(&file, path, mode) != 0) {
+		return NULL;
+	}
+	return file;
+#else
+	char narrowPath[4096];
+	char narrowMode[8];
+	if (wcstombs(narrowPath, path, sizeof(narrowPath)) >= sizeof(narrowPath) ||
+		wcstombs(narrowMode, mode, sizeof(narrowMode)) >= sizeof(narrowMode)) {
+		return NULL;
+	}
+	return fopen(narrowPath, narrowMode);
+#endif
+}
+
+JIIPrivate JIIObjStatus JIIObjReadFile(const char* path, u8** buffer, u32* size) {
+	JIIAssert(path && size && buffer);
+	
+	FILE* file = JIIObjOpenFile(path, "rb");
+
+	if (!file) {
+		*buffer = NULL;
+		*size = 0;
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjStatus result = JIIObjCopyFileContentsToMemory(file, buffer, size);
+
+	fclose(file);
+
+	return result;
+}
+
+JIIPrivate JIIObjStatus JIIObjReadFileW(const wchar_t* path, u8** buffer, u32* size) {
+	JIIAssert(path && size && buffer);
+	
+	FILE* file = JIIObjOpenFileW(path, L"rb");
+
+	if (!file) {
+		*buffer = NULL;
+		*size = 0;
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjStatus result = JIIObjCopyFileContentsToMemory(file, buffer, size);
+
+	fclose(file);
+
+	return result;
+}
+
+struct JIIObjFileMapping {
+	u8* data;
+	u64 size;
+
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int file;
+#endif
+};
+
+#if defined(_WIN32) || defined(_WIN64)
+JIIPrivate JIIObjStatus JIIObjMapFileHandle(HANDLE file, JIIObjFileMapping* mapping) {
+	*mapping = {};
+	mapping->file = file;
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return JIIObjStatus::Error;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return JIIObjStatus::Error;
+	}
+
+	mapping->size = (u64)size.QuadPart;
+	if (mapping->size == 0) {
+		// empty files can't be mapped, there is nothing to read anyway
+		return JIIObjStatus::Ok;
+	}
+
+	mapping->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping->mapping) {
+		CloseHandle(file);
+		return JIIObjStatus::Error;
+	}
+
+	mapping->data = (u8*)MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!mapping->data) {
+		CloseHandle(mapping->mapping);
+		CloseHandle(file);
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjMapFile(const char* path, JIIObjFileMapping* mapping) {
+	JIIAssert(path && mapping);
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	return JIIObjMapFileHandle(file, mapping);
+}
+
+JIIPrivate JIIObjStatus JIIObjMapFileW(const wchar_t* path, JIIObjFileMapping* mapping) {
+	JIIAssert(path && mapping);
+	HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	return JIIObjMapFileHandle(file, mapping);
+}
+
+JIIPrivate void JIIObjUnmapFile(JIIObjFileMapping* mapping) {
+	JIIAssert(mapping);
+
+	if (mapping->data) {
+		UnmapViewOfFile(mapping->data);
+		CloseHandle(mapping->mapping);
+	}
+	CloseHandle(mapping->file);
+	*mapping = {};
+}
+#else
+JIIPrivate JIIObjStatus JIIObjMapFile(const char* path, JIIObjFileMapping* mapping) {
+	JIIAssert(path && mapping);
+
+	*mapping = {};
+	mapping->file = open(path, O_RDONLY);
+	if (mapping->file < 0) {
+		return JIIObjStatus::Error;
+	}
+
+	struct stat info;
+	if (fstat(mapping->file, &info) != 0) {
+		close(mapping->file);
+		return JIIObjStatus::Error;
+	}
+
+	mapping->size = (u64)info.st_size;
+	if (mapping->size == 0) {
+		// empty files can't be mapped, there is nothing to read anyway
+		return JIIObjStatus::Ok;
+	}
+
+	void* data = mmap(NULL, mapping->size, PROT_READ, MAP_PRIVATE, mapping->file, 0);
+	if (data == MAP_FAILED) {
+		close(mapping->file);
+		return JIIObjStatus::Error;
+	}
+
+	// everything gets read front to back exactly once, the advice values are not flags so one call each
+	madvise(data, mapping->size, MADV_SEQUENTIAL);
+	madvise(data, mapping->size, MADV_WILLNEED);
+
+	mapping->data = (u8*)data;
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjMapFileW(const wchar_t* path, JIIObjFileMapping* mapping) {
+	JIIAssert(path && mapping);
+
+	char narrowPath[4096];
+	if (wcstombs(narrowPath, path, sizeof(narrowPath)) >= sizeof(narrowPath)) {
+		*mapping = {};
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjMapFile(narrowPath, mapping);
+}
+
+JIIPrivate void JIIObjUnmapFile(JIIObjFileMapping* mapping) {
+	JIIAssert(mapping);
+
+	if (mapping->data) {
+		munmap(mapping->data, mapping->size);
+	}
+	close(mapping->file);
+	*mapping = {};
+}
+#endif
+
+JIIPrivate bool JIIObjIsDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+JIIPrivate bool JIIObjIsWhitespace(char c) {
+	return (c == ' ' || c == '\t');
+}
+
+JIIPrivate bool JIIObjIsLineEnd(char c) {
+	return (c == '\n' || c == '\r');
+}
+
+JIIPrivate JIIObjStatus JIIObjEatLineEnd(JIIObjContext* context) {
+	JIIAssert(context);
+
+	while (context->fileBuffer[context->fileCursor] == '\n' ||
+		context->fileBuffer[context->fileCursor] == '\r') {
+		++context->fileCursor;
+		if (context->fileCursor >= context->fileSize) {
+			return JIIObjStatus::Eof;
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjSkipToNextLine(JIIObjContext* context) {
+	JIIAssert(context);
+
+	if (context->fileCursor >= context->fileSize) {
+		return JIIObjStatus::Eof;
+	}
+
+	while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
+		++context->fileCursor;
+		if (context->fileCursor >= context->fileSize) {
+			return JIIObjStatus::Eof;
+		}
+	}
+	
+	return JIIObjEatLineEnd(context);
+}
+
+JIIPrivate JIIObjStatus JIIObjReadLine(JIIObjContext* context, u8* lineBuffer, u32* size, u32 maxSize) {
+	JIIAssert(context);
+
+	*size = 0;
+
+	// # is a comment, just skip the line
+	if (context->fileBuffer[context->fileCursor] == '#') {
+		return JIIObjSkipToNextLine(context);
+	}
+
+	u32 offset = 0;
+	while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
+		if (offset >= maxSize) {
+			return JIIObjStatus::OutOfSpace;
+		}
+
+		lineBuffer[offset++] = context->fileBuffer[context->fileCursor];
+		++context->fileCursor;
+		if (context->fileCursor >= context->fileSize) {
+			// the last line doesn't need a line end
+			*size = offset;
+			return JIIObjStatus::Eof;
+		}
+	}
+
+	*size = offset;
+
+	return JIIObjEatLineEnd(context);
+}
+
+JIIPrivate void JIIObjEatWhitespaces(u8* lineBuffer, u32 lineSize, u32* offset) {
+	JIIAssert(lineBuffer);
+
+	while (JIIObjIsWhitespace(lineBuffer[*offset])) {
+		++(*offset);
+		if (*offset >= lineSize) {
+			return;
+		}
+	}
+}
+
+#define JII_ADVANCE_CHECK_RETURN(offset, size, returnValue) {\
+	++(offset);\
+	if ((offset) >= (size)) {\
+		return (returnValue);\
+	}\
+}
+#define JII_ADVANCE_CHECK_RETURN_NOVALUE(offset, size) {\
+	++(offset);\
+	if ((offset) >= (size)) {\
+		return;\
+	}\
+}
+#define JII_ADVANCE_CHECK_BREAK(offset, size) {\
+	++(offset);\
+	if ((offset) >= (size)) {\
+		break;\
+	}\
+}
+
+JIIPrivate u32 JIIObjEatU32(u8* lineBuffer, u32 lineSize, u32* offset) {
+	u32 result = 0;
+
+	if (*offset >= lineSize) {
+		return result;
+	}
+
+	JIIObjEatWhitespaces(lineBuffer, lineSize, offset);
+	if (*offset >= lineSize) {
+		return result;
+	}
+
+	while (JIIObjIsDigit(lineBuffer[*offset])) {
+		result = result * 10 + (lineBuffer[*offset] - '0');
+		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, result);
+	}
+
+	return result;
+}
+
+JIIPrivate float JIIObjEatFloat(u8* lineBuffer, u32 lineSize, u32* offset) {
+	JIIAssert(lineBuffer);
+
+	// missing components (like the w of a uv) are 0
+	if (*offset >= lineSize) {
+		return 0;
+	}
+
+	JIIObjEatWhitespaces(lineBuffer, lineSize, offset);
+	if (*offset >= lineSize) {
+		return 0;
+	}
+
+	float result = 0;
+	float power = 1.0;
+
+	bool isFractionalPart = false;
+
+	i8 sign = 1;
+
+	switch(lineBuffer[*offset]) {
+		case '-': {
+			sign = -1;
+			++(*offset);
+			break;
+		}
+		case '+': {
+			++(*offset);
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+
+	if (*offset >= lineSize) {
+		return sign * (result / power);
+	}
+
+	while (JIIObjIsDigit(lineBuffer[*offset])) {
+		result = result * 10 + (lineBuffer[*offset] - '0');
+		
+		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+	}
+
+	if (lineBuffer[*offset] == '.') {
+		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+	}
+
+	while (JIIObjIsDigit(lineBuffer[*offset])) {
+		result = result * 10 + (lineBuffer[*offset] - '0');
+		power *= 10;
+
+		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+	}
+
+	if (lineBuffer[*offset] == 'e' || lineBuffer[*offset] == 'E') {
 		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
 	}
+	else {
+		return sign * (result / power);
+	}
+
+	i8 eSign = 1;
+	switch (lineBuffer[*offset]) {
+		case '-': {
+			eSign = -1;
+			++(*offset);
+			break;
+		}
+		case '+': {
+			++(*offset);
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+
+	if (*offset >= lineSize) {
+		return sign * (result / power);
+	}
+
+	i32 power2 = 0;
+	while (JIIObjIsDigit(lineBuffer[*offset])) {
+		power2 = power2 * 10 + (lineBuffer[*offset] - '0');
+
+		// the exponent can be the last thing on the line, it still has to be applied
+		JII_ADVANCE_CHECK_BREAK(*offset, lineSize);
+	}
+
+	while (power2 != 0) {
+		power *= (eSign == 1) ? 0.1 : 10;
+		--power2;
+	}
+
+	return sign * (result / power);
+}
+
+// this function is the definition of spray and pray
+JIIPrivate JIIObjStatus JIIObjParseVertexAttribute(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset) {
+	JIIAssert(context && lineBuffer && lineSize);
+
+	if (offset + 1 >= lineSize) {
+		return JIIObjStatus::Eof;
+	}
+
+	// function is always called after 'v' was already detected
+	++offset;
+
+	if (context->countOnly) {
+		// faces check their indices against these, the floats themselves don't matter
+		switch (lineBuffer[offset]) {
+			case ' ': {
+				++context->usedPositions;
+				break;
+			}
+			case 't': {
+				++context->usedUVs;
+				break;
+			}
+			case 'n': {
+				++context->usedNormals;
+				break;
+			}
+		}
+		return JIIObjStatus::Ok;
+	}
+
+	switch (lineBuffer[offset]) {
+		case ' ': {
+			// going to be position
+			++offset;
+			float x = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float y = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float z = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			context->modelData.positions[context->usedPositions++] = {x, y, z};
+			break;
+		}
+
+		case 't': {
+			// going to be uv
+			++offset;
+			float u = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float v = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float w = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			context->modelData.uvs[context->usedUVs++] = { u, v, w };
+			break;
+		}
+
+		case 'n': {
+			// going to be normal
+			++offset;
+			float x = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float y = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			float z = JIIObjEatFloat(lineBuffer, lineSize, &offset);
+			context->modelData.normals[context->usedNormals++] = { x, y, z };
+			break;
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate u32 JIIObjHashVertexKey(const JIIObjVertexKey* key) {
+	u32 hash = key->position * 0x9e3779b1u;
+	hash ^= key->uv * 0x85ebca77u;
+	hash ^= key->normal * 0xc2b2ae3du;
+	hash ^= hash >> 16;
+	hash *= 0x7feb352du;
+	hash ^= hash >> 15;
+	return hash;
+}
+
+// returns the index of the vertex with this exact p/t/n, adding it if it's the first time we see it
+JIIPrivate u32 JIIObjFindOrAddVertex(JIIObjContext* context, const JIIObjVertexKey* key) {
+	u32 mask = context->vertexTableSize - 1;
+	u32 slot = JIIObjHashVertexKey(key) & mask;
+
+	while (context->vertexTable[slot] != UINT32_MAX) {
+		JIIObjVertexKey* existing = &context->vertexKeys[context->vertexTable[slot]];
+		if (existing->position == key->position && existing->uv == key->uv && existing->normal == key->normal) {
+			return context->vertexTable[slot];
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	// only the key is kept, JIIObjAssembleVertices gathers the attributes once the whole file is parsed
+	u32 index = context->usedVertices++;
+	context->vertexKeys[index] = *key;
+	context->vertexTable[slot] = index;
+
+	return index;
+}
+
+// resolves a corner of a face and emits a triangle once there are at least 3 corners
+JIIPrivate JIIObjStatus JIIObjAddFaceCorner(JIIObjContext* context, u32 position, u32 uv, u32 normal,
+	u32* verticesInFace, u32* cachedIndex0, u32* cachedIndex1) {
+	// obj indices start at 1
+	JIIObjVertexKey key;
+	key.position = position - 1 + context->positionsOffset;
+	key.uv = uv != UINT_MAX ? uv - 1 + context->uvsOffset : UINT_MAX;
+	key.normal = normal != UINT_MAX ? normal - 1 + context->normalsOffset : UINT_MAX;
+
+	// out of range indices are caught when assembling, faces may point at attributes declared after them
+	u32 vertexIndex = JIIObjFindOrAddVertex(context, &key);
+
+	++(*verticesInFace);
+	if (*verticesInFace == 1) {
+		*cachedIndex0 = vertexIndex;
+	}
+	else if (*verticesInFace == 2) {
+		*cachedIndex1 = vertexIndex;
+	}
+	else {
+		// triangulate face
+		u32 faceIndex = context->usedFaces++;
+		if (context->countOnly) {
+			// nothing to write
+		}
+		else if (context->modelData.indexType == JIIObjIndexType::Index16) {
+			// only when filling caller memory, the width was picked by the query
+			JIIObjFace16* face = &context->modelData.faces16[faceIndex];
+			face->index0 = (u16)*cachedIndex0;
+			face->index1 = (u16)*cachedIndex1;
+			face->index2 = (u16)vertexIndex;
+		}
+		else {
+			JIIObjFace* face = &context->modelData.faces[faceIndex];
+			face->index0 = *cachedIndex0;
+			face->index1 = *cachedIndex1;
+			face->index2 = vertexIndex;
+		}
+
+		*cachedIndex1 = vertexIndex;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// generic parser, figures out the layout of every corner by itself
+JIIPrivate JIIObjStatus JIIObjParseFace(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset) {
+	JIIAssert(context && lineBuffer && lineSize);
+	JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+
+	u32 verticesInFace = 0;
+
+	u32 cachedIndex0 = 0;
+	u32 cachedIndex1 = 0;
+
+	while (offset < lineSize && JIIObjIsWhitespace(lineBuffer[offset])) {
+		JIIObjEatWhitespaces(lineBuffer, lineSize, &offset);
+		// trailing whitespace
+		if (offset >= lineSize || !JIIObjIsDigit(lineBuffer[offset])) {
+			break;
+		}
+
+		u32 position = UINT_MAX;
+		u32 uv = UINT_MAX;
+		u32 normal = UINT_MAX;
+
+		position = JIIObjEatU32(lineBuffer, lineSize, &offset);
+		if (offset < lineSize && lineBuffer[offset] == '/') {
+			JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+			// f p//n p//n p//n is accepted input
+			if (lineBuffer[offset] != '/') {
+				uv = JIIObjEatU32(lineBuffer, lineSize, &offset);
+			}
+
+			if (offset < lineSize && lineBuffer[offset] == '/') {
+				JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+				normal = JIIObjEatU32(lineBuffer, lineSize, &offset);
+			}
+		}
+
+		JIIObjStatus status = JIIObjAddFaceCorner(context, position, uv, normal, &verticesInFace, &cachedIndex0, &cachedIndex1);
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// parser for files where every corner has the same layout (checked while peeking),
+// the separators are skipped blindly so there is no branching on the format per corner
+template<bool hasUV, bool hasNormal>
+JIIPrivate JIIObjStatus JIIObjParseFaceFormat(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset) {
+	JIIAssert(context && lineBuffer && lineSize);
+	JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+
+	u32 verticesInFace = 0;
+
+	u32 cachedIndex0 = 0;
+	u32 cachedIndex1 = 0;
+
+	while (offset < lineSize) {
+		JIIObjEatWhitespaces(lineBuffer, lineSize, &offset);
+		if (offset >= lineSize || !JIIObjIsDigit(lineBuffer[offset])) {
+			break;
+		}
+
+		u32 position = JIIObjEatU32(lineBuffer, lineSize, &offset);
+		u32 uv = UINT_MAX;
+		u32 normal = UINT_MAX;
+
+		if (hasUV) {
+			++offset;
+			uv = JIIObjEatU32(lineBuffer, lineSize, &offset);
+		}
+
+		if (hasNormal) {
+			// p//n has an extra slash to skip
+			offset += hasUV ? 1 : 2;
+			normal = JIIObjEatU32(lineBuffer, lineSize, &offset);
+		}
+
+		JIIObjStatus status = JIIObjAddFaceCorner(context, position, uv, normal, &verticesInFace, &cachedIndex0, &cachedIndex1);
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjFaceParser JIIObjSelectFaceParser(JIIObjFaceFormat format) {
+	switch (format) {
+		case JIIObjFaceFormat::FaceFormatP: {
+			return JIIObjParseFaceFormat<false, false>;
+		}
+		case JIIObjFaceFormat::FaceFormatPT: {
+			return JIIObjParseFaceFormat<true, false>;
+		}
+		case JIIObjFaceFormat::FaceFormatPN: {
+			return JIIObjParseFaceFormat<false, true>;
+		}
+		case JIIObjFaceFormat::FaceFormatPTN: {
+			return JIIObjParseFaceFormat<true, true>;
+		}
+		default: {
+			return JIIObjParseFace;
+		}
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjParseLine(JIIObjContext* context, u8* lineBuffer, u32 lineSize) {
+	JIIAssert(context && lineBuffer && lineSize);
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+
+	u32 offset = 0;
+	switch (lineBuffer[offset]) {
+		case 'v': {
+			status = JIIObjParseVertexAttribute(context, lineBuffer, lineSize, offset);
+			break;
+		}
+		case 'f': {
+			status = context->faceParser(context, lineBuffer, lineSize, offset);
+			break;
+		}
+		default: {
+			break;
+		}
+		// not caring about other attributes for now
+	}
+
+	return status;
+}
+
+JIIPrivate void JIIObjMergeFaceFormat(JIIObjContext* context, u32 slashes, bool doubleSlash) {
+	JIIObjFaceFormat format;
+	switch (slashes) {
+		case 0: {
+			format = JIIObjFaceFormat::FaceFormatP;
+			break;
+		}
+		case 1: {
+			format = JIIObjFaceFormat::FaceFormatPT;
+			break;
+		}
+		case 2: {
+			format = doubleSlash ? JIIObjFaceFormat::FaceFormatPN : JIIObjFaceFormat::FaceFormatPTN;
+			break;
+		}
+		default: {
+			format = JIIObjFaceFormat::FaceFormatMixed;
+			break;
+		}
+	}
+
+	if (context->faceFormat == JIIObjFaceFormat::FaceFormatUnknown) {
+		context->faceFormat = format;
+	}
+	else if (context->faceFormat != format) {
+		context->faceFormat = JIIObjFaceFormat::FaceFormatMixed;
+	}
+}
+
+JIIPrivate void JIIObjTryPeekAttribute(JIIObjContext* context) {
+	JIIAssert(context);
+
+	switch (context->fileBuffer[context->fileCursor]) {
+		case 'v': {
+			if (context->fileCursor + 1 < context->fileSize) {
+				switch (context->fileBuffer[context->fileCursor + 1]) {
+					case ' ': {
+						++context->modelData.numberOfPositions;
+						break;
+					}
+					case 't': {
+						++context->modelData.numberOfUVs;
+						break;
+					}
+					case 'n': {
+						++context->modelData.numberOfNormals;
+						break;
+					}
+				}
+			}
+			break;
+		}
+		// this is more fragile than my ego
+		case 'f': {
+			// skip whitespace right after
+			JII_ADVANCE_CHECK_RETURN_NOVALUE(context->fileCursor, context->fileSize);
+			JII_ADVANCE_CHECK_RETURN_NOVALUE(context->fileCursor, context->fileSize);
+
+			u32 spaces = 0;
+
+			// every corner gets its layout checked so the parser can be picked up front
+			u32 slashes = 0;
+			bool doubleSlash = false;
+			bool inCorner = false;
+			while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
+				u8 c = context->fileBuffer[context->fileCursor];
+				if (JIIObjIsWhitespace(c)) {
+					++spaces;
+					if (inCorner) {
+						JIIObjMergeFaceFormat(context, slashes, doubleSlash);
+						slashes = 0;
+						doubleSlash = false;
+						inCorner = false;
+					}
+				}
+				else {
+					if (c == '/') {
+						doubleSlash |= context->fileBuffer[context->fileCursor - 1] == '/';
+						++slashes;
+					}
+					inCorner = true;
+				}
+				JII_ADVANCE_CHECK_BREAK(context->fileCursor, context->fileSize);
+			}
+
+			if (inCorner) {
+				JIIObjMergeFaceFormat(context, slashes, doubleSlash);
+			}
+
+			u32 verticesPerFace = spaces + 1;
+			
+			JIIAssert(verticesPerFace == 3 || verticesPerFace > 3);
+
+			if (verticesPerFace > 3) {
+				// when we triangulate faces we will get more faces from non-triangulated face
+				context->modelData.numberOfFaces += verticesPerFace - 2;
+			}
+			else if(verticesPerFace == 3){
+				++context->modelData.numberOfFaces;
+			}
+			
+			break;
+		}
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjPeekFile(JIIObjContext* context) {
+	JIIAssert(context);
+	JIITraceScope("JIIObjPeekFile");
+
+	u32 saveCursor = context->fileCursor;
+
+	JIIObjStatus status;
+	while (true) {
+		if (context->fileCursor >= context->facesBegin || context->fileBuffer[context->fileCursor] != 'f') {
+			JIIObjTryPeekAttribute(context);
+		}
+		status = JIIObjSkipToNextLine(context);
+		if (status != JIIObjStatus::Ok) {
+			break;
+		}
+	}
+
+	context->fileCursor = saveCursor;
+
+	return JIIObjStatus::Ok;
+}
+
+// every array is sized from the counts already set in data
+JIIPrivate void JIIObjAllocateModelData(JIIObjModelData* data) {
+	JIIAssert(data);
+
+	data->positions = (JIIObjPosition*)JIIMalloc(sizeof(JIIObjPosition) * data->numberOfPositions);
+	data->normals = (JIIObjNormal*)JIIMalloc(sizeof(JIIObjNormal) * data->numberOfNormals);
+	data->uvs = (JIIObjUV*)JIIMalloc(sizeof(JIIObjUV) * data->numberOfUVs);
+	data->faces = (JIIObjFace*)JIIMalloc(sizeof(JIIObjFace) * data->numberOfFaces);
+	data->vertices = (JIIObjVertex*)JIIMalloc(sizeof(JIIObjVertex) * data->numberOfVertices);
+}
+
+// peek in order to know how much space is needed and how the faces look like
+JIIPrivate void JIIObjPrepareParse(JIIObjContext* context) {
+	JIIAssert(context);
+
+	JIIObjPeekFile(context);
+	context->faceParser = JIIObjSelectFaceParser(context->faceFormat);
+	JIITraceCounter("JIIObjPositions", context->modelData.numberOfPositions);
+	JIITraceCounter("JIIObjFaceFormat", context->faceFormat);
+	JIITraceCounter("JIIObjFaces", context->modelData.numberOfFaces);
+}
+
+JIIPrivate void JIIObjAllocateVertexTable(JIIObjContext* context, u32 maxVertices) {
+	JIIAssert(context);
+
+	context->vertexTableSize = 16;
+	while (context->vertexTableSize < maxVertices * 2) {
+		context->vertexTableSize <<= 1;
+	}
+	context->vertexTable = (u32*)JIIMalloc(sizeof(u32) * context->vertexTableSize);
+	memset(context->vertexTable, 0xff, sizeof(u32) * context->vertexTableSize);
+	context->vertexKeys = (JIIObjVertexKey*)JIIMalloc(sizeof(JIIObjVertexKey) * maxVertices);
+}
+
+#ifndef JII_OBJ_MAX_LINE
+// longest line that gets parsed, longer ones are OutOfSpace whichever way the file is loaded. Comments
+// are skipped whatever their length
+#define JII_OBJ_MAX_LINE 256
+#endif
+
+JIIPrivate JIIObjStatus JIIObjParseLines(JIIObjContext* context) {
+	JIIAssert(context);
+
+	u8 lineBuffer[JII_OBJ_MAX_LINE];
+	u32 lineSize;
+	JIIObjStatus status;
+	while (true) {
+		u32 lineStart = context->fileCursor;
+		status = JIIObjReadLine(context, lineBuffer, &lineSize, JII_OBJ_MAX_LINE);
+		if (status != JIIObjStatus::Ok && status != JIIObjStatus::Eof) {
+			return status;
+		}
+
+		if (lineSize != 0 && (lineStart >= context->facesBegin || lineBuffer[0] != 'f')) {
+			JIIObjStatus lineStatus = JIIObjParseLine(context, lineBuffer, lineSize);
+			if (lineStatus != JIIObjStatus::Ok) {
+				return lineStatus;
+			}
+		}
+
+		if (status == JIIObjStatus::Eof) {
+			return status;
+		}
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjParseBuffer(JIIObjContext* context) {
+	JIIAssert(context);
+	JIITraceScope("JIIObjParseBuffer");
+	JIITraceCounter("JIIObjFileSize", context->fileSize);
+
+	if (context->fileSize == 0) {
+		JIIObjAllocateModelData(&context->modelData);
+		return JIIObjStatus::Eof;
+	}
+
+	JIIObjPrepareParse(context);
+
+	// every corner could be a new vertex, the real count is known after parsing
+	context->modelData.numberOfVertices = context->modelData.numberOfFaces * 3;
+	JIIObjAllocateModelData(&context->modelData);
+	JIIObjAllocateVertexTable(context, (u32)context->modelData.numberOfVertices);
+
+	return JIIObjParseLines(context);
+}
+
+// 0xffff itself is left out so it can still be used as the primitive restart index
+#define JII_OBJ_MAX_INDEX16_VERTICES 0xffff
+
+JIIPrivate u32 JIIObjGetFaceIndex(JIIObjModelData* data, u32 face, u32 corner) {
+	if (data->indexType == JIIObjIndexType::Index16) {
+		return data->faces16[face].indices[corner];
+	}
+	return (u32)data->faces[face].indices[corner];
+}
+
+// reallocates an array down to the elements that are actually used
+JIIPrivate void* JIIObjShrinkArray(void* array, u32 elementSize, u32 capacity, u32 used) {
+	if (used >= capacity) {
+		return array;
+	}
+
+	// keeping the bigger array is fine when there is no memory for the smaller one
+	void* result = JIIMalloc((size_t)elementSize * used);
+	if (!result) {
+		return array;
+	}
+	memcpy(result, array, (size_t)elementSize * used);
+	JIIFree(array);
+	return result;
+}
+
+// with trim off the faces keep their 32 bit allocation, a JIIObjLoader reuses it next time
+JIIPrivate JIIObjStatus JIIObjSelectIndexType(JIIObjModelData* data, JIIObjHint hints, bool trim) {
+	JIIAssert(data);
+	JIIAssert(!((hints & JII_OBJ_INDEX_32) && (hints & JII_OBJ_INDEX_16)));
+
+	if (data->indexType == JIIObjIndexType::Index16 || (hints & JII_OBJ_INDEX_32)) {
+		return JIIObjStatus::Ok;
+	}
+
+	if (data->numberOfVertices > JII_OBJ_MAX_INDEX16_VERTICES) {
+		return (hints & JII_OBJ_INDEX_16) ? JIIObjStatus::OutOfSpace : JIIObjStatus::Ok;
+	}
+
+	// a 16 bit face is half of a 32 bit one so they get packed in place front to back,
+	// face i is read whole before anything at or after it gets written
+	JIIObjFace16* faces16 = data->faces16;
+	for (i32 i = 0; i < data->numberOfFaces; ++i) {
+		JIIObjFace face = data->faces[i];
+		faces16[i].index0 = (u16)face.index0;
+		faces16[i].index1 = (u16)face.index1;
+		faces16[i].index2 = (u16)face.index2;
+	}
+
+	if (trim) {
+		data->faces16 = (JIIObjFace16*)JIIObjShrinkArray(faces16, sizeof(JIIObjFace16), (u32)data->numberOfFaces * 2, (u32)data->numberOfFaces);
+	}
+	data->indexType = JIIObjIndexType::Index16;
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate void JIIObjFreeContextScratch(JIIObjContext* context) {
+	JIIFree(context->vertexTable);
+	JIIFree(context->vertexKeys);
+	context->vertexTable = NULL;
+	context->vertexKeys = NULL;
+}
+
+struct JIIObjWeldCell {
+	i64 x;
+	i64 y;
+	i64 z;
+};
+
+// converting a NaN, an inf or anything past the i64 range is undefined, those get clamped to a cell that
+// still leaves room for the neighbours around it, they can't be within epsilon of anything anyway
+JIIPrivate i64 JIIObjGetWeldCoordinate(float value, double inverseCellSize) {
+	double scaled = floor(value * inverseCellSize);
+	if (scaled != scaled) {
+		return 0;
+	}
+
+	const double limit = 4611686018427387904.0; // 2^62
+	if (scaled >= limit) {
+		return (i64)1 << 62;
+	}
+	if (scaled <= -limit) {
+		return -((i64)1 << 62);
+	}
+	return (i64)scaled;
+}
+
+// with an epsilon of 0 the cell is the exact bit pattern so only equal positions meet
+JIIPrivate JIIObjWeldCell JIIObjGetWeldCell(JIIObjPosition position, double inverseCellSize) {
+	JIIObjWeldCell cell;
+	if (inverseCellSize == 0) {
+		// + 0.0f turns -0 into 0
+		float x = position.x + 0.0f;
+		float y = position.y + 0.0f;
+		float z = position.z + 0.0f;
+		u32 bits[3];
+		memcpy(&bits[0], &x, sizeof(u32));
+		memcpy(&bits[1], &y, sizeof(u32));
+		memcpy(&bits[2], &z, sizeof(u32));
+		cell.x = bits[0];
+		cell.y = bits[1];
+		cell.z = bits[2];
+	}
+	else {
+		cell.x = JIIObjGetWeldCoordinate(position.x, inverseCellSize);
+		cell.y = JIIObjGetWeldCoordinate(position.y, inverseCellSize);
+		cell.z = JIIObjGetWeldCoordinate(position.z, inverseCellSize);
+	}
+	return cell;
+}
+
+JIIPrivate u32 JIIObjHashWeldCell(JIIObjWeldCell cell) {
+	u64 hash = (u64)cell.x * 0x9e3779b97f4a7c15ull;
+	hash ^= (u64)cell.y * 0xc2b2ae3d27d4eb4full;
+	hash ^= (u64)cell.z * 0x165667b19e3779f9ull;
+	hash ^= hash >> 29;
+	return (u32)hash;
+}
+
+// every slot holds the last position added to a cell, positions of the same cell are chained
+struct JIIObjWeldGrid {
+	u32* slots;
+	u32 mask;
+	u32* nextInCell;
+	JIIObjWeldCell* cells;
+};
+
+JIIPrivate u32* JIIObjFindWeldSlot(JIIObjWeldGrid* grid, JIIObjWeldCell cell) {
+	u32 slot = JIIObjHashWeldCell(cell) & grid->mask;
+	while (grid->slots[slot] != UINT32_MAX) {
+		JIIObjWeldCell* existing = &grid->cells[grid->slots[slot]];
+		if (existing->x == cell.x && existing->y == cell.y && existing->z == cell.z) {
+			break;
+		}
+		slot = (slot + 1) & grid->mask;
+	}
+	return &grid->slots[slot];
+}
+
+// merges positions within epsilon of each other (the first one seen wins), fixes the vertices
+// to point at the merged positions, merges vertices that became the same and drops the faces
+// that collapsed, vertex i uses position keys[i].position or position i when there are no keys,
+// the keys are kept up to date with the new vertices, welded gets how many positions went away,
+// nothing is touched when there is no memory for the scratch
+JIIPrivate JIIObjStatus JIIObjWeldPositions(JIIObjModelData* data, JIIObjVertexKey* keys, float epsilon, u32* welded) {
+	JIIAssert(data && data->indexType == JIIObjIndexType::Index32);
+	JIITraceScope("JIIObjWeldPositions");
+
+	u32 numberOfPositions = (u32)data->numberOfPositions;
+	u32 numberOfVertices = (u32)data->numberOfVertices;
+
+	u32 tableSize = 16;
+	while (tableSize < numberOfPositions * 2 || tableSize < numberOfVertices * 2) {
+		tableSize <<= 1;
+	}
+
+	JIIObjWeldGrid grid;
+	grid.slots = (u32*)JIIMalloc(sizeof(u32) * tableSize);
+	grid.mask = tableSize - 1;
+	grid.nextInCell = (u32*)JIIMalloc(sizeof(u32) * numberOfPositions);
+	grid.cells = (JIIObjWeldCell*)JIIMalloc(sizeof(JIIObjWeldCell) * numberOfPositions);
+
+	u32* positionRemap = (u32*)JIIMalloc(sizeof(u32) * numberOfPositions);
+	u32* vertexPositions = (u32*)JIIMalloc(sizeof(u32) * numberOfVertices);
+	u32* vertexRemap = (u32*)JIIMalloc(sizeof(u32) * numberOfVertices);
+
+	if (!grid.slots || (numberOfPositions && (!grid.nextInCell || !grid.cells || !positionRemap)) ||
+		(numberOfVertices && (!vertexPositions || !vertexRemap))) {
+		JIIFree(vertexRemap);
+		JIIFree(vertexPositions);
+		JIIFree(positionRemap);
+		JIIFree(grid.cells);
+		JIIFree(grid.nextInCell);
+		JIIFree(grid.slots);
+		return JIIObjStatus::OutOfSpace;
+	}
+	memset(grid.slots, 0xff, sizeof(u32) * tableSize);
+
+	double inverseCellSize = epsilon > 0 ? 1.0 / epsilon : 0;
+	i32 reach = epsilon > 0 ? 1 : 0;
+	float epsilonSquared = epsilon * epsilon;
+
+	// positions only ever move to lower indices so the compaction happens in place
+	u32 usedPositions = 0;
+	for (u32 i = 0; i < numberOfPositions; ++i) {
+		JIIObjPosition position = data->positions[i];
+		JIIObjWeldCell cell = JIIObjGetWeldCell(position, inverseCellSize);
+
+		u32 found = UINT32_MAX;
+		for (i32 dz = -reach; dz <= reach && found == UINT32_MAX; ++dz) {
+			for (i32 dy = -reach; dy <= reach && found == UINT32_MAX; ++dy) {
+				for (i32 dx = -reach; dx <= reach && found == UINT32_MAX; ++dx) {
+					JIIObjWeldCell neighbour = { cell.x + dx, cell.y + dy, cell.z + dz };
+					for (u32 other = *JIIObjFindWeldSlot(&grid, neighbour); other != UINT32_MAX; other = grid.nextInCell[other]) {
+						float x = data->positions[other].x - position.x;
+						float y = data->positions[other].y - position.y;
+						float z = data->positions[other].z - position.z;
+						if (x * x + y * y + z * z <= epsilonSquared) {
+							found = other;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if (found == UINT32_MAX) {
+			found = usedPositions++;
+			data->positions[found] = position;
+			grid.cells[found] = cell;
+
+			u32* slot = JIIObjFindWeldSlot(&grid, cell);
+			grid.nextInCell[found] = *slot;
+			*slot = found;
+		}
+
+		positionRemap[i] = found;
+	}
+
+	// same idea for the vertices, except they have to be exactly the same
+	memset(grid.slots, 0xff, sizeof(u32) * tableSize);
+
+	u32 usedVertices = 0;
+	for (u32 i = 0; i < numberOfVertices; ++i) {
+		u32 positionIndex = positionRemap[keys ? keys[i].position : i];
+		JIIObjVertex vertex = data->vertices[i];
+		vertex.position = data->positions[positionIndex];
+
+		u32 hash = positionIndex * 0x9e3779b1u;
+		u32 words[(sizeof(JIIObjUV) + sizeof(JIIObjNormal)) / sizeof(u32)];
+		memcpy(words, &vertex.uv, sizeof(JIIObjUV));
+		memcpy((u8*)words + sizeof(JIIObjUV), &vertex.normal, sizeof(JIIObjNormal));
+		for (u32 word = 0; word < sizeof(words) / sizeof(u32); ++word) {
+			hash = (hash ^ words[word]) * 0x85ebca77u;
+		}
+		hash ^= hash >> 15;
+
+		u32 slot = hash & grid.mask;
+		while (grid.slots[slot] != UINT32_MAX) {
+			u32 other = grid.slots[slot];
+			if (vertexPositions[other] == positionIndex &&
+				!memcmp(&data->vertices[other].uv, &vertex.uv, sizeof(JIIObjUV)) &&
+				!memcmp(&data->vertices[other].normal, &vertex.normal, sizeof(JIIObjNormal))) {
+				break;
+			}
+			slot = (slot + 1) & grid.mask;
+		}
+
+		if (grid.slots[slot] == UINT32_MAX) {
+			grid.slots[slot] = usedVertices;
+			// vertices are compacted in place too, other < i always
+			vertexPositions[usedVertices] = positionIndex;
+			if (keys) {
+				JIIObjVertexKey key = keys[i];
+				key.position = positionIndex;
+				keys[usedVertices] = key;
+			}
+			data->vertices[usedVertices++] = vertex;
+		}
+
+		vertexRemap[i] = grid.slots[slot];
+	}
+
+	u32 usedFaces = 0;
+	for (i32 i = 0; i < data->numberOfFaces; ++i) {
+		JIIObjFace face;
+		face.index0 = vertexRemap[data->faces[i].index0];
+		face.index1 = vertexRemap[data->faces[i].index1];
+		face.index2 = vertexRemap[data->faces[i].index2];
+
+		if (face.index0 == face.index1 || face.index1 == face.index2 || face.index0 == face.index2) {
+			continue;
+		}
+		data->faces[usedFaces++] = face;
+	}
+
+	JIIFree(vertexRemap);
+	JIIFree(vertexPositions);
+	JIIFree(positionRemap);
+	JIIFree(grid.cells);
+	JIIFree(grid.nextInCell);
+	JIIFree(grid.slots);
+
+	data->positions = (JIIObjPosition*)JIIObjShrinkArray(data->positions, sizeof(JIIObjPosition), numberOfPositions, usedPositions);
+	data->vertices = (JIIObjVertex*)JIIObjShrinkArray(data->vertices, sizeof(JIIObjVertex), numberOfVertices, usedVertices);
+	data->faces = (JIIObjFace*)JIIObjShrinkArray(data->faces, sizeof(JIIObjFace), (u32)data->numberOfFaces, usedFaces);
+	data->numberOfPositions = (i32)usedPositions;
+	data->numberOfVertices = (i32)usedVertices;
+	data->numberOfFaces = (i32)usedFaces;
+
+	*welded = numberOfPositions - usedPositions;
+	JIITraceCounter("JIIObjWeldedPositions", *welded);
+	return JIIObjStatus::Ok;
+}
+
+// one pass over the faces drops the degenerate ones and hands out new indices to vertices and
+// attributes in the order faces first use them, then every array is gathered in that order so
+// whatever was never referenced is gone and neighbouring faces read neighbouring memory,
+// keys[i] are the attributes of vertex i, reclaimed gets the bytes given back, when it runs out of
+// memory the faces may already be rewritten so the model is only good for JIIObjFreeData
+JIIPrivate JIIObjStatus JIIObjCompactModel(JIIObjModelData* data, const JIIObjVertexKey* keys, u64* reclaimed) {
+	JIIAssert(data && (keys || !data->numberOfVertices) && data->indexType == JIIObjIndexType::Index32);
+	JIITraceScope("JIIObjCompactModel");
+
+	u32 numberOfPositions = (u32)data->numberOfPositions;
+	u32 numberOfUVs = (u32)data->numberOfUVs;
+	u32 numberOfNormals = (u32)data->numberOfNormals;
+	u32 numberOfVertices = (u32)data->numberOfVertices;
+	u32 numberOfFaces = (u32)data->numberOfFaces;
+
+	// remaps go old -> new, orders go new -> old
+	u32 remapSize = numberOfVertices + numberOfPositions + numberOfUVs + numberOfNormals;
+	u32* remaps = (u32*)JIIMalloc(sizeof(u32) * remapSize);
+	u32* orders = (u32*)JIIMalloc(sizeof(u32) * remapSize);
+	if (!remaps || !orders) {
+		JIIFree(remaps);
+		JIIFree(orders);
+		return JIIObjStatus::OutOfSpace;
+	}
+	memset(remaps, 0xff, sizeof(u32) * remapSize);
+
+	u32* vertexRemap = remaps;
+	u32* positionRemap = vertexRemap + numberOfVertices;
+	u32* uvRemap = positionRemap + numberOfPositions;
+	u32* normalRemap = uvRemap + numberOfUVs;
+
+	u32* vertexOrder = orders;
+	u32* positionOrder = vertexOrder + numberOfVertices;
+	u32* uvOrder = positionOrder + numberOfPositions;
+	u32* normalOrder = uvOrder + numberOfUVs;
+
+	u32 usedVertices = 0;
+	u32 usedPositions = 0;
+	u32 usedUVs = 0;
+	u32 usedNormals = 0;
+	u32 usedFaces = 0;
+
+	for (u32 i = 0; i < numberOfFaces; ++i) {
+		JIIObjFace face = data->faces[i];
+		if (face.index0 == face.index1 || face.index1 == face.index2 || face.index0 == face.index2) {
+			continue;
+		}
+
+		JIIObjPosition a = data->vertices[face.index0].position;
+		JIIObjPosition b = data->vertices[face.index1].position;
+		JIIObjPosition c = data->vertices[face.index2].position;
+		float abX = b.x - a.x, abY = b.y - a.y, abZ = b.z - a.z;
+		float acX = c.x - a.x, acY = c.y - a.y, acZ = c.z - a.z;
+		float crossX = abY * acZ - abZ * acY;
+		float crossY = abZ * acX - abX * acZ;
+		float crossZ = abX * acY - abY * acX;
+		if (crossX == 0 && crossY == 0 && crossZ == 0) {
+			continue;
+		}
+
+		for (u32 corner = 0; corner < 3; ++corner) {
+			u32 vertex = face.indices[corner];
+			if (vertexRemap[vertex] == UINT32_MAX) {
+				vertexRemap[vertex] = usedVertices;
+				vertexOrder[usedVertices++] = vertex;
+
+				const JIIObjVertexKey* key = &keys[vertex];
+				if (positionRemap[key->position] == UINT32_MAX) {
+					positionRemap[key->position] = usedPositions;
+					positionOrder[usedPositions++] = key->position;
+				}
+				if (key->uv != UINT_MAX && uvRemap[key->uv] == UINT32_MAX) {
+					uvRemap[key->uv] = usedUVs;
+					uvOrder[usedUVs++] = key->uv;
+				}
+				if (key->normal != UINT_MAX && normalRemap[key->normal] == UINT32_MAX) {
+					normalRemap[key->normal] = usedNormals;
+					normalOrder[usedNormals++] = key->normal;
+				}
+			}
+			face.indices[corner] = vertexRemap[vertex];
+		}
+
+		data->faces[usedFaces++] = face;
+	}
+
+	JIIObjVertex* vertices = (JIIObjVertex*)JIIMalloc(sizeof(JIIObjVertex) * usedVertices);
+	JIIObjPosition* positions = (JIIObjPosition*)JIIMalloc(sizeof(JIIObjPosition) * usedPositions);
+	JIIObjUV* uvs = (JIIObjUV*)JIIMalloc(sizeof(JIIObjUV) * usedUVs);
+	JIIObjNormal* normals = (JIIObjNormal*)JIIMalloc(sizeof(JIIObjNormal) * usedNormals);
+	if ((!vertices && usedVertices) || (!positions && usedPositions) || (!uvs && usedUVs) || (!normals && usedNormals)) {
+		JIIFree(vertices);
+		JIIFree(positions);
+		JIIFree(uvs);
+		JIIFree(normals);
+		JIIFree(orders);
+		JIIFree(remaps);
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	for (u32 i = 0; i < usedVertices; ++i) {
+		vertices[i] = data->vertices[vertexOrder[i]];
+	}
+
+	for (u32 i = 0; i < usedPositions; ++i) {
+		positions[i] = data->positions[positionOrder[i]];
+	}
+
+	for (u32 i = 0; i < usedUVs; ++i) {
+		uvs[i] = data->uvs[uvOrder[i]];
+	}
+
+	for (u32 i = 0; i < usedNormals; ++i) {
+		normals[i] = data->normals[normalOrder[i]];
+	}
+
+	JIIFree(orders);
+	JIIFree(remaps);
+
+	JIIFree(data->vertices);
+	JIIFree(data->positions);
+	JIIFree(data->uvs);
+	JIIFree(data->normals);
+	data->vertices = vertices;
+	data->positions = positions;
+	data->uvs = uvs;
+	data->normals = normals;
+	data->faces = (JIIObjFace*)JIIObjShrinkArray(data->faces, sizeof(JIIObjFace), numberOfFaces, usedFaces);
+
+	*reclaimed = (u64)(numberOfVertices - usedVertices) * sizeof(JIIObjVertex) +
+		(u64)(numberOfPositions - usedPositions) * sizeof(JIIObjPosition) +
+		(u64)(numberOfUVs - usedUVs) * sizeof(JIIObjUV) +
+		(u64)(numberOfNormals - usedNormals) * sizeof(JIIObjNormal) +
+		(u64)(numberOfFaces - usedFaces) * sizeof(JIIObjFace);
+
+	data->numberOfVertices = (i32)usedVertices;
+	data->numberOfPositions = (i32)usedPositions;
+	data->numberOfUVs = (i32)usedUVs;
+	data->numberOfNormals = (i32)usedNormals;
+	data->numberOfFaces = (i32)usedFaces;
+
+	JIITraceCounter("JIIObjCompactedBytes", *reclaimed);
+	return JIIObjStatus::Ok;
+}
+
+// welds and compacts when asked to and picks the index width, last thing every loader does
+JIIPrivate JIIObjStatus JIIObjFinishLoad(JIIObjModelData* data, JIIObjVertexKey* keys, JIIObjLoadOptions* options, bool trim) {
+	JIIAssert(data);
+
+	if (!options) {
+		return JIIObjSelectIndexType(data, JII_OBJ_NO_HINT, trim);
+	}
+
+	options->weldedPositions = 0;
+	if (options->hints & JII_OBJ_WELD_POSITIONS) {
+		JIIObjStatus status = JIIObjWeldPositions(data, keys, options->weldEpsilon, &options->weldedPositions);
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+	}
+
+	options->compactedBytes = 0;
+	if (options->hints & JII_OBJ_COMPACT) {
+		JIIObjStatus status = JIIObjCompactModel(data, keys, &options->compactedBytes);
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+	}
+
+	return JIIObjSelectIndexType(data, options->hints, trim);
+}
+
+#ifndef JII_OBJ_PREFETCH_DISTANCE
+// vertices ahead of the one being assembled whose attributes get prefetched
+#define JII_OBJ_PREFETCH_DISTANCE 16
+#endif
+
+struct JIIObjAssembleTask {
+	JIIObjModelData* data;
+	const JIIObjVertexKey* keys;
+
+	u32 numberOfPositions;
+	u32 numberOfUVs;
+	u32 numberOfNormals;
+
+	// set by any thread that ran into an index past the attributes
+	u32 invalid;
+
+	// the offsets of an indexed object, indices before the object wrap around to at least these
+	u32 positionsOffset;
+	u32 uvsOffset;
+	u32 normalsOffset;
+	u32 beforeObject;
+};
+
+JIIPrivate void JIIObjAssembleVerticesProc(void* data, u32 begin, u32 end) {
+	JIIObjAssembleTask* task = (JIIObjAssembleTask*)data;
+	JIIObjModelData* model = task->data;
+	const JIIObjVertexKey* keys = task->keys;
+
+	bool invalid = false;
+	bool beforeObject = false;
+	for (u32 i = begin; i < end; ++i) {
+		// the keys are read in order, the attributes they point at are all over the place
+		if (i + JII_OBJ_PREFETCH_DISTANCE < end) {
+			const JIIObjVertexKey* ahead = &keys[i + JII_OBJ_PREFETCH_DISTANCE];
+			if (ahead->position < task->numberOfPositions) {
+				JIIObjPrefetch(&model->positions[ahead->position]);
+			}
+			if (ahead->uv < task->numberOfUVs) {
+				JIIObjPrefetch(&model->uvs[ahead->uv]);
+			}
+			if (ahead->normal < task->numberOfNormals) {
+				JIIObjPrefetch(&model->normals[ahead->normal]);
+			}
+		}
+
+		JIIObjVertexKey key = keys[i];
+		if (key.position >= task->numberOfPositions ||
+			(key.uv != UINT_MAX && key.uv >= task->numberOfUVs) ||
+			(key.normal != UINT_MAX && key.normal >= task->numberOfNormals)) {
+			invalid = true;
+			beforeObject = beforeObject ||
+				(task->positionsOffset && key.position >= task->positionsOffset) ||
+				(task->uvsOffset && key.uv != UINT_MAX && key.uv >= task->uvsOffset) ||
+				(task->normalsOffset && key.normal != UINT_MAX && key.normal >= task->normalsOffset);
+			continue;
+		}
+
+		JIIObjVertex vertex = {};
+		vertex.position = model->positions[key.position];
+		if (key.uv != UINT_MAX) {
+			vertex.uv = model->uvs[key.uv];
+		}
+		if (key.normal != UINT_MAX) {
+			vertex.normal = model->normals[key.normal];
+		}
+		model->vertices[i] = vertex;
+	}
+
+	if (invalid) {
+		JIIObjAtomicStore32(&task->invalid, 1);
+	}
+	if (beforeObject) {
+		JIIObjAtomicStore32(&task->beforeObject, 1);
+	}
+}
+
+// the parser only records which p/t/n every vertex uses, the vertices themselves are gathered here in
+// parallel blocks once every attribute is known
+JIIPrivate JIIObjStatus JIIObjAssembleVertices(JIIObjContext* context) {
+	JIIAssert(context);
+	JIITraceScope("JIIObjAssembleVertices");
+
+	JIIObjAssembleTask task = {};
+	task.data = &context->modelData;
+	task.keys = context->vertexKeys;
+	task.numberOfPositions = context->usedPositions;
+	task.numberOfUVs = context->usedUVs;
+	task.numberOfNormals = context->usedNormals;
+	task.positionsOffset = context->positionsOffset;
+	task.uvsOffset = context->uvsOffset;
+	task.normalsOffset = context->normalsOffset;
+
+	JIIObjParallelFor(context->usedVertices, 1 << 14, JIIObjAssembleVerticesProc, &task);
+
+	context->indexBeforeObject = task.beforeObject != 0;
+	return task.invalid ? JIIObjStatus::Error : JIIObjStatus::Ok;
+}
+
+// trims everything that was allocated for the worst case and picks the index width
+JIIPrivate JIIObjStatus JIIObjFinishModelData(JIIObjContext* context, JIIObjLoadOptions* options) {
+	JIIAssert(context);
+
+	JIIObjStatus status = JIIObjAssembleVertices(context);
+	if (status == JIIObjStatus::Ok) {
+		JIIObjModelData* data = &context->modelData;
+		data->numberOfFaces = context->usedFaces;
+
+		data->vertices = (JIIObjVertex*)JIIObjShrinkArray(data->vertices, sizeof(JIIObjVertex), (u32)data->numberOfVertices, context->usedVertices);
+		data->numberOfVertices = context->usedVertices;
+
+		status = JIIObjFinishLoad(data, context->vertexKeys, options, true);
+	}
+
+	JIIObjFreeContextScratch(context);
+
+	return status;
+}
+
+// takes whatever JIIObjParseBuffer returned, data is only written when everything went fine
+JIIPrivate JIIObjStatus JIIObjFinishContext(JIIObjContext* context, JIIObjStatus status, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(context && data);
+
+	if (status == JIIObjStatus::Ok || status == JIIObjStatus::Eof) {
+		status = JIIObjFinishModelData(context, options);
+	}
+
+	if (status != JIIObjStatus::Ok) {
+		JIIObjFreeContextScratch(context);
+		JIIObjFreeData(&context->modelData);
+		*data = {};
+		return status;
+	}
+
+	*data = context->modelData;
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadFromContext(JIIObjContext* context, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(context && data);
+
+	JIIObjStatus status = JIIObjParseBuffer(context);
+
+	JIIFree(context->fileBuffer);
+	context->fileBuffer = NULL;
+
+	return JIIObjFinishContext(context, status, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadData(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjContext context = {};
+
+	JIIObjStatus status;
+
+	status = JIIObjReadFile(path, &context.fileBuffer, &context.fileSize);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	return JIIObjLoadFromContext(&context, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadDataW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjContext context = {};
+
+	JIIObjStatus status;
+
+	status = JIIObjReadFileW(path, &context.fileBuffer, &context.fileSize);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	return JIIObjLoadFromContext(&context, data, options);
+}
+
+struct JIIObjQueryState {
+	JIIObjFileMapping mapping;
+	JIIObjFaceFormat faceFormat;
+};
+
+// runs the face lines through the vertex deduplication without parsing a single float
+JIIPrivate JIIObjStatus JIIObjQueryMapping(JIIObjModelQuery* query, JIIObjQueryState* state, JIIObjLoadOptions* options) {
+	JIIAssert(query && state);
+	JIITraceScope("JIIObjQueryData");
+
+	JIIObjHint hints = options ? options->hints : JII_OBJ_NO_HINT;
+	JIIAssert(!((hints & JII_OBJ_INDEX_32) && (hints & JII_OBJ_INDEX_16)));
+	if (hints & (JII_OBJ_WELD_POSITIONS | JII_OBJ_COMPACT)) {
+		return JIIObjStatus::Error;
+	}
+
+	if (state->mapping.size > UINT32_MAX) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	JIIObjContext context = {};
+	context.fileBuffer = state->mapping.data;
+	context.fileSize = (u32)state->mapping.size;
+	context.countOnly = true;
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+	if (context.fileSize != 0) {
+		JIIObjPrepareParse(&context);
+		JIIObjAllocateVertexTable(&context, (u32)context.modelData.numberOfFaces * 3);
+		status = JIIObjParseLines(&context);
+		JIIObjFreeContextScratch(&context);
+	}
+
+	if (status != JIIObjStatus::Ok && status != JIIObjStatus::Eof) {
+		return status;
+	}
+
+	state->faceFormat = context.faceFormat;
+
+	query->numberOfPositions = context.modelData.numberOfPositions;
+	query->numberOfUVs = context.modelData.numberOfUVs;
+	query->numberOfNormals = context.modelData.numberOfNormals;
+	query->numberOfVertices = (i32)context.usedVertices;
+	query->numberOfFaces = (i32)context.usedFaces;
+
+	query->indexType = JIIObjIndexType::Index32;
+	if (!(hints & JII_OBJ_INDEX_32)) {
+		if (context.usedVertices <= JII_OBJ_MAX_INDEX16_VERTICES) {
+			query->indexType = JIIObjIndexType::Index16;
+		}
+		else if (hints & JII_OBJ_INDEX_16) {
+			return JIIObjStatus::OutOfSpace;
+		}
+	}
+
+	query->positionsSize = sizeof(JIIObjPosition) * (u64)query->numberOfPositions;
+	query->uvsSize = sizeof(JIIObjUV) * (u64)query->numberOfUVs;
+	query->normalsSize = sizeof(JIIObjNormal) * (u64)query->numberOfNormals;
+	query->verticesSize = sizeof(JIIObjVertex) * (u64)query->numberOfVertices;
+	query->facesSize = (query->indexType == JIIObjIndexType::Index16 ? sizeof(JIIObjFace16) : sizeof(JIIObjFace)) * (u64)query->numberOfFaces;
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjFinishQuery(JIIObjModelQuery* query, JIIObjQueryState* state, JIIObjLoadOptions* options) {
+	JIIObjStatus status = JIIObjQueryMapping(query, state, options);
+	if (status != JIIObjStatus::Ok) {
+		JIIObjUnmapFile(&state->mapping);
+		JIIFree(state);
+		*query = {};
+		return status;
+	}
+
+	query->internal = state;
+	return JIIObjStatus::Ok;
+}
+
+JIIDef JIIObjStatus JIIObjQueryData(const char* path, JIIObjModelQuery* query, JIIObjLoadOptions* options) {
+	JIIAssert(path && query);
+
+	*query = {};
+
+	JIIObjQueryState* state = (JIIObjQueryState*)JIIMalloc(sizeof(JIIObjQueryState));
+	*state = {};
+
+	JIIObjStatus status = JIIObjMapFile(path, &state->mapping);
+	if (status != JIIObjStatus::Ok) {
+		JIIFree(state);
+		return status;
+	}
+
+	return JIIObjFinishQuery(query, state, options);
+}
+
+JIIDef JIIObjStatus JIIObjQueryDataW(const wchar_t* path, JIIObjModelQuery* query, JIIObjLoadOptions* options) {
+	JIIAssert(path && query);
+
+	*query = {};
+
+	JIIObjQueryState* state = (JIIObjQueryState*)JIIMalloc(sizeof(JIIObjQueryState));
+	*state = {};
+
+	JIIObjStatus status = JIIObjMapFileW(path, &state->mapping);
+	if (status != JIIObjStatus::Ok) {
+		JIIFree(state);
+		return status;
+	}
+
+	return JIIObjFinishQuery(query, state, options);
+}
+
+JIIDef JIIObjStatus JIIObjFillData(JIIObjModelQuery* query, JIIObjModelData* data) {
+	JIIAssert(query && query->internal && data);
+	JIIAssert(data->vertices || !query->numberOfVertices);
+	JIIAssert(data->faces || !query->numberOfFaces);
+	JIITraceScope("JIIObjFillData");
+
+	JIIObjQueryState* state = (JIIObjQueryState*)query->internal;
+
+	JIIObjContext context = {};
+	context.fileBuffer = state->mapping.data;
+	context.fileSize = (u32)state->mapping.size;
+	context.faceParser = JIIObjSelectFaceParser(state->faceFormat);
+
+	// the attributes the caller didn't ask for still have to be parsed somewhere
+	JIIObjModelData* model = &context.modelData;
+	model->positions = data->positions ? data->positions : (JIIObjPosition*)JIIMalloc((size_t)query->positionsSize);
+	model->uvs = data->uvs ? data->uvs : (JIIObjUV*)JIIMalloc((size_t)query->uvsSize);
+	model->normals = data->normals ? data->normals : (JIIObjNormal*)JIIMalloc((size_t)query->normalsSize);
+	model->vertices = data->vertices;
+	model->faces = data->faces;
+	model->indexType = query->indexType;
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+	if (context.fileSize != 0) {
+		JIIObjAllocateVertexTable(&context, (u32)query->numberOfVertices);
+		status = JIIObjParseLines(&context);
+		if (status == JIIObjStatus::Ok || status == JIIObjStatus::Eof) {
+			status = JIIObjAssembleVertices(&context);
+		}
+		JIIObjFreeContextScratch(&context);
+	}
+
+	if (!data->positions) {
+		JIIFree(model->positions);
+	}
+	if (!data->uvs) {
+		JIIFree(model->uvs);
+	}
+	if (!data->normals) {
+		JIIFree(model->normals);
+	}
+
+	if (status == JIIObjStatus::Ok || status == JIIObjStatus::Eof) {
+		// the same file went through the same parser, anything else means we wrote out of bounds
+		JIIAssert(context.usedVertices == (u32)query->numberOfVertices);
+		JIIAssert(context.usedFaces == (u32)query->numberOfFaces);
+
+		data->numberOfPositions = data->positions ? query->numberOfPositions : 0;
+		data->numberOfUVs = data->uvs ? query->numberOfUVs : 0;
+		data->numberOfNormals = data->normals ? query->numberOfNormals : 0;
+		data->numberOfVertices = query->numberOfVertices;
+		data->numberOfFaces = query->numberOfFaces;
+		data->indexType = query->indexType;
+		status = JIIObjStatus::Ok;
+	}
+
+	JIIObjReleaseQuery(query);
+
+	return status;
+}
+
+JIIDef void JIIObjReleaseQuery(JIIObjModelQuery* query) {
+	JIIAssert(query);
+
+	JIIObjQueryState* state = (JIIObjQueryState*)query->internal;
+	if (state) {
+		JIIObjUnmapFile(&state->mapping);
+		JIIFree(state);
+	}
+	query->internal = NULL;
+}
+
+JIIDef void JIIObjFreeData(JIIObjModelData* data) {
+	JIIAssert(data);
+
+	JIIFree(data->positions);
+	JIIFree(data->uvs);
+	JIIFree(data->normals);
+	JIIFree(data->faces);
+	JIIFree(data->vertices);
+}
+
+struct JIIObjLoader {
+	u8* fileBuffer;
+	u32 fileCapacity;
+
+	JIIObjPosition* positions;
+	u32 positionsCapacity;
+	JIIObjUV* uvs;
+	u32 uvsCapacity;
+	JIIObjNormal* normals;
+	u32 normalsCapacity;
+	JIIObjVertex* vertices;
+	u32 verticesCapacity;
+	// counted in 32 bit faces, 16 bit ones get packed into the same memory
+	JIIObjFace* faces;
+	u32 facesCapacity;
+
+	JIIObjVertexKey* vertexKeys;
+	u32 vertexKeysCapacity;
+	u32* vertexTable;
+	u32 vertexTableCapacity;
+};
+
+// like JIIObjGrowArray but the old content is thrown away, so there is nothing to copy
+JIIPrivate void* JIIObjReserveArray(void* array, u32 elementSize, u32* capacity, u32 needed) {
+	if (needed <= *capacity) {
+		return array;
+	}
+
+	u32 newCapacity = *capacity * 2 > needed ? *capacity * 2 : needed;
+
+	JIIFree(array);
+	*capacity = newCapacity;
+	return JIIMalloc((size_t)elementSize * newCapacity);
+}
+
+JIIPrivate JIIObjStatus JIIObjReadLoaderFile(JIIObjLoader* loader, FILE* file, u32* size) {
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (fileSize < 0 || (u64)fileSize > UINT32_MAX) {
+		return JIIObjStatus::Error;
+	}
+
+	*size = (u32)fileSize;
+	loader->fileBuffer = (u8*)JIIObjReserveArray(loader->fileBuffer, 1, &loader->fileCapacity, *size);
+
+	u32 bytesRead = 0;
+	while (bytesRead != *size) {
+		size_t result = fread(loader->fileBuffer + bytesRead, 1, *size - bytesRead, file);
+		if (result == 0) {
+			return JIIObjStatus::Error;
+		}
+		bytesRead += (u32)result;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// JIIObjParseBuffer with every array coming from the loader
+JIIPrivate JIIObjStatus JIIObjParseWithLoader(JIIObjLoader* loader, JIIObjContext* context) {
+	JIIObjModelData* data = &context->modelData;
+
+	if (context->fileSize != 0) {
+		JIIObjPrepareParse(context);
+	}
+	data->numberOfVertices = data->numberOfFaces * 3;
+
+	loader->positions = (JIIObjPosition*)JIIObjReserveArray(loader->positions, sizeof(JIIObjPosition), &loader->positionsCapacity, (u32)data->numberOfPositions);
+	loader->uvs = (JIIObjUV*)JIIObjReserveArray(loader->uvs, sizeof(JIIObjUV), &loader->uvsCapacity, (u32)data->numberOfUVs);
+	loader->normals = (JIIObjNormal*)JIIObjReserveArray(loader->normals, sizeof(JIIObjNormal), &loader->normalsCapacity, (u32)data->numberOfNormals);
+	loader->vertices = (JIIObjVertex*)JIIObjReserveArray(loader->vertices, sizeof(JIIObjVertex), &loader->verticesCapacity, (u32)data->numberOfVertices);
+	loader->faces = (JIIObjFace*)JIIObjReserveArray(loader->faces, sizeof(JIIObjFace), &loader->facesCapacity, (u32)data->numberOfFaces);
+
+	data->positions = loader->positions;
+	data->uvs = loader->uvs;
+	data->normals = loader->normals;
+	data->vertices = loader->vertices;
+	data->faces = loader->faces;
+
+	if (context->fileSize == 0) {
+		return JIIObjStatus::Eof;
+	}
+
+	// same sizing as JIIObjAllocateVertexTable, only the part this file uses gets cleared
+	u32 maxVertices = (u32)data->numberOfVertices;
+	context->vertexTableSize = 16;
+	while (context->vertexTableSize < maxVertices * 2) {
+		context->vertexTableSize <<= 1;
+	}
+	loader->vertexTable = (u32*)JIIObjReserveArray(loader->vertexTable, sizeof(u32), &loader->vertexTableCapacity, context->vertexTableSize);
+	loader->vertexKeys = (JIIObjVertexKey*)JIIObjReserveArray(loader->vertexKeys, sizeof(JIIObjVertexKey), &loader->vertexKeysCapacity, maxVertices);
+	memset(loader->vertexTable, 0xff, sizeof(u32) * context->vertexTableSize);
+
+	context->vertexTable = loader->vertexTable;
+	context->vertexKeys = loader->vertexKeys;
+
+	return JIIObjParseLines(context);
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadFileWithLoader(JIIObjLoader* loader, FILE* file, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIITraceScope("JIIObjLoadDataWith");
+
+	JIIObjContext context = {};
+	JIIObjStatus status = JIIObjReadLoaderFile(loader, file, &context.fileSize);
+	fclose(file);
+
+	if (status == JIIObjStatus::Ok) {
+		context.fileBuffer = loader->fileBuffer;
+		status = JIIObjParseWithLoader(loader, &context);
+	}
+
+	JIIObjModelData* model = &context.modelData;
+	if (status == JIIObjStatus::Ok || status == JIIObjStatus::Eof) {
+		status = JIIObjAssembleVertices(&context);
+	}
+	if (status == JIIObjStatus::Ok) {
+		model->numberOfFaces = (i32)context.usedFaces;
+		model->numberOfVertices = (i32)context.usedVertices;
+		status = JIIObjFinishLoad(model, context.vertexKeys, options, false);
+	}
+
+	// welding and compacting hand back arrays of their own, those become the loader's from now on
+	if (model->positions != loader->positions) {
+		loader->positions = model->positions;
+		loader->positionsCapacity = (u32)model->numberOfPositions;
+	}
+	if (model->uvs != loader->uvs) {
+		loader->uvs = model->uvs;
+		loader->uvsCapacity = (u32)model->numberOfUVs;
+	}
+	if (model->normals != loader->normals) {
+		loader->normals = model->normals;
+		loader->normalsCapacity = (u32)model->numberOfNormals;
+	}
+	if (model->vertices != loader->vertices) {
+		loader->vertices = model->vertices;
+		loader->verticesCapacity = (u32)model->numberOfVertices;
+	}
+	if (model->faces != loader->faces) {
+		loader->faces = model->faces;
+		loader->facesCapacity = (u32)model->numberOfFaces;
+	}
+
+	if (status != JIIObjStatus::Ok) {
+		*data = {};
+		return status;
+	}
+
+	*data = *model;
+	return JIIObjStatus::Ok;
+}
+
+JIIDef JIIObjLoader* JIIObjCreateLoader() {
+	JIIObjLoader* loader = (JIIObjLoader*)JIIMalloc(sizeof(JIIObjLoader));
+	*loader = {};
+	return loader;
+}
+
+JIIDef void JIIObjDestroyLoader(JIIObjLoader* loader) {
+	if (!loader) {
+		return;
+	}
+
+	JIIFree(loader->fileBuffer);
+	JIIFree(loader->positions);
+	JIIFree(loader->uvs);
+	JIIFree(loader->normals);
+	JIIFree(loader->vertices);
+	JIIFree(loader->faces);
+	JIIFree(loader->vertexKeys);
+	JIIFree(loader->vertexTable);
+	JIIFree(loader);
+}
+
+JIIDef JIIObjStatus JIIObjLoadDataWith(JIIObjLoader* loader, const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(loader && path && data);
+
+	FILE* file = JIIObjOpenFile(path, "rb");
+
+	if (!file) {
+		*data = {};
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjLoadFileWithLoader(loader, file, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadDataWithW(JIIObjLoader* loader, const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(loader && path && data);
+
+	FILE* file = JIIObjOpenFileW(path, L"rb");
+
+	if (!file) {
+		*data = {};
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjLoadFileWithLoader(loader, file, data, options);
+}
+
+// not cryptographic, it only has to notice that a file changed, 4 lanes so the multiplies overlap
+JIIPrivate u64 JIIObjHashBytes(const u8* bytes, u64 size) {
+	const u64 prime0 = 0x9e3779b185ebca87ull;
+	const u64 prime1 = 0xc2b2ae3d27d4eb4full;
+
+	u64 lanes[4] = { prime0 ^ size, prime1, ~prime0, ~prime1 ^ size };
+
+	u64 offset = 0;
+	for (; offset + 32 <= size; offset += 32) {
+		for (u32 lane = 0; lane < 4; ++lane) {
+			u64 word;
+			memcpy(&word, bytes + offset + lane * 8, sizeof(u64));
+			lanes[lane] += word * prime1;
+			lanes[lane] = (lanes[lane] << 31) | (lanes[lane] >> 33);
+			lanes[lane] *= prime0;
+		}
+	}
+
+	u64 hash = lanes[0] ^ ((lanes[1] << 7) | (lanes[1] >> 57)) ^
+		((lanes[2] << 12) | (lanes[2] >> 52)) ^ ((lanes[3] << 18) | (lanes[3] >> 46));
+
+	for (; offset < size; ++offset) {
+		hash = (hash ^ bytes[offset]) * prime0;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+// bounded single producer single consumer queue, chunks are filled and read in place
+struct JIIObjStreamChunk {
+	u8* data;
+	u32 size;
+};
+
+struct JIIObjStreamQueue {
+	JIIObjMonitor monitor;
+
+	JIIObjStreamChunk chunks[JII_OBJ_STREAM_QUEUE_SIZE];
+	u32 chunkCapacity;
+
+	u32 pushed;
+	u32 popped;
+
+	// set by the producer once everything was pushed
+	bool finished;
+	JIIObjStatus status;
+
+	// set by the consumer when it gives up, the producer stops at the next chunk
+	bool cancelled;
+};
+
+JIIPrivate void JIIObjCreateStreamQueue(JIIObjStreamQueue* queue, u32 chunkCapacity) {
+	JIIAssert(queue);
+
+	*queue = {};
+	JIIObjCreateMonitor(&queue->monitor);
+
+	queue->chunkCapacity = chunkCapacity;
+	for (u32 i = 0; i < JII_OBJ_STREAM_QUEUE_SIZE; ++i) {
+		queue->chunks[i].data = (u8*)JIIMalloc(chunkCapacity);
+	}
+}
+
+JIIPrivate void JIIObjDestroyStreamQueue(JIIObjStreamQueue* queue) {
+	JIIAssert(queue);
+
+	for (u32 i = 0; i < JII_OBJ_STREAM_QUEUE_SIZE; ++i) {
+		JIIFree(queue->chunks[i].data);
+	}
+
+	JIIObjDestroyMonitor(&queue->monitor);
+}
+
+// NULL when the consumer gave up, otherwise a chunk nobody else is looking at
+JIIPrivate JIIObjStreamChunk* JIIObjAcquireWriteChunk(JIIObjStreamQueue* queue) {
+	JIIObjLockMonitor(&queue->monitor);
+	while (queue->pushed - queue->popped == JII_OBJ_STREAM_QUEUE_SIZE && !queue->cancelled) {
+		JIIObjWaitMonitor(&queue->monitor);
+	}
+	bool cancelled = queue->cancelled;
+	JIIObjUnlockMonitor(&queue->monitor);
+
+	return cancelled ? NULL : &queue->chunks[queue->pushed % JII_OBJ_STREAM_QUEUE_SIZE];
+}
+
+JIIPrivate void JIIObjPushChunk(JIIObjStreamQueue* queue) {
+	JIIObjLockMonitor(&queue->monitor);
+	++queue->pushed;
+	JIIObjWakeMonitor(&queue->monitor);
+	JIIObjUnlockMonitor(&queue->monitor);
+}
+
+JIIPrivate void JIIObjFinishStream(JIIObjStreamQueue* queue, JIIObjStatus status) {
+	JIIObjLockMonitor(&queue->monitor);
+	queue->finished = true;
+	queue->status = status;
+	JIIObjWakeMonitor(&queue->monitor);
+	JIIObjUnlockMonitor(&queue->monitor);
+}
+
+// NULL once the producer finished and everything was read
+JIIPrivate JIIObjStreamChunk* JIIObjAcquireReadChunk(JIIObjStreamQueue* queue) {
+	JIIObjLockMonitor(&queue->monitor);
+	while (queue->pushed == queue->popped && !queue->finished) {
+		JIIObjWaitMonitor(&queue->monitor);
+	}
+	bool empty = queue->pushed == queue->popped;
+	JIIObjUnlockMonitor(&queue->monitor);
+
+	return empty ? NULL : &queue->chunks[queue->popped % JII_OBJ_STREAM_QUEUE_SIZE];
+}
+
+JIIPrivate void JIIObjPopChunk(JIIObjStreamQueue* queue) {
+	JIIObjLockMonitor(&queue->monitor);
+	++queue->popped;
+	JIIObjWakeMonitor(&queue->monitor);
+	JIIObjUnlockMonitor(&queue->monitor);
+}
+
+JIIPrivate void JIIObjCancelStream(JIIObjStreamQueue* queue) {
+	JIIObjLockMonitor(&queue->monitor);
+	queue->cancelled = true;
+	JIIObjWakeMonitor(&queue->monitor);
+	JIIObjUnlockMonitor(&queue->monitor);
+}
+
+// throws away whatever the producer pushes until it finishes
+JIIPrivate void JIIObjDrainStream(JIIObjStreamQueue* queue) {
+	while (JIIObjAcquireReadChunk(queue)) {
+		JIIObjPopChunk(queue);
+	}
+}
+
+JIIPrivate void* JIIObjGrowArray(void* array, u32 elementSize, u32* capacity, u32 needed) {
+	if (needed <= *capacity) {
+		return array;
+	}
+
+	u32 newCapacity = *capacity ? *capacity : 256;
+	while (newCapacity < needed) {
+		newCapacity *= 2;
+	}
+
+	void* result = JIIMalloc((size_t)elementSize * newCapacity);
+	if (array) {
+		memcpy(result, array, (size_t)elementSize * *capacity);
+		JIIFree(array);
+	}
+
+	*capacity = newCapacity;
+	return result;
+}
+
+JIIPrivate void JIIObjRehashVertexTable(JIIObjContext* context, u32 tableSize) {
+	JIIFree(context->vertexTable);
+
+	context->vertexTableSize = tableSize;
+	context->vertexTable = (u32*)JIIMalloc(sizeof(u32) * tableSize);
+	memset(context->vertexTable, 0xff, sizeof(u32) * tableSize);
+
+	u32 mask = tableSize - 1;
+	for (u32 i = 0; i < context->usedVertices; ++i) {
+		u32 slot = JIIObjHashVertexKey(&context->vertexKeys[i]) & mask;
+		while (context->vertexTable[slot] != UINT32_MAX) {
+			slot = (slot + 1) & mask;
+		}
+		context->vertexTable[slot] = i;
+	}
+}
+
+// makes sure whatever this line adds fits, a line is one attribute or a face of at most lineSize / 2 corners
+JIIPrivate void JIIObjReserveStreamLine(JIIObjContext* context, u32 lineSize) {
+	JIIObjModelData* data = &context->modelData;
+	u32 corners = lineSize / 2 + 1;
+
+	data->positions = (JIIObjPosition*)JIIObjGrowArray(data->positions, sizeof(JIIObjPosition), &context->positionsCapacity, context->usedPositions + 1);
+	data->uvs = (JIIObjUV*)JIIObjGrowArray(data->uvs, sizeof(JIIObjUV), &context->uvsCapacity, context->usedUVs + 1);
+	data->normals = (JIIObjNormal*)JIIObjGrowArray(data->normals, sizeof(JIIObjNormal), &context->normalsCapacity, context->usedNormals + 1);
+	data->faces = (JIIObjFace*)JIIObjGrowArray(data->faces, sizeof(JIIObjFace), &context->facesCapacity, context->usedFaces + corners);
+
+	if (context->usedVertices + corners > context->verticesCapacity) {
+		u32 keysCapacity = context->verticesCapacity;
+		context->vertexKeys = (JIIObjVertexKey*)JIIObjGrowArray(context->vertexKeys, sizeof(JIIObjVertexKey), &keysCapacity, context->usedVertices + corners);
+		data->vertices = (JIIObjVertex*)JIIObjGrowArray(data->vertices, sizeof(JIIObjVertex), &context->verticesCapacity, context->usedVertices + corners);
+
+		// keep the table at most half full
+		u32 tableSize = context->vertexTableSize ? context->vertexTableSize : 16;
+		while (tableSize < context->verticesCapacity * 2) {
+			tableSize <<= 1;
+		}
+		if (tableSize != context->vertexTableSize) {
+			JIIObjRehashVertexTable(context, tableSize);
+		}
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjParseStreamLine(JIIObjContext* context, u8* line, u32 lineSize) {
+	if (lineSize && line[lineSize - 1] == '\r') {
+		--lineSize;
+	}
+
+	if (lineSize == 0) {
+		return JIIObjStatus::Ok;
+	}
+
+	// same limit JIIObjParseLines has, the chunks themselves would take any length
+	if (lineSize > JII_OBJ_MAX_LINE) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	JIIObjReserveStreamLine(context, lineSize);
+	return JIIObjParseLine(context, line, lineSize);
+}
+
+// parses chunks as the producer pushes them, the arrays grow since nothing was peeked
+JIIPrivate JIIObjStatus JIIObjParseStream(JIIObjContext* context, JIIObjStreamQueue* queue) {
+	JIIAssert(context && queue);
+	JIITraceScope("JIIObjParseStream");
+
+	// there is no peek so there is no way to know if all faces look the same
+	context->faceParser = JIIObjParseFace;
+
+	// lines split between two chunks get glued together here, one more byte for the \r
+	u8 carry[JII_OBJ_MAX_LINE + 1];
+	u32 carrySize = 0;
+	// a comment that goes on in the next chunk
+	bool skippingComment = false;
+
+	JIIObjStreamChunk* chunk;
+	while ((chunk = JIIObjAcquireReadChunk(queue))) {
+		u8* cursor = chunk->data;
+		u8* end = chunk->data + chunk->size;
+
+		while (cursor < end) {
+			u8* newline = (u8*)memchr(cursor, '\n', end - cursor);
+			u8* lineEnd = newline ? newline : end;
+			u32 lineSize = (u32)(lineEnd - cursor);
+
+			// nothing carried means this is the start of a line, comments are skipped like JIIObjReadLine does
+			if (skippingComment || (!carrySize && *cursor == '#')) {
+				skippingComment = !newline;
+				cursor = newline ? newline + 1 : end;
+				continue;
+			}
+
+			JIIObjStatus status = JIIObjStatus::Ok;
+			if (carrySize || !newline) {
+				// the line started in the previous chunk or goes on in the next one
+				if (carrySize + lineSize > sizeof(carry)) {
+					JIIObjPopChunk(queue);
+					return JIIObjStatus::OutOfSpace;
+				}
+
+				memcpy(carry + carrySize, cursor, lineSize);
+				carrySize += lineSize;
+				if (newline) {
+					status = JIIObjParseStreamLine(context, carry, carrySize);
+					carrySize = 0;
+				}
+			}
+			else {
+				status = JIIObjParseStreamLine(context, cursor, lineSize);
+			}
+
+			if (status != JIIObjStatus::Ok) {
+				JIIObjPopChunk(queue);
+				return status;
+			}
+
+			cursor = newline ? newline + 1 : end;
+		}
+
+		JIIObjPopChunk(queue);
+	}
+
+	JIIObjLockMonitor(&queue->monitor);
+	JIIObjStatus status = queue->status;
+	JIIObjUnlockMonitor(&queue->monitor);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	// the last line doesn't need a line end
+	return JIIObjParseStreamLine(context, carry, carrySize);
+}
+
+// parses everything the producer thread pushes into the queue, the producer is stopped on errors unless
+// it checks the data itself (the gzip crc), corrupt data trips the parser before the check and it is
+// the producer's Error that has to come back then, not whatever the parser made of the garbage
+JIIPrivate JIIObjStatus JIIObjLoadFromStream(JIIObjStreamQueue* queue, JIIObjThread* producer, bool producerChecks, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(queue && producer && data);
+
+	JIIObjContext context = {};
+	JIIObjStatus status = JIIObjParseStream(&context, queue);
+	if (status != JIIObjStatus::Ok) {
+		if (producerChecks) {
+			JIIObjDrainStream(queue);
+		}
+		else {
+			JIIObjCancelStream(queue);
+		}
+	}
+	JIIObjJoinThread(producer);
+
+	// joined, nobody else touches the queue
+	if (status != JIIObjStatus::Ok && queue->status != JIIObjStatus::Ok) {
+		status = queue->status;
+	}
+
+	JIIObjModelData* model = &context.modelData;
+	if (status == JIIObjStatus::Ok) {
+		// same shape the peeked path leaves things in, vertices get trimmed by the finish
+		model->positions = (JIIObjPosition*)JIIObjShrinkArray(model->positions, sizeof(JIIObjPosition), context.positionsCapacity, context.usedPositions);
+		model->uvs = (JIIObjUV*)JIIObjShrinkArray(model->uvs, sizeof(JIIObjUV), context.uvsCapacity, context.usedUVs);
+		model->normals = (JIIObjNormal*)JIIObjShrinkArray(model->normals, sizeof(JIIObjNormal), context.normalsCapacity, context.usedNormals);
+		model->faces = (JIIObjFace*)JIIObjShrinkArray(model->faces, sizeof(JIIObjFace), context.facesCapacity, context.usedFaces);
+		model->numberOfPositions = (i32)context.usedPositions;
+		model->numberOfUVs = (i32)context.usedUVs;
+		model->numberOfNormals = (i32)context.usedNormals;
+		model->numberOfVertices = (i32)context.verticesCapacity;
+
+		status = JIIObjFinishModelData(&context, options);
+	}
+
+	if (status != JIIObjStatus::Ok) {
+		JIIObjFreeContextScratch(&context);
+		JIIObjFreeData(model);
+		*data = {};
+		return status;
+	}
+
+	*data = *model;
+	return JIIObjStatus::Ok;
+}
+
+// inflate (RFC 1951) inside a gzip (RFC 1952) wrapper
+#define JII_OBJ_HUFFMAN_FAST_BITS 10
+#define JII_OBJ_HUFFMAN_FAST_MASK ((1 << JII_OBJ_HUFFMAN_FAST_BITS) - 1)
+// has to hold the 32k of history plus a whole chunk that wasn't pushed yet and a match
+#define JII_OBJ_INFLATE_WINDOW_SIZE (1 << 17)
+#define JII_OBJ_INFLATE_MAX_MATCH 258
+
+// fast entries are (length << 9) | symbol, 0 means the code is longer than the fast bits
+struct JIIObjHuffman {
+	u16 fast[1 << JII_OBJ_HUFFMAN_FAST_BITS];
+	u16 firstCode[16];
+	u32 maxCode[17];
+	u16 firstSymbol[16];
+	u8 size[288];
+	u16 value[288];
+};
+
+struct JIIObjInflate {
+	const u8* input;
+	const u8* inputEnd;
+
+	u64 bits;
+	u32 bitCount;
+	// zeros fed in after the end of the input, using any of them means the input was cut short
+	u32 padding;
+
+	u8* window;
+	u64 out;
+	u64 pushed;
+
+	u32 crc;
+	u32 crcTable[256];
+
+	JIIObjStreamQueue* queue;
+
+	JIIObjHuffman literals;
+	JIIObjHuffman distances;
+};
+
+JIIPrivate const u16 jii_ObjInflateLengthBase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+JIIPrivate const u8 jii_ObjInflateLengthExtra[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+JIIPrivate const u16 jii_ObjInflateDistanceBase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+JIIPrivate const u8 jii_ObjInflateDistanceExtra[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+JIIPrivate const u8 jii_ObjInflateCodeLengthOrder[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+JIIPrivate u32 JIIObjReverseBits(u32 bits, u32 count) {
+	bits = ((bits & 0xaaaa) >> 1) | ((bits & 0x5555) << 1);
+	bits = ((bits & 0xcccc) >> 2) | ((bits & 0x3333) << 2);
+	bits = ((bits & 0xf0f0) >> 4) | ((bits & 0x0f0f) << 4);
+	bits = ((bits & 0xff00) >> 8) | ((bits & 0x00ff) << 8);
+	return bits >> (16 - count);
+}
+
+// canonical huffman codes from their lengths, incomplete codes are fine, oversubscribed ones are not
+JIIPrivate bool JIIObjBuildHuffman(JIIObjHuffman* huffman, const u8* lengths, u32 count) {
+	u32 sizes[17] = {};
+	memset(huffman->fast, 0, sizeof(huffman->fast));
+
+	for (u32 i = 0; i < count; ++i) {
+		++sizes[lengths[i]];
+	}
+	sizes[0] = 0;
+
+	for (u32 i = 1; i < 16; ++i) {
+		if (sizes[i] > (1u << i)) {
+			return false;
+		}
+	}
+
+	u32 nextCode[16];
+	u32 code = 0;
+	u32 symbol = 0;
+	for (u32 i = 1; i < 16; ++i) {
+		nextCode[i] = code;
+		huffman->firstCode[i] = (u16)code;
+		huffman->firstSymbol[i] = (u16)symbol;
+		code += sizes[i];
+		if (sizes[i] && code - 1 >= (1u << i)) {
+			return false;
+		}
+		// shifted up so the slow path can compare against 16 reversed bits
+		huffman->maxCode[i] = code << (16 - i);
+		code <<= 1;
+		symbol += sizes[i];
+	}
+	huffman->maxCode[16] = 0x10000;
+
+	for (u32 i = 0; i < count; ++i) {
+		u32 length = lengths[i];
+		if (!length) {
+			continue;
+		}
+
+		u32 slot = nextCode[length] - huffman->firstCode[length] + huffman->firstSymbol[length];
+		huffman->size[slot] = (u8)length;
+		huffman->value[slot] = (u16)i;
+
+		if (length <= JII_OBJ_HUFFMAN_FAST_BITS) {
+			u16 entry = (u16)((length << 9) | i);
+			for (u32 j = JIIObjReverseBits(nextCode[length], length); j < (1 << JII_OBJ_HUFFMAN_FAST_BITS); j += (1 << length)) {
+				huffman->fast[j] = entry;
+			}
+		}
+
+		++nextCode[length];
+	}
+
+	return true;
+}
+
+JIIPrivate void JIIObjRefillBits(JIIObjInflate* inflate) {
+	while (inflate->bitCount <= 56) {
+		u64 byte = 0;
+		if (inflate->input < inflate->inputEnd) {
+			byte = *inflate->input++;
+		}
+		else {
+			++inflate->padding;
+		}
+		inflate->bits |= byte << inflate->bitCount;
+		inflate->bitCount += 8;
+	}
+}
+
+JIIPrivate u32 JIIObjReadBits(JIIObjInflate* inflate, u32 count) {
+	if (inflate->bitCount < count) {
+		JIIObjRefillBits(inflate);
+	}
+
+	u32 value = (u32)(inflate->bits & ((1ull << count) - 1));
+	inflate->bits >>= count;
+	inflate->bitCount -= count;
+	return value;
+}
+
+// drops the bits up to the next byte and gives the whole bytes still sitting in the bit buffer back
+// to the input, false when bytes past the end of the input were already used
+JIIPrivate bool JIIObjAlignInflateInput(JIIObjInflate* inflate) {
+	inflate->bits >>= inflate->bitCount & 7;
+	inflate->bitCount &= ~7u;
+
+	u32 buffered = inflate->bitCount / 8;
+	if (inflate->padding > buffered) {
+		return false;
+	}
+
+	inflate->input -= buffered - inflate->padding;
+	inflate->bits = 0;
+	inflate->bitCount = 0;
+	inflate->padding = 0;
+	return true;
+}
+
+JIIPrivate i32 JIIObjDecodeSymbol(JIIObjInflate* inflate, JIIObjHuffman* huffman) {
+	if (inflate->bitCount < 16) {
+		JIIObjRefillBits(inflate);
+	}
+
+	u32 entry = huffman->fast[inflate->bits & JII_OBJ_HUFFMAN_FAST_MASK];
+	if (entry) {
+		u32 length = entry >> 9;
+		inflate->bits >>= length;
+		inflate->bitCount -= length;
+		return (i32)(entry & 511);
+	}
+
+	u32 reversed = JIIObjReverseBits((u32)(inflate->bits & 0xffff), 16);
+	u32 length = JII_OBJ_HUFFMAN_FAST_BITS + 1;
+	while (length < 16 && reversed >= huffman->maxCode[length]) {
+		++length;
+	}
+	if (length >= 16) {
+		return -1;
+	}
+
+	u32 slot = (reversed >> (16 - length)) - huffman->firstCode[length] + huffman->firstSymbol[length];
+	if (slot >= 288 || huffman->size[slot] != length) {
+		return -1;
+	}
+
+	inflate->bits >>= length;
+	inflate->bitCount -= length;
+	return huffman->value[slot];
+}
+
+// hands everything that wasn't pushed yet to the parser, false when the parser gave up
+JIIPrivate bool JIIObjPushInflated(JIIObjInflate* inflate) {
+	while (inflate->pushed < inflate->out) {
+		JIIObjStreamChunk* chunk = JIIObjAcquireWriteChunk(inflate->queue);
+		if (!chunk) {
+			return false;
+		}
+
+		u64 size = inflate->out - inflate->pushed;
+		if (size > inflate->queue->chunkCapacity) {
+			size = inflate->queue->chunkCapacity;
+		}
+
+		// the window wraps around so this is one or two copies
+		u32 begin = (u32)(inflate->pushed & (JII_OBJ_INFLATE_WINDOW_SIZE - 1));
+		u32 first = JII_OBJ_INFLATE_WINDOW_SIZE - begin;
+		if (first > size) {
+			first = (u32)size;
+		}
+		memcpy(chunk->data, inflate->window + begin, first);
+		memcpy(chunk->data + first, inflate->window, (size_t)(size - first));
+		chunk->size = (u32)size;
+
+		u32 crc = inflate->crc;
+		for (u32 i = 0; i < chunk->size; ++i) {
+			crc = inflate->crcTable[(crc ^ chunk->data[i]) & 0xff] ^ (crc >> 8);
+		}
+		inflate->crc = crc;
+
+		inflate->pushed += size;
+		JIIObjPushChunk(inflate->queue);
+	}
+
+	return true;
+}
+
+JIIPrivate JIIObjStatus JIIObjInflateCompressedBlock(JIIObjInflate* inflate) {
+	u8* window = inflate->window;
+	const u64 mask = JII_OBJ_INFLATE_WINDOW_SIZE - 1;
+	const u64 chunkSize = JII_OBJ_STREAM_CHUNK_SIZE;
+
+	while (true) {
+		i32 symbol = JIIObjDecodeSymbol(inflate, &inflate->literals);
+		if (symbol < 0) {
+			return JIIObjStatus::Error;
+		}
+
+		if (symbol < 256) {
+			window[inflate->out++ & mask] = (u8)symbol;
+		}
+		else if (symbol == 256) {
+			return JIIObjStatus::Ok;
+		}
+		else {
+			symbol -= 257;
+			if (symbol >= 29) {
+				return JIIObjStatus::Error;
+			}
+			u32 length = jii_ObjInflateLengthBase[symbol] + JIIObjReadBits(inflate, jii_ObjInflateLengthExtra[symbol]);
+
+			i32 distanceSymbol = JIIObjDecodeSymbol(inflate, &inflate->distances);
+			if (distanceSymbol < 0 || distanceSymbol >= 30) {
+				return JIIObjStatus::Error;
+			}
+			u32 distance = jii_ObjInflateDistanceBase[distanceSymbol] + JIIObjReadBits(inflate, jii_ObjInflateDistanceExtra[distanceSymbol]);
+			if (distance > inflate->out) {
+				return JIIObjStatus::Error;
+			}
+
+			u64 out = inflate->out;
+			for (u32 i = 0; i < length; ++i, ++out) {
+				window[out & mask] = window[(out - distance) & mask];
+			}
+			inflate->out = out;
+		}
+
+		if (inflate->out - inflate->pushed >= chunkSize) {
+			// a cut short file would otherwise keep decoding the zeros past its end
+			if (inflate->padding * 8 > inflate->bitCount || !JIIObjPushInflated(inflate)) {
+				return JIIObjStatus::Error;
+			}
+		}
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjInflateStoredBlock(JIIObjInflate* inflate) {
+	if (!JIIObjAlignInflateInput(inflate) || inflate->inputEnd - inflate->input < 4) {
+		return JIIObjStatus::Error;
+	}
+
+	u32 length = inflate->input[0] | (inflate->input[1] << 8);
+	u32 check = inflate->input[2] | (inflate->input[3] << 8);
+	inflate->input += 4;
+	if ((length ^ 0xffff) != check || (u64)(inflate->inputEnd - inflate->input) < length) {
+		return JIIObjStatus::Error;
+	}
+
+	const u64 mask = JII_OBJ_INFLATE_WINDOW_SIZE - 1;
+	while (length) {
+		// never more than a chunk ahead of what was pushed, the window can't hold more
+		u64 room = JII_OBJ_STREAM_CHUNK_SIZE - (inflate->out - inflate->pushed);
+		u32 size = length < room ? length : (u32)room;
+		for (u32 i = 0; i < size; ++i) {
+			inflate->window[(inflate->out + i) & mask] = inflate->input[i];
+		}
+		inflate->out += size;
+		inflate->input += size;
+		length -= size;
+
+		if (inflate->out - inflate->pushed >= JII_OBJ_STREAM_CHUNK_SIZE && !JIIObjPushInflated(inflate)) {
+			return JIIObjStatus::Error;
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjReadDynamicHuffman(JIIObjInflate* inflate) {
+	u32 literalCount = JIIObjReadBits(inflate, 5) + 257;
+	u32 distanceCount = JIIObjReadBits(inflate, 5) + 1;
+	u32 codeLengthCount = JIIObjReadBits(inflate, 4) + 4;
+	if (literalCount > 286 || distanceCount > 30) {
+		return JIIObjStatus::Error;
+	}
+
+	u8 codeLengths[19] = {};
+	for (u32 i = 0; i < codeLengthCount; ++i) {
+		codeLengths[jii_ObjInflateCodeLengthOrder[i]] = (u8)JIIObjReadBits(inflate, 3);
+	}
+
+	JIIObjHuffman* codeLengthHuffman = &inflate->distances;
+	if (!JIIObjBuildHuffman(codeLengthHuffman, codeLengths, 19)) {
+		return JIIObjStatus::Error;
+	}
+
+	u8 lengths[286 + 30];
+	u32 count = 0;
+	u32 total = literalCount + distanceCount;
+	while (count < total) {
+		i32 symbol = JIIObjDecodeSymbol(inflate, codeLengthHuffman);
+		if (symbol < 0) {
+			return JIIObjStatus::Error;
+		}
+
+		if (symbol < 16) {
+			lengths[count++] = (u8)symbol;
+			continue;
+		}
+
+		u8 value = 0;
+		u32 repeat;
+		if (symbol == 16) {
+			if (count == 0) {
+				return JIIObjStatus::Error;
+			}
+			value = lengths[count - 1];
+			repeat = 3 + JIIObjReadBits(inflate, 2);
+		}
+		else if (symbol == 17) {
+			repeat = 3 + JIIObjReadBits(inflate, 3);
+		}
+		else {
+			repeat = 11 + JIIObjReadBits(inflate, 7);
+		}
+
+		if (count + repeat > total) {
+			return JIIObjStatus::Error;
+		}
+		memset(lengths + count, value, repeat);
+		count += repeat;
+	}
+
+	if (!lengths[256] ||
+		!JIIObjBuildHuffman(&inflate->literals, lengths, literalCount) ||
+		!JIIObjBuildHuffman(&inflate->distances, lengths + literalCount, distanceCount)) {
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate void JIIObjBuildFixedHuffman(JIIObjInflate* inflate) {
+	u8 lengths[288];
+	memset(lengths, 8, 144);
+	memset(lengths + 144, 9, 112);
+	memset(lengths + 256, 7, 24);
+	memset(lengths + 280, 8, 8);
+	JIIObjBuildHuffman(&inflate->literals, lengths, 288);
+
+	memset(lengths, 5, 32);
+	JIIObjBuildHuffman(&inflate->distances, lengths, 32);
+}
+
+JIIPrivate JIIObjStatus JIIObjInflateMember(JIIObjInflate* inflate) {
+	u32 last;
+	do {
+		last = JIIObjReadBits(inflate, 1);
+		u32 type = JIIObjReadBits(inflate, 2);
+
+		JIIObjStatus status;
+		switch (type) {
+			case 0: {
+				status = JIIObjInflateStoredBlock(inflate);
+				break;
+			}
+			case 1: {
+				JIIObjBuildFixedHuffman(inflate);
+				status = JIIObjInflateCompressedBlock(inflate);
+				break;
+			}
+			case 2: {
+				status = JIIObjReadDynamicHuffman(inflate);
+				if (status == JIIObjStatus::Ok) {
+					status = JIIObjInflateCompressedBlock(inflate);
+				}
+				break;
+			}
+			default: {
+				status = JIIObjStatus::Error;
+				break;
+			}
+		}
+
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+	} while (!last);
+
+	if (!JIIObjAlignInflateInput(inflate)) {
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjPushInflated(inflate) ? JIIObjStatus::Ok : JIIObjStatus::Error;
+}
+
+JIIPrivate const u8* JIIObjSkipGzipString(const u8* cursor, const u8* end) {
+	while (cursor < end && *cursor) {
+		++cursor;
+	}
+	return cursor < end ? cursor + 1 : NULL;
+}
+
+JIIPrivate JIIObjStatus JIIObjInflateGzip(JIIObjInflate* inflate) {
+	JIITraceScope("JIIObjInflateGzip");
+
+	for (u32 i = 0; i < 256; ++i) {
+		u32 crc = i;
+		for (u32 bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+		}
+		inflate->crcTable[i] = crc;
+	}
+
+	// gzip files can be several members glued together
+	do {
+		const u8* cursor = inflate->input;
+		const u8* end = inflate->inputEnd;
+		if (end - cursor < 18 || cursor[0] != 0x1f || cursor[1] != 0x8b || cursor[2] != 8) {
+			return JIIObjStatus::Error;
+		}
+
+		u8 flags = cursor[3];
+		cursor += 10;
+
+		// FEXTRA
+		if (flags & 4) {
+			if (end - cursor < 2) {
+				return JIIObjStatus::Error;
+			}
+			u32 extraLength = cursor[0] | (cursor[1] << 8);
+			cursor += 2;
+			if ((u64)(end - cursor) < extraLength) {
+				return JIIObjStatus::Error;
+			}
+			cursor += extraLength;
+		}
+		// FNAME
+		if (cursor && (flags & 8)) {
+			cursor = JIIObjSkipGzipString(cursor, end);
+		}
+		// FCOMMENT
+		if (cursor && (flags & 16)) {
+			cursor = JIIObjSkipGzipString(cursor, end);
+		}
+		// FHCRC
+		if (cursor && (flags & 2)) {
+			cursor = end - cursor >= 2 ? cursor + 2 : NULL;
+		}
+		if (!cursor) {
+			return JIIObjStatus::Error;
+		}
+
+		inflate->input = cursor;
+		inflate->crc = 0xffffffffu;
+		u64 memberStart = inflate->out;
+
+		JIIObjStatus status = JIIObjInflateMember(inflate);
+		if (status != JIIObjStatus::Ok) {
+			return status;
+		}
+
+		if (inflate->inputEnd - inflate->input < 8) {
+			return JIIObjStatus::Error;
+		}
+
+		const u8* trailer = inflate->input;
+		u32 crc = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((u32)trailer[3] << 24);
+		u32 size = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | ((u32)trailer[7] << 24);
+		if (crc != (inflate->crc ^ 0xffffffffu) || size != (u32)(inflate->out - memberStart)) {
+			return JIIObjStatus::Error;
+		}
+		inflate->input += 8;
+	} while (inflate->input < inflate->inputEnd);
+
+	return JIIObjStatus::Ok;
+}
+
+struct JIIObjInflateTask {
+	JIIObjFileMapping mapping;
+	JIIObjStreamQueue queue;
+	JIIObjInflate* inflate;
+};
+
+JIIPrivate void JIIObjInflateProc(void* data) {
+	JIIObjInflateTask* task = (JIIObjInflateTask*)data;
+
+	JIIObjInflate* inflate = task->inflate;
+	inflate->input = task->mapping.data;
+	inflate->inputEnd = task->mapping.data + task->mapping.size;
+	inflate->queue = &task->queue;
+
+	JIIObjFinishStream(&task->queue, JIIObjInflateGzip(inflate));
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadGzipMapping(JIIObjInflateTask* task, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIITraceScope("JIIObjLoadGzip");
+
+	// huffman tables and the window are too big for a thread stack
+	JIIObjInflate* inflate = (JIIObjInflate*)JIIMalloc(sizeof(JIIObjInflate));
+	*inflate = {};
+	inflate->window = (u8*)JIIMalloc(JII_OBJ_INFLATE_WINDOW_SIZE);
+	task->inflate = inflate;
+
+	// a chunk can run past the chunk size by at most one match
+	JIIObjCreateStreamQueue(&task->queue, JII_OBJ_STREAM_CHUNK_SIZE + JII_OBJ_INFLATE_MAX_MATCH);
+
+	JIIObjStatus status;
+	JIIObjThread thread;
+	if (JIIObjCreateThread(&thread, JIIObjInflateProc, task)) {
+		status = JIIObjLoadFromStream(&task->queue, &thread, true, data, options);
+	}
+	else {
+		*data = {};
+		status = JIIObjStatus::Error;
+	}
+
+	JIIObjDestroyStreamQueue(&task->queue);
+	JIIFree(inflate->window);
+	JIIFree(inflate);
+	JIIObjUnmapFile(&task->mapping);
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjLoadGzip(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjInflateTask task;
+	JIIObjStatus status = JIIObjMapFile(path, &task.mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	return JIIObjLoadGzipMapping(&task, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadGzipW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjInflateTask task;
+	JIIObjStatus status = JIIObjMapFileW(path, &task.mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	return JIIObjLoadGzipMapping(&task, data, options);
+}
+
+struct JIIObjReadTask {
+	FILE* file;
+	JIIObjStreamQueue queue;
+};
+
+JIIPrivate void JIIObjReadProc(void* data) {
+	JIIObjReadTask* task = (JIIObjReadTask*)data;
+	JIIObjStatus status = JIIObjStatus::Ok;
+
+	JIIObjStreamChunk* chunk;
+	while ((chunk = JIIObjAcquireWriteChunk(&task->queue))) {
+		chunk->size = (u32)fread(chunk->data, 1, task->queue.chunkCapacity, task->file);
+		if (chunk->size == 0) {
+			if (ferror(task->file)) {
+				status = JIIObjStatus::Error;
+			}
+			break;
+		}
+
+		JIIObjPushChunk(&task->queue);
+	}
+
+	JIIObjFinishStream(&task->queue, status);
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadPipelinedFile(JIIObjReadTask* task, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIITraceScope("JIIObjLoadDataPipelined");
+
+	// the chunks are big enough already, stdio buffering would only add a copy
+	setvbuf(task->file, NULL, _IONBF, 0);
+#if !defined(_WIN32) && !defined(_WIN64)
+	posix_fadvise(fileno(task->file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	JIIObjCreateStreamQueue(&task->queue, JII_OBJ_PIPELINE_CHUNK_SIZE);
+
+	JIIObjStatus status;
+	JIIObjThread thread;
+	if (JIIObjCreateThread(&thread, JIIObjReadProc, task)) {
+		status = JIIObjLoadFromStream(&task->queue, &thread, false, data, options);
+	}
+	else {
+		*data = {};
+		status = JIIObjStatus::Error;
+	}
+
+	JIIObjDestroyStreamQueue(&task->queue);
+	fclose(task->file);
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjLoadDataPipelined(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjReadTask task;
+	task.file = JIIObjOpenFile(path, "rb");
+	if (!task.file) {
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjLoadPipelinedFile(&task, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadDataPipelinedW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
+
+	JIIObjReadTask task;
+	task.file = JIIObjOpenFileW(path, L"rb");
+	if (!task.file) {
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjLoadPipelinedFile(&task, data, options);
+}
+
+struct JIIObjBatchFile {
+	const char* path;
+	u8* buffer;
+	u64 size;
+	JIIObjStatus status;
+
+#if defined(JII_OBJ_IO_URING)
+	int file;
+	// the next byte that still has to be asked for
+	u64 requested;
+	u32 readsInFlight;
+	bool ready;
+#endif
+};
+
+// files come out of the reads in whatever order they finish and get claimed by the parsers in that order
+struct JIIObjBatch {
+	JIIObjBatchFile* files;
+	u32 numberOfFiles;
+
+	JIIObjModelData* models;
+	JIIObjStatus* statuses;
+	JIIObjLoadOptions* options;
+
+	JIIObjMonitor monitor;
+	u32* ready;
+	u32 numberOfReady;
+
+	// the next spot in ready (or the next file for the pread pool) somebody is going to take
+	u32 claimed;
+};
+
+JIIPrivate void JIIObjParseBatchFile(JIIObjBatch* batch, u32 index) {
+	JIIObjBatchFile* file = &batch->files[index];
+
+	JIIObjStatus status = file->status;
+	if (status == JIIObjStatus::Ok && file->size > UINT32_MAX) {
+		status = JIIObjStatus::OutOfSpace;
+	}
+
+	if (status != JIIObjStatus::Ok) {
+		JIIFree(file->buffer);
+		batch->models[index] = {};
+		batch->statuses[index] = status;
+		return;
+	}
+
+	// weldedPositions and compactedBytes are per file, sharing the options would race
+	JIIObjLoadOptions options = {};
+	if (batch->options) {
+		options = *batch->options;
+	}
+
+	JIIObjContext context = {};
+	context.fileBuffer = file->buffer;
+	context.fileSize = (u32)file->size;
+	batch->statuses[index] = JIIObjLoadFromContext(&context, &batch->models[index], &options);
+}
+
+// reads a whole file with plain blocking calls
+JIIPrivate void JIIObjReadBatchFile(JIIObjBatchFile* file) {
+#if defined(_WIN32) || defined(_WIN64)
+	u32 size;
+	file->status = JIIObjReadFile(file->path, &file->buffer, &size);
+	file->size = size;
+#else
+	file->status = JIIObjStatus::Error;
+
+	int handle = open(file->path, O_RDONLY | O_CLOEXEC);
+	if (handle < 0) {
+		return;
+	}
+
+	struct stat info;
+	if (fstat(handle, &info) == 0) {
+		file->size = (u64)info.st_size;
+		file->buffer = (u8*)JIIMalloc(file->size ? file->size : 1);
+		if (!file->buffer) {
+			file->status = JIIObjStatus::OutOfSpace;
+			close(handle);
+			return;
+		}
+
+		u64 offset = 0;
+		while (offset < file->size) {
+			ssize_t result = pread(handle, file->buffer + offset, file->size - offset, (off_t)offset);
+			if (result <= 0) {
+				break;
+			}
+			offset += (u64)result;
+		}
+
+		if (offset == file->size) {
+			file->status = JIIObjStatus::Ok;
+		}
+	}
+
+	close(handle);
+#endif
+}
+
+// the fallback, every thread takes the next file, reads it and parses it right away
+JIIPrivate void JIIObjBatchReaderProc(void* data, u32 begin, u32 end) {
+	JIIObjBatch* batch = (JIIObjBatch*)data;
+	(void)begin;
+	(void)end;
+
+	while (true) {
+		u32 index = JIIObjAtomicAdd32(&batch->claimed, 1);
+		if (index >= batch->numberOfFiles) {
+			return;
+		}
+
+		JIIObjReadBatchFile(&batch->files[index]);
+		JIIObjParseBatchFile(batch, index);
+	}
+}
+
+#if defined(JII_OBJ_IO_URING)
+#ifndef JII_OBJ_IO_RING_SIZE
+// submission queue entries, the kernel makes the completion queue twice as big so it never overflows
+#define JII_OBJ_IO_RING_SIZE 64
+#endif
+
+#ifndef JII_OBJ_IO_BUFFER_SIZE
+// reads land in registered buffers of this size, bigger files take several reads
+#define JII_OBJ_IO_BUFFER_SIZE (1 << 20)
+#endif
+
+#ifndef JII_OBJ_IO_BUFFER_COUNT
+#define JII_OBJ_IO_BUFFER_COUNT 16
+#endif
+
+// the high half of user_data, the low half is the file for opens and the buffer for reads
+#define JII_OBJ_IO_OPEN 1ull
+#define JII_OBJ_IO_READ 2ull
+
+struct JIIObjIORing {
+	int ring;
+
+	u8* submissionRing;
+	u64 submissionRingSize;
+	u8* completionRing;
+	u64 completionRingSize;
+
+	u32* submissionTail;
+	// entries are filled in past the shared tail, it only moves on submit
+	u32 tail;
+	u32 submissionMask;
+	u32* submissionArray;
+	io_uring_sqe* entries;
+	u32 numberOfEntries;
+
+	u32* completionHead;
+	u32* completionTail;
+	u32 completionMask;
+	io_uring_cqe* completions;
+
+	// queued but not handed to the kernel yet
+	u32 unsubmitted;
+	// handed to the kernel and not completed yet
+	u32 inFlight;
+};
+
+struct JIIObjIOBuffer {
+	u32 file;
+	u32 size;
+	u64 offset;
+};
+
+JIIPrivate void JIIObjDestroyIORing(JIIObjIORing* ring) {
+	if (ring->entries) {
+		munmap(ring->entries, sizeof(io_uring_sqe) * ring->numberOfEntries);
+	}
+	if (ring->completionRing && ring->completionRing != ring->submissionRing) {
+		munmap(ring->completionRing, ring->completionRingSize);
+	}
+	if (ring->submissionRing) {
+		munmap(ring->submissionRing, ring->submissionRingSize);
+	}
+	close(ring->ring);
+	*ring = {};
+}
+
+// false when the kernel doesn't have io_uring (or not the parts we need), the caller falls back to pread
+JIIPrivate bool JIIObjCreateIORing(JIIObjIORing* ring, u8* buffers) {
+	*ring = {};
+
+	io_uring_params params = {};
+	ring->ring = (int)syscall(__NR_io_uring_setup, JII_OBJ_IO_RING_SIZE, &params);
+	if (ring->ring < 0) {
+		return false;
+	}
+
+	// openat and read_fixed showed up in different kernels, ask instead of guessing from the version
+	u8 probeMemory[sizeof(io_uring_probe) + sizeof(io_uring_probe_op) * 256] = {};
+	io_uring_probe* probe = (io_uring_probe*)probeMemory;
+	if (syscall(__NR_io_uring_register, ring->ring, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+		probe->last_op < IORING_OP_OPENAT ||
+		!(probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) ||
+		!(probe->ops[IORING_OP_READ_FIXED].flags & IO_URING_OP_SUPPORTED)) {
+		close(ring->ring);
+		return false;
+	}
+
+	ring->submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+	ring->completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMapping && ring->completionRingSize > ring->submissionRingSize) {
+		ring->submissionRingSize = ring->completionRingSize;
+	}
+
+	void* submissionRing = mmap(NULL, ring->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring, IORING_OFF_SQ_RING);
+	if (submissionRing == MAP_FAILED) {
+		close(ring->ring);
+		*ring = {};
+		return false;
+	}
+	ring->submissionRing = (u8*)submissionRing;
+
+	if (singleMapping) {
+		ring->completionRing = ring->submissionRing;
+	}
+	else {
+		void* completionRing = mmap(NULL, ring->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring, IORING_OFF_CQ_RING);
+		if (completionRing == MAP_FAILED) {
+			JIIObjDestroyIORing(ring);
+			return false;
+		}
+		ring->completionRing = (u8*)completionRing;
+	}
+
+	ring->numberOfEntries = params.sq_entries;
+	void* entries = mmap(NULL, sizeof(io_uring_sqe) * params.sq_entries, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring, IORING_OFF_SQES);
+	if (entries == MAP_FAILED) {
+		JIIObjDestroyIORing(ring);
+		return false;
+	}
+	ring->entries = (io_uring_sqe*)entries;
+
+	ring->submissionTail = (u32*)(ring->submissionRing + params.sq_off.tail);
+	ring->tail = *ring->submissionTail;
+	ring->submissionMask = *(u32*)(ring->submissionRing + params.sq_off.ring_mask);
+	ring->submissionArray = (u32*)(ring->submissionRing + params.sq_off.array);
+
+	ring->completionHead = (u32*)(ring->completionRing + params.cq_off.head);
+	ring->completionTail = (u32*)(ring->completionRing + params.cq_off.tail);
+	ring->completionMask = *(u32*)(ring->completionRing + params.cq_off.ring_mask);
+	ring->completions = (io_uring_cqe*)(ring->completionRing + params.cq_off.cqes);
+
+	// the kernel pins these once instead of on every read
+	struct iovec vectors[JII_OBJ_IO_BUFFER_COUNT];
+	for (u32 i = 0; i < JII_OBJ_IO_BUFFER_COUNT; ++i) {
+		vectors[i].iov_base = buffers + (u64)i * JII_OBJ_IO_BUFFER_SIZE;
+		vectors[i].iov_len = JII_OBJ_IO_BUFFER_SIZE;
+	}
+	if (syscall(__NR_io_uring_register, ring->ring, IORING_REGISTER_BUFFERS, vectors, JII_OBJ_IO_BUFFER_COUNT) < 0) {
+		JIIObjDestroyIORing(ring);
+		return false;
+	}
+
+	return true;
+}
+
+// NULL when every entry is taken, have to wait for completions then
+JIIPrivate io_uring_sqe* JIIObjGetSubmissionEntry(JIIObjIORing* ring) {
+	if (ring->inFlight + ring->unsubmitted == ring->numberOfEntries) {
+		return NULL;
+	}
+
+	u32 slot = ring->tail++ & ring->submissionMask;
+	io_uring_sqe* entry = &ring->entries[slot];
+	memset(entry, 0, sizeof(io_uring_sqe));
+	ring->submissionArray[slot] = slot;
+	++ring->unsubmitted;
+
+	return entry;
+}
+
+// publishes whatever got queued and waits for at least one completion
+JIIPrivate bool JIIObjSubmitAndWait(JIIObjIORing* ring) {
+	// only we move the tail, the kernel only reads it
+	__atomic_store_n(ring->submissionTail, ring->tail, __ATOMIC_RELEASE);
+
+	while (true) {
+		long result = syscall(__NR_io_uring_enter, ring->ring, ring->unsubmitted, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result >= 0) {
+			ring->inFlight += (u32)result;
+			ring->unsubmitted -= (u32)result;
+			return true;
+		}
+		if (errno != EINTR) {
+			return false;
+		}
+	}
+}
+
+JIIPrivate void JIIObjMarkBatchFileReady(JIIObjBatch* batch, u32 index) {
+	JIIObjBatchFile* file = &batch->files[index];
+	if (file->file >= 0) {
+		close(file->file);
+		file->file = -1;
+	}
+	file->ready = true;
+
+	JIIObjLockMonitor(&batch->monitor);
+	batch->ready[batch->numberOfReady++] = index;
+	JIIObjWakeMonitor(&batch->monitor);
+	JIIObjUnlockMonitor(&batch->monitor);
+}
+
+// takes files in the order they became ready until every file was taken
+JIIPrivate void JIIObjBatchParserProc(void* data) {
+	JIIObjBatch* batch = (JIIObjBatch*)data;
+
+	while (true) {
+		u32 claim = JIIObjAtomicAdd32(&batch->claimed, 1);
+		if (claim >= batch->numberOfFiles) {
+			return;
+		}
+
+		JIIObjLockMonitor(&batch->monitor);
+		while (batch->numberOfReady <= claim) {
+			JIIObjWaitMonitor(&batch->monitor);
+		}
+		u32 index = batch->ready[claim];
+		JIIObjUnlockMonitor(&batch->monitor);
+
+		JIIObjParseBatchFile(batch, index);
+	}
+}
+
+// opens and reads every file through the ring, whatever completes goes straight to the parsers,
+// false if the ring broke down and the files that aren't ready have to be read some other way
+JIIPrivate bool JIIObjRunIORing(JIIObjIORing* ring, JIIObjBatch* batch, u8* buffers) {
+	JIIObjIOBuffer slots[JII_OBJ_IO_BUFFER_COUNT];
+	u32 freeSlots[JII_OBJ_IO_BUFFER_COUNT];
+	u32 numberOfFreeSlots = JII_OBJ_IO_BUFFER_COUNT;
+	for (u32 i = 0; i < JII_OBJ_IO_BUFFER_COUNT; ++i) {
+		freeSlots[i] = i;
+	}
+
+	// opened files that still have bytes to ask for, in the order they opened
+	u32* pending = (u32*)JIIMalloc(sizeof(u32) * (batch->numberOfFiles + 1));
+	if (!pending) {
+		// nothing was queued yet, the caller reads every file the plain way
+		return false;
+	}
+	u32 pendingBegin = 0;
+	u32 pendingEnd = 0;
+
+	u32 nextOpen = 0;
+	u32 opensInFlight = 0;
+	u32 finished = 0;
+	bool broken = false;
+
+	while (finished < batch->numberOfFiles) {
+		// reads first so the files that are already open finish early and the parsers get going
+		while (numberOfFreeSlots && pendingBegin != pendingEnd) {
+			io_uring_sqe* entry = JIIObjGetSubmissionEntry(ring);
+			if (!entry) {
+				break;
+			}
+
+			u32 index = pending[pendingBegin];
+			JIIObjBatchFile* file = &batch->files[index];
+			u32 slot = freeSlots[--numberOfFreeSlots];
+
+			u64 remaining = file->size - file->requested;
+			slots[slot].file = index;
+			slots[slot].offset = file->requested;
+			slots[slot].size = remaining < JII_OBJ_IO_BUFFER_SIZE ? (u32)remaining : JII_OBJ_IO_BUFFER_SIZE;
+
+			entry->opcode = IORING_OP_READ_FIXED;
+			entry->fd = file->file;
+			entry->addr = (u64)(buffers + (u64)slot * JII_OBJ_IO_BUFFER_SIZE);
+			entry->len = slots[slot].size;
+			entry->off = slots[slot].offset;
+			entry->buf_index = (u16)slot;
+			entry->user_data = (JII_OBJ_IO_READ << 32) | slot;
+
+			file->requested += slots[slot].size;
+			++file->readsInFlight;
+			if (file->requested == file->size) {
+				++pendingBegin;
+			}
+		}
+
+		// opens don't run further ahead of the reads than there are buffers, every open file is a descriptor
+		while (nextOpen < batch->numberOfFiles && opensInFlight + (pendingEnd - pendingBegin) < JII_OBJ_IO_BUFFER_COUNT) {
+			io_uring_sqe* entry = JIIObjGetSubmissionEntry(ring);
+			if (!entry) {
+				break;
+			}
+
+			entry->opcode = IORING_OP_OPENAT;
+			entry->fd = AT_FDCWD;
+			entry->addr = (u64)batch->files[nextOpen].path;
+			entry->open_flags = O_RDONLY | O_CLOEXEC;
+			entry->user_data = (JII_OBJ_IO_OPEN << 32) | nextOpen;
+			++nextOpen;
+			++opensInFlight;
+		}
+
+		if (!JIIObjSubmitAndWait(ring)) {
+			broken = true;
+			break;
+		}
+
+		u32 head = *ring->completionHead;
+		u32 tail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; ++head) {
+			io_uring_cqe* completion = &ring->completions[head & ring->completionMask];
+			u32 value = (u32)completion->user_data;
+			i32 result = completion->res;
+			--ring->inFlight;
+
+			if ((completion->user_data >> 32) == JII_OBJ_IO_OPEN) {
+				JIIObjBatchFile* file = &batch->files[value];
+				--opensInFlight;
+
+				struct stat info;
+				if (result < 0) {
+					file->status = JIIObjStatus::Error;
+				}
+				else {
+					file->file = result;
+					// openat can't say how big the file is, fstat is cheap next to the reads
+					if (fstat(file->file, &info) != 0) {
+						file->status = JIIObjStatus::Error;
+					}
+					else {
+						file->size = (u64)info.st_size;
+						file->buffer = (u8*)JIIMalloc(file->size ? file->size : 1);
+						if (!file->buffer) {
+							file->status = JIIObjStatus::OutOfSpace;
+						}
+					}
+				}
+
+				if (file->status != JIIObjStatus::Ok || file->size == 0) {
+					JIIObjMarkBatchFileReady(batch, value);
+					++finished;
+				}
+				else {
+					pending[pendingEnd++] = value;
+				}
+			}
+			else {
+				JIIObjIOBuffer* slot = &slots[value];
+				JIIObjBatchFile* file = &batch->files[slot->file];
+
+				// there is no way to read straight into the file buffer, only the registered buffers are pinned
+				if (result == (i32)slot->size) {
+					memcpy(file->buffer + slot->offset, buffers + (u64)value * JII_OBJ_IO_BUFFER_SIZE, slot->size);
+				}
+				else {
+					// short reads only happen when the file shrank under us
+					file->status = JIIObjStatus::Error;
+				}
+
+				freeSlots[numberOfFreeSlots++] = value;
+
+				if (--file->readsInFlight == 0 && file->requested == file->size) {
+					JIIObjMarkBatchFileReady(batch, slot->file);
+					++finished;
+				}
+			}
+		}
+		__atomic_store_n(ring->completionHead, head, __ATOMIC_RELEASE);
+	}
+
+	JIIFree(pending);
+	return !broken;
+}
+
+// true if the ring was there, every file is parsed by the time it returns then
+JIIPrivate bool JIIObjLoadBatchWithIORing(JIIObjBatch* batch) {
+	u8* buffers = (u8*)JIIMalloc((u64)JII_OBJ_IO_BUFFER_SIZE * JII_OBJ_IO_BUFFER_COUNT);
+	if (!buffers) {
+		return false;
+	}
+
+	JIIObjIORing ring;
+	if (!JIIObjCreateIORing(&ring, buffers)) {
+		JIIFree(buffers);
+		return false;
+	}
+
+	for (u32 i = 0; i < batch->numberOfFiles; ++i) {
+		batch->files[i].file = -1;
+	}
+
+	// this thread does the reads, the parsers take the files as they come in
+	JIIObjThread parsers[JII_OBJ_MAX_THREADS];
+	u32 numberOfParsers = JIIObjGetThreadCount();
+	u32 startedParsers = 0;
+	for (; startedParsers < numberOfParsers; ++startedParsers) {
+		if (!JIIObjCreateThread(&parsers[startedParsers], JIIObjBatchParserProc, batch)) {
+			break;
+		}
+	}
+
+	bool broken = !JIIObjRunIORing(&ring, batch, buffers);
+	JIIObjDestroyIORing(&ring);
+
+	if (broken) {
+		// whatever the ring didn't finish is read the plain way, the parsers are still waiting for it
+		for (u32 i = 0; i < batch->numberOfFiles; ++i) {
+			JIIObjBatchFile* file = &batch->files[i];
+			if (file->ready) {
+				continue;
+			}
+
+			if (file->file >= 0) {
+				close(file->file);
+			}
+			JIIFree(file->buffer);
+
+			const char* path = file->path;
+			*file = {};
+			file->path = path;
+			file->file = -1;
+			JIIObjReadBatchFile(file);
+			JIIObjMarkBatchFileReady(batch, i);
+		}
+	}
+
+	// and parses too once the reads are out of the way
+	JIIObjBatchParserProc(batch);
+	for (u32 i = 0; i < startedParsers; ++i) {
+		JIIObjJoinThread(&parsers[i]);
+	}
+
+	JIIFree(buffers);
+	return true;
+}
+#endif
+
+JIIDef JIIObjStatus JIIObjLoadDataBatch(const char* const* paths, u32 count, JIIObjModelData* models, JIIObjStatus* statuses, JIIObjLoadOptions* options) {
+	JIIAssert((paths && models && statuses) || count == 0);
+	JIITraceScope("JIIObjLoadDataBatch");
+
+	if (count == 0) {
+		return JIIObjStatus::Ok;
+	}
+
+	JIIObjBatch batch = {};
+	batch.numberOfFiles = count;
+	batch.models = models;
+	batch.statuses = statuses;
+	batch.options = options;
+	batch.files = (JIIObjBatchFile*)JIIMalloc(sizeof(JIIObjBatchFile) * count);
+	batch.ready = (u32*)JIIMalloc(sizeof(u32) * count);
+	if (!batch.files || !batch.ready) {
+		JIIFree(batch.ready);
+		JIIFree(batch.files);
+
+		for (u32 i = 0; i < count; ++i) {
+			models[i] = {};
+			statuses[i] = JIIObjStatus::OutOfSpace;
+		}
+		return JIIObjStatus::OutOfSpace;
+	}
+	JIIObjCreateMonitor(&batch.monitor);
+
+	for (u32 i = 0; i < count; ++i) {
+		batch.files[i] = {};
+		batch.files[i].path = paths[i];
+		batch.files[i].status = JIIObjStatus::Ok;
+	}
+
+	bool loaded = false;
+#if defined(JII_OBJ_IO_URING)
+	loaded = JIIObjLoadBatchWithIORing(&batch);
+#endif
+
+	if (!loaded) {
+		JIIObjParallelFor(JIIObjGetThreadCount(), 1, JIIObjBatchReaderProc, &batch);
+	}
+
+	JIIObjDestroyMonitor(&batch.monitor);
+	JIIFree(batch.ready);
+	JIIFree(batch.files);
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+	for (u32 i = 0; i < count; ++i) {
+		if (statuses[i] != JIIObjStatus::Ok) {
+			status = JIIObjStatus::Error;
+		}
+	}
+
+	return status;
+}
+
+// chunks start and end on line starts, neighbours share the boundary
+struct JIIObjPointCloudChunk {
+	u64 begin;
+	u64 end;
+	u32 numberOfPoints;
+	u32 firstPoint;
+};
+
+struct JIIObjPointCloudContext {
+	u8* data;
+	JIIObjPointCloudChunk* chunks;
+	JIIObjPointCloud* cloud;
+	bool hasColors;
+};
+
+JIIPrivate bool JIIObjIsPointLine(const u8* line, u64 lineSize) {
+	return lineSize >= 2 && line[0] == 'v' && JIIObjIsWhitespace(line[1]);
+}
+
+// the start of the first line at or after offset
+JIIPrivate u64 JIIObjFindLineStart(u8* data, u64 size, u64 offset) {
+	if (offset == 0 || offset >= size) {
+		return offset < size ? offset : size;
+	}
+
+	u8* newline = (u8*)memchr(data + offset - 1, '\n', size - (offset - 1));
+	return newline ? (u64)(newline - data) + 1 : size;
+}
+
+JIIPrivate void JIIObjCountPointsProc(void* data, u32 begin, u32 end) {
+	JIIObjPointCloudContext* context = (JIIObjPointCloudContext*)data;
+
+	for (u32 i = begin; i < end; ++i) {
+		JIIObjPointCloudChunk* chunk = &context->chunks[i];
+
+		u32 points = 0;
+		u8* cursor = context->data + chunk->begin;
+		u8* chunkEnd = context->data + chunk->end;
+		while (cursor < chunkEnd) {
+			u8* newline = (u8*)memchr(cursor, '\n', chunkEnd - cursor);
+			u8* lineEnd = newline ? newline : chunkEnd;
+
+			points += JIIObjIsPointLine(cursor, lineEnd - cursor) ? 1 : 0;
+			cursor = lineEnd + 1;
+		}
+
+		chunk->numberOfPoints = points;
+	}
+}
+
+JIIPrivate void JIIObjParsePointsProc(void* data, u32 begin, u32 end) {
+	JIIObjPointCloudContext* context = (JIIObjPointCloudContext*)data;
+	JIIObjPointCloud* cloud = context->cloud;
+
+	for (u32 i = begin; i < end; ++i) {
+		JIIObjPointCloudChunk* chunk = &context->chunks[i];
+
+		u32 point = chunk->firstPoint;
+		u8* cursor = context->data + chunk->begin;
+		u8* chunkEnd = context->data + chunk->end;
+		while (cursor < chunkEnd) {
+			u8* newline = (u8*)memchr(cursor, '\n', chunkEnd - cursor);
+			u8* lineEnd = newline ? newline : chunkEnd;
+			u32 lineSize = (u32)(lineEnd - cursor);
+
+			if (JIIObjIsPointLine(cursor, lineSize)) {
+				u32 offset = 1;
+				cloud->x[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+				cloud->y[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+				cloud->z[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+				if (context->hasColors) {
+					cloud->r[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+					cloud->g[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+					cloud->b[point] = JIIObjEatFloat(cursor, lineSize, &offset);
+				}
+				++point;
+			}
+
+			cursor = lineEnd + 1;
+		}
+	}
+}
+
+// colors are all or nothing, the first point decides (missing ones further down come out as 0)
+JIIPrivate bool JIIObjPointCloudHasColors(u8* data, u64 size) {
+	u8* cursor = data;
+	u8* end = data + size;
+	while (cursor < end) {
+		u8* newline = (u8*)memchr(cursor, '\n', end - cursor);
+		u8* lineEnd = newline ? newline : end;
+
+		if (JIIObjIsPointLine(cursor, lineEnd - cursor)) {
+			u32 components = 0;
+			bool inComponent = false;
+			for (u8* c = cursor + 1; c < lineEnd && !JIIObjIsLineEnd(*c); ++c) {
+				bool isWhitespace = JIIObjIsWhitespace(*c);
+				components += (!isWhitespace && !inComponent) ? 1 : 0;
+				inComponent = !isWhitespace;
+			}
+			return components >= 6;
+		}
+
+		cursor = lineEnd + 1;
+	}
+
+	return false;
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadPointCloudMapping(JIIObjFileMapping* mapping, JIIObjPointCloud* cloud) {
+	JIITraceScope("JIIObjLoadPointCloud");
+
+	u64 size = mapping->size;
+	u32 numberOfChunks = (u32)((size + JII_OBJ_POINT_CLOUD_CHUNK_SIZE - 1) / JII_OBJ_POINT_CLOUD_CHUNK_SIZE);
+
+	JIIObjPointCloudContext context = {};
+	context.data = mapping->data;
+	context.cloud = cloud;
+	context.chunks = (JIIObjPointCloudChunk*)JIIMalloc(sizeof(JIIObjPointCloudChunk) * (numberOfChunks + 1));
+
+	for (u32 i = 0; i < numberOfChunks; ++i) {
+		context.chunks[i] = {};
+		context.chunks[i].begin = JIIObjFindLineStart(mapping->data, size, (u64)i * JII_OBJ_POINT_CLOUD_CHUNK_SIZE);
+		context.chunks[i].end = JIIObjFindLineStart(mapping->data, size, (u64)(i + 1) * JII_OBJ_POINT_CLOUD_CHUNK_SIZE);
+	}
+
+	// first count, then every chunk knows where its points go and parses straight into the arrays
+	JIIObjParallelFor(numberOfChunks, 1, JIIObjCountPointsProc, &context);
+
+	u64 numberOfPoints = 0;
+	for (u32 i = 0; i < numberOfChunks; ++i) {
+		context.chunks[i].firstPoint = (u32)numberOfPoints;
+		numberOfPoints += context.chunks[i].numberOfPoints;
+	}
+
+	if (numberOfPoints > UINT32_MAX) {
+		JIIFree(context.chunks);
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	JIITraceCounter("JIIObjPoints", numberOfPoints);
+
+	if (numberOfPoints) {
+		context.hasColors = JIIObjPointCloudHasColors(mapping->data, size);
+
+		u64 n = numberOfPoints;
+		float* arrays = (float*)JIIMalloc(sizeof(float) * n * (context.hasColors ? 6 : 3));
+		cloud->numberOfPoints = (u32)n;
+		cloud->x = arrays;
+		cloud->y = arrays + n;
+		cloud->z = arrays + n * 2;
+		if (context.hasColors) {
+			cloud->r = arrays + n * 3;
+			cloud->g = arrays + n * 4;
+			cloud->b = arrays + n * 5;
+		}
+
+		JIIObjParallelFor(numberOfChunks, 1, JIIObjParsePointsProc, &context);
+	}
+
+	JIIFree(context.chunks);
+	return JIIObjStatus::Ok;
+}
+
+JIIDef JIIObjStatus JIIObjLoadPointCloud(const char* path, JIIObjPointCloud* cloud) {
+	JIIAssert(path && cloud);
+
+	*cloud = {};
+
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFile(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	status = JIIObjLoadPointCloudMapping(&mapping, cloud);
+	JIIObjUnmapFile(&mapping);
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjLoadPointCloudW(const wchar_t* path, JIIObjPointCloud* cloud) {
+	JIIAssert(path && cloud);
+
+	*cloud = {};
+
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFileW(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	status = JIIObjLoadPointCloudMapping(&mapping, cloud);
+	JIIObjUnmapFile(&mapping);
+
+	return status;
+}
+
+JIIDef void JIIObjFreePointCloud(JIIObjPointCloud* cloud) {
+	JIIAssert(cloud);
+
+	// x is the start of the one allocation
+	JIIFree(cloud->x);
+	*cloud = {};
+}
+
+struct JIIObjReloadAsset {
+	char* path;
+	// inotify reports names relative to the watched directory
+	const char* name;
+	i32 watch;
+	u64 modifiedTime;
+
+	// after the asset is published only the background thread touches it
+	u64 hash;
+
+	// current belongs to whoever calls JIIObjGetReloadedData, pending is only ever exchanged
+	JIIObjModelData* current;
+	JIIObjModelData* pending;
+};
+
+struct JIIObjReloader {
+	JIIObjLoadOptions options;
+
+	// assets are published by bumping the count, the background thread never looks past it
+	JIIObjReloadAsset* assets;
+	u32 numberOfAssets;
+
+	u32 running;
+	JIIObjThread thread;
+
+	// -1 when there is no inotify, then modification times get polled
+	i32 notify;
+};
+
+JIIPrivate u64 JIIObjGetModifiedTime(const char* path) {
+#if defined(_WIN32) || defined(_WIN64)
+	WIN32_FILE_ATTRIBUTE_DATA info;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &info)) {
+		return 0;
+	}
+	return ((u64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat info;
+	if (stat(path, &info) != 0) {
+		return 0;
+	}
+	// whole seconds would let a same sized save within the second look unchanged
+#if defined(__APPLE__)
+	return (u64)info.st_mtimespec.tv_sec * 1000000000ull + (u64)info.st_mtimespec.tv_nsec;
+#else
+	return (u64)info.st_mtim.tv_sec * 1000000000ull + (u64)info.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
+JIIPrivate void JIIObjSleep(u32 milliseconds) {
+#if defined(_WIN32) || defined(_WIN64)
+	Sleep(milliseconds);
+#else
+	usleep(milliseconds * 1000);
+#endif
+}
+
+// *data stays NULL when the content hashes the same as last time
+JIIPrivate JIIObjStatus JIIObjReloadFile(JIIObjReloader* reloader, const char* path, u64* hash, bool force, JIIObjModelData** data) {
+	JIIAssert(reloader && path && hash && data);
+	JIITraceScope("JIIObjReloadFile");
+
+	*data = NULL;
+
+	JIIObjContext context = {};
+	JIIObjStatus status = JIIObjReadFile(path, &context.fileBuffer, &context.fileSize);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	u64 newHash = JIIObjHashBytes(context.fileBuffer, context.fileSize);
+	if (!force && newHash == *hash) {
+		JIIFree(context.fileBuffer);
+		return JIIObjStatus::Ok;
+	}
+
+	JIIObjLoadOptions options = reloader->options;
+	JIIObjModelData* model = (JIIObjModelData*)JIIMalloc(sizeof(JIIObjModelData));
+	status = JIIObjLoadFromContext(&context, model, &options);
+	if (status != JIIObjStatus::Ok) {
+		JIIFree(model);
+		return status;
+	}
+
+	*hash = newHash;
+	*data = model;
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate void JIIObjDestroyModel(JIIObjModelData* data) {
+	if (data) {
+		JIIObjFreeData(data);
+		JIIFree(data);
+	}
+}
+
+JIIPrivate void JIIObjRefreshAsset(JIIObjReloader* reloader, JIIObjReloadAsset* asset) {
+	JIIObjModelData* data;
+	// a file that fails to parse (half written or broken) keeps the last good model
+	if (JIIObjReloadFile(reloader, asset->path, &asset->hash, false, &data) != JIIObjStatus::Ok || !data) {
+		return;
+	}
+
+	// if the previous one was never picked up nobody can be using it
+	JIIObjModelData* previous = (JIIObjModelData*)JIIObjAtomicExchangePointer(&asset->pending, data);
+	JIIObjDestroyModel(previous);
+}
+
+JIIPrivate void JIIObjReloaderProc(void* data) {
+	JIIObjReloader* reloader = (JIIObjReloader*)data;
+
+#if defined(__linux__)
+	if (reloader->notify >= 0) {
+		struct pollfd descriptor = { reloader->notify, POLLIN, 0 };
+		alignas(struct inotify_event) char buffer[4096];
+
+		while (JIIObjAtomicLoad32(&reloader->running)) {
+			bool dirty[JII_OBJ_MAX_RELOAD_ASSETS] = {};
+			u32 numberOfAssets = JIIObjAtomicLoad32(&reloader->numberOfAssets);
+
+			// assets whose directory couldn't be watched fall back to modification times
+			for (u32 i = 0; i < numberOfAssets; ++i) {
+				JIIObjReloadAsset* asset = &reloader->assets[i];
+				if (asset->watch < 0) {
+					u64 modifiedTime = JIIObjGetModifiedTime(asset->path);
+					if (modifiedTime != asset->modifiedTime) {
+						asset->modifiedTime = modifiedTime;
+						dirty[i] = true;
+					}
+				}
+			}
+
+			// the timeout is only there to notice that we have to stop
+			ssize_t length = 0;
+			if (poll(&descriptor, 1, JII_OBJ_RELOAD_POLL_MS) > 0) {
+				length = read(reloader->notify, buffer, sizeof(buffer));
+			}
+
+			// a save usually comes with a bunch of events, reload once per batch
+			for (char* cursor = buffer; cursor < buffer + length; ) {
+				struct inotify_event* event = (struct inotify_event*)cursor;
+				if (event->len) {
+					for (u32 i = 0; i < numberOfAssets; ++i) {
+						JIIObjReloadAsset* asset = &reloader->assets[i];
+						if (asset->watch == event->wd && !strcmp(asset->name, event->name)) {
+							dirty[i] = true;
+						}
+					}
+				}
+				cursor += sizeof(struct inotify_event) + event->len;
+			}
+
+			for (u32 i = 0; i < numberOfAssets; ++i) {
+				if (dirty[i]) {
+					JIIObjRefreshAsset(reloader, &reloader->assets[i]);
+				}
+			}
+		}
+		return;
+	}
+#endif
+
+	while (JIIObjAtomicLoad32(&reloader->running)) {
+		JIIObjSleep(JII_OBJ_RELOAD_POLL_MS);
+
+		u32 numberOfAssets = JIIObjAtomicLoad32(&reloader->numberOfAssets);
+		for (u32 i = 0; i < numberOfAssets; ++i) {
+			JIIObjReloadAsset* asset = &reloader->assets[i];
+
+			u64 modifiedTime = JIIObjGetModifiedTime(asset->path);
+			if (modifiedTime != asset->modifiedTime) {
+				asset->modifiedTime = modifiedTime;
+				JIIObjRefreshAsset(reloader, asset);
+			}
+		}
+	}
+}
+
+JIIDef JIIObjReloader* JIIObjCreateReloader(JIIObjLoadOptions* options) {
+	JIIObjReloader* reloader = (JIIObjReloader*)JIIMalloc(sizeof(JIIObjReloader));
+	*reloader = {};
+	if (options) {
+		reloader->options = *options;
+	}
+
+	reloader->assets = (JIIObjReloadAsset*)JIIMalloc(sizeof(JIIObjReloadAsset) * JII_OBJ_MAX_RELOAD_ASSETS);
+	reloader->running = 1;
+
+#if defined(__linux__)
+	reloader->notify = inotify_init1(IN_CLOEXEC);
+#else
+	reloader->notify = -1;
+#endif
+
+	if (!JIIObjCreateThread(&reloader->thread, JIIObjReloaderProc, reloader)) {
+#if defined(__linux__)
+		if (reloader->notify >= 0) {
+			close(reloader->notify);
+		}
+#endif
+		JIIFree(reloader->assets);
+		JIIFree(reloader);
+		return NULL;
+	}
+
+	return reloader;
+}
+
+JIIDef void JIIObjDestroyReloader(JIIObjReloader* reloader) {
+	JIIAssert(reloader);
+
+	JIIObjAtomicStore32(&reloader->running, 0);
+	JIIObjJoinThread(&reloader->thread);
+
+#if defined(__linux__)
+	if (reloader->notify >= 0) {
+		close(reloader->notify);
+	}
+#endif
+
+	for (u32 i = 0; i < reloader->numberOfAssets; ++i) {
+		JIIObjReloadAsset* asset = &reloader->assets[i];
+		JIIObjDestroyModel(asset->current);
+		JIIObjDestroyModel(asset->pending);
+		JIIFree(asset->path);
+	}
+
+	JIIFree(reloader->assets);
+	JIIFree(reloader);
+}
+
+JIIDef JIIObjStatus JIIObjWatchFile(JIIObjReloader* reloader, const char* path, u32* asset) {
+	JIIAssert(reloader && path && asset);
+
+	// only this function adds assets so the count can be read plainly
+	u32 numberOfAssets = reloader->numberOfAssets;
+	for (u32 i = 0; i < numberOfAssets; ++i) {
+		if (!strcmp(reloader->assets[i].path, path)) {
+			*asset = i;
+			return JIIObjStatus::Ok;
+		}
+	}
+
+	if (numberOfAssets >= JII_OBJ_MAX_RELOAD_ASSETS) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	JIIObjReloadAsset* entry = &reloader->assets[numberOfAssets];
+	*entry = {};
+	entry->watch = -1;
+
+	size_t length = strlen(path);
+	entry->path = (char*)JIIMalloc(length + 1);
+	memcpy(entry->path, path, length + 1);
+
+	entry->name = entry->path;
+	for (const char* c = entry->path; *c; ++c) {
+		if (*c == '/' || *c == '\\') {
+			entry->name = c + 1;
+		}
+	}
+
+	// taken before reading so a save that lands in between still gets noticed
+	entry->modifiedTime = JIIObjGetModifiedTime(path);
+
+	JIIObjStatus status = JIIObjReloadFile(reloader, path, &entry->hash, true, &entry->current);
+	if (status != JIIObjStatus::Ok) {
+		JIIFree(entry->path);
+		return status;
+	}
+
+#if defined(__linux__)
+	if (reloader->notify >= 0) {
+		// editors like to save by renaming a temporary over the file, so the directory is watched
+		u32 directoryLength = (u32)(entry->name - entry->path);
+		char* directory = (char*)JIIMalloc(directoryLength + 2);
+		if (directoryLength) {
+			memcpy(directory, entry->path, directoryLength);
+			directory[directoryLength] = 0;
+		}
+		else {
+			directory[0] = '.';
+			directory[1] = 0;
+		}
+
+		entry->watch = inotify_add_watch(reloader->notify, directory, IN_CLOSE_WRITE | IN_MOVED_TO);
+		JIIFree(directory);
+	}
+#endif
+
+	JIIObjAtomicStore32(&reloader->numberOfAssets, numberOfAssets + 1);
+
+	*asset = numberOfAssets;
+	return JIIObjStatus::Ok;
+}
+
+JIIDef JIIObjModelData* JIIObjGetReloadedData(JIIObjReloader* reloader, u32 asset, bool* changed) {
+	JIIAssert(reloader && asset < reloader->numberOfAssets);
+
+	JIIObjReloadAsset* entry = &reloader->assets[asset];
+
+	JIIObjModelData* pending = (JIIObjModelData*)JIIObjAtomicExchangePointer(&entry->pending, (JIIObjModelData*)NULL);
+	if (pending) {
+		JIIObjDestroyModel(entry->current);
+		entry->current = pending;
+	}
+
+	if (changed) {
+		*changed = pending != NULL;
+	}
+
+	return entry->current;
+}
+
+struct JIIObjIndexedObject {
+	// from the o/g line up to the next one
+	u64 begin;
+	u64 end;
+
+	// attributes declared before the object, its face indices count from the start of the file
+	u32 positionsBefore;
+	u32 uvsBefore;
+	u32 normalsBefore;
+
+	// offset into the names, zero terminated
+	u32 name;
+};
+
+struct JIIObjIndex {
+	JIIObjFileMapping mapping;
+
+	JIIObjIndexedObject* objects;
+	u32 numberOfObjects;
+	u32 objectsCapacity;
+
+	char* names;
+	u32 namesSize;
+	u32 namesCapacity;
+};
+
+#define JII_OBJ_INDEX_MAGIC 0x5849494a // JIIX
+// bump it whenever JIIObjIndexedObject changes
+#define JII_OBJ_INDEX_VERSION 1
+
+// what the sidecar starts with, the objects and the names follow right after
+struct JIIObjIndexHeader {
+	u32 magic;
+	u32 version;
+	u64 fileSize;
+	u64 modifiedTime;
+	u32 numberOfObjects;
+	u32 namesSize;
+};
+
+JIIPrivate u32 JIIObjAddIndexName(JIIObjIndex* index, const u8* name, u32 size) {
+	index->names = (char*)JIIObjGrowArray(index->names, 1, &index->namesCapacity, index->namesSize + size + 1);
+
+	u32 offset = index->namesSize;
+	memcpy(index->names + offset, name, size);
+	index->names[offset + size] = 0;
+	index->namesSize += size + 1;
+
+	return offset;
+}
+
+JIIPrivate void JIIObjBeginIndexedObject(JIIObjIndex* index, u64 begin, const u8* name, u32 nameSize,
+	u32 positions, u32 uvs, u32 normals) {
+	index->objects = (JIIObjIndexedObject*)JIIObjGrowArray(index->objects, sizeof(JIIObjIndexedObject), &index->objectsCapacity, index->numberOfObjects + 1);
+
+	JIIObjIndexedObject* object = &index->objects[index->numberOfObjects++];
+	object->begin = begin;
+	object->end = begin;
+	object->positionsBefore = positions;
+	object->uvsBefore = uvs;
+	object->normalsBefore = normals;
+	object->name = JIIObjAddIndexName(index, name, nameSize);
+}
+
+// one pass over the line starts, nothing gets parsed besides the object names
+JIIPrivate void JIIObjScanObjects(JIIObjIndex* index) {
+	JIIAssert(index);
+	JIITraceScope("JIIObjScanObjects");
+
+	const u8* buffer = index->mapping.data;
+	u64 size = index->mapping.size;
+
+	u32 positions = 0;
+	u32 uvs = 0;
+	u32 normals = 0;
+
+	// an object only gets closed once it has something in it, so "o name" followed by "g group" stays one object
+	bool hasContent = false;
+	JIIObjBeginIndexedObject(index, 0, (const u8*)"", 0, 0, 0, 0);
+
+	u64 cursor = 0;
+	while (cursor < size) {
+		const u8* line = buffer + cursor;
+		const u8* lineEnd = (const u8*)memchr(line, '\n', size - cursor);
+		u64 lineSize = lineEnd ? (u64)(lineEnd - line) : size - cursor;
+
+		if (lineSize >= 2) {
+			if (line[0] == 'v') {
+				switch (line[1]) {
+					case ' ':
+					case '\t': {
+						++positions;
+						break;
+					}
+					case 't': {
+						++uvs;
+						break;
+					}
+					case 'n': {
+						++normals;
+						break;
+					}
+				}
+				hasContent = true;
+			}
+			else if (line[0] == 'f' && JIIObjIsWhitespace(line[1])) {
+				hasContent = true;
+			}
+			else if ((line[0] == 'o' || line[0] == 'g') && JIIObjIsWhitespace(line[1])) {
+				u64 nameBegin = 1;
+				while (nameBegin < lineSize && JIIObjIsWhitespace(line[nameBegin])) {
+					++nameBegin;
+				}
+				u64 nameEnd = lineSize;
+				while (nameEnd > nameBegin && (JIIObjIsWhitespace(line[nameEnd - 1]) || line[nameEnd - 1] == '\r')) {
+					--nameEnd;
+				}
+
+				JIIObjIndexedObject* current = &index->objects[index->numberOfObjects - 1];
+				if (hasContent) {
+					current->end = cursor;
+					JIIObjBeginIndexedObject(index, cursor, line + nameBegin, (u32)(nameEnd - nameBegin), positions, uvs, normals);
+					hasContent = false;
+				}
+				else if (index->names[current->name] == 0) {
+					current->name = JIIObjAddIndexName(index, line + nameBegin, (u32)(nameEnd - nameBegin));
+				}
+			}
+		}
+
+		cursor += lineSize + 1;
+	}
+
+	JIIObjIndexedObject* last = &index->objects[index->numberOfObjects - 1];
+	last->end = size;
+	if (!hasContent && index->names[last->name] == 0) {
+		// nothing before the first o/g or an empty file
+		--index->numberOfObjects;
+	}
+
+	JIITraceCounter("JIIObjIndexedObjects", index->numberOfObjects);
+}
+
+JIIPrivate bool JIIObjGetSidecarPath(const char* path, char* sidecarPath, u32 maxSize) {
+	u64 length = strlen(path);
+	if (length + sizeof(".jiidx") > maxSize) {
+		return false;
+	}
+
+	memcpy(sidecarPath, path, length);
+	memcpy(sidecarPath + length, ".jiidx", sizeof(".jiidx"));
+	return true;
+}
+
+JIIPrivate bool JIIObjReadSidecar(JIIObjIndex* index, const char* sidecarPath, u64 modifiedTime) {
+	u8* buffer;
+	u32 size;
+	if (JIIObjReadFile(sidecarPath, &buffer, &size) != JIIObjStatus::Ok) {
+		return false;
+	}
+
+	bool valid = false;
+	JIIObjIndexHeader header;
+	if (size >= sizeof(header)) {
+		memcpy(&header, buffer, sizeof(header));
+
+		u64 expectedSize = sizeof(header) + sizeof(JIIObjIndexedObject) * (u64)header.numberOfObjects + header.namesSize;
+		valid = header.magic == JII_OBJ_INDEX_MAGIC && header.version == JII_OBJ_INDEX_VERSION &&
+			header.fileSize == index->mapping.size && header.modifiedTime == modifiedTime && expectedSize == size;
+	}
+
+	if (valid) {
+		index->numberOfObjects = header.numberOfObjects;
+		index->objectsCapacity = header.numberOfObjects;
+		index->objects = (JIIObjIndexedObject*)JIIMalloc(sizeof(JIIObjIndexedObject) * header.numberOfObjects);
+		memcpy(index->objects, buffer + sizeof(header), sizeof(JIIObjIndexedObject) * header.numberOfObjects);
+
+		index->namesSize = header.namesSize;
+		index->namesCapacity = header.namesSize;
+		index->names = (char*)JIIMalloc(header.namesSize);
+		memcpy(index->names, buffer + sizeof(header) + sizeof(JIIObjIndexedObject) * header.numberOfObjects, header.namesSize);
+
+		// a sidecar that was tampered with should not make us read past the names
+		for (u32 i = 0; i < index->numberOfObjects && valid; ++i) {
+			JIIObjIndexedObject* object = &index->objects[i];
+			valid = object->name < index->namesSize && object->begin <= object->end && object->end <= index->mapping.size;
+		}
+		valid = valid && (index->namesSize == 0 || index->names[index->namesSize - 1] == 0);
+
+		if (!valid) {
+			JIIFree(index->objects);
+			JIIFree(index->names);
+			index->objects = NULL;
+			index->names = NULL;
+			index->numberOfObjects = index->objectsCapacity = 0;
+			index->namesSize = index->namesCapacity = 0;
+		}
+	}
+
+	JIIFree(buffer);
+	return valid;
+}
+
+// the sidecar is only a cache, failing to write it is not an error
+JIIPrivate void JIIObjWriteSidecar(JIIObjIndex* index, const char* sidecarPath, u64 modifiedTime) {
+	FILE* file = JIIObjOpenFile(sidecarPath, "wb");
+	if (!file) {
+		return;
+	}
+
+	JIIObjIndexHeader header = {};
+	header.magic = JII_OBJ_INDEX_MAGIC;
+	header.version = JII_OBJ_INDEX_VERSION;
+	header.fileSize = index->mapping.size;
+	header.modifiedTime = modifiedTime;
+	header.numberOfObjects = index->numberOfObjects;
+	header.namesSize = index->namesSize;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && fwrite(index->objects, sizeof(JIIObjIndexedObject), index->numberOfObjects, file) == index->numberOfObjects;
+	written = written && fwrite(index->names, 1, index->namesSize, file) == index->namesSize;
+
+	if (fclose(file) != 0 || !written) {
+		// half a sidecar would only get rejected next time anyway
+		remove(sidecarPath);
+	}
+}
+
+JIIDef JIIObjStatus JIIObjOpenIndex(const char* path, JIIObjIndex** index, JIIObjHint hints) {
+	JIIAssert(path && index);
+	JIITraceScope("JIIObjOpenIndex");
+
+	*index = NULL;
+
+	JIIObjIndex* result = (JIIObjIndex*)JIIMalloc(sizeof(JIIObjIndex));
+	*result = {};
+
+	// the mapping stays around, every JIIObjLoadObject parses straight out of it
+	if (JIIObjMapFile(path, &result->mapping) != JIIObjStatus::Ok) {
+		JIIFree(result);
+		return JIIObjStatus::Error;
+	}
+
+	char sidecarPath[4096];
+	bool sidecar = (hints & JII_OBJ_INDEX_SIDECAR) && JIIObjGetSidecarPath(path, sidecarPath, sizeof(sidecarPath));
+	u64 modifiedTime = sidecar ? JIIObjGetModifiedTime(path) : 0;
+
+	if (!sidecar || !JIIObjReadSidecar(result, sidecarPath, modifiedTime)) {
+		JIIObjScanObjects(result);
+		if (sidecar) {
+			JIIObjWriteSidecar(result, sidecarPath, modifiedTime);
+		}
+	}
+
+	*index = result;
+	return JIIObjStatus::Ok;
+}
+
+JIIDef void JIIObjCloseIndex(JIIObjIndex* index) {
+	if (!index) {
+		return;
+	}
+
+	JIIObjUnmapFile(&index->mapping);
+	JIIFree(index->objects);
+	JIIFree(index->names);
+	JIIFree(index);
+}
+
+JIIDef u32 JIIObjGetObjectCount(JIIObjIndex* index) {
+	JIIAssert(index);
+	return index->numberOfObjects;
+}
+
+JIIDef const char* JIIObjGetObjectName(JIIObjIndex* index, u32 object) {
+	JIIAssert(index && object < index->numberOfObjects);
+	return index->names + index->objects[object].name;
+}
+
+JIIDef u32 JIIObjFindObject(JIIObjIndex* index, const char* name) {
+	JIIAssert(index && name);
+
+	for (u32 i = 0; i < index->numberOfObjects; ++i) {
+		if (strcmp(index->names + index->objects[i].name, name) == 0) {
+			return i;
+		}
+	}
+
+	return JII_OBJ_NO_OBJECT;
+}
+
+JIIPrivate JIIObjStatus JIIObjLoadIndexRange(JIIObjIndex* index, u64 begin, u64 end, JIIObjContext* context,
+	JIIObjModelData* data, JIIObjLoadOptions* options) {
+	if (end - begin > UINT32_MAX) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	context->fileBuffer = index->mapping.data + begin;
+	context->fileSize = (u32)(end - begin);
+
+	JIIObjStatus status = JIIObjParseBuffer(context);
+	context->fileBuffer = NULL;
+
+	return JIIObjFinishContext(context, status, data, options);
+}
+
+JIIDef JIIObjStatus JIIObjLoadObject(JIIObjIndex* index, u32 object, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(index && object < index->numberOfObjects && data);
+	JIITraceScope("JIIObjLoadObject");
+
+	JIIObjIndexedObject* entry = &index->objects[object];
+
+	// the usual case, the faces only use what the object declared itself so the offsets
+	// wrap the global indices back to the start of the object
+	JIIObjContext context = {};
+	context.positionsOffset = 0u - entry->positionsBefore;
+	context.uvsOffset = 0u - entry->uvsBefore;
+	context.normalsOffset = 0u - entry->normalsBefore;
+
+	JIIObjStatus status = JIIObjLoadIndexRange(index, entry->begin, entry->end, &context, data, options);
+	// anything else that failed, a malformed face included, fails the same way with every attribute parsed
+	if (!context.indexBeforeObject) {
+		return status;
+	}
+
+	// something points outside the object, parse every attribute before it too and only its own faces
+	context = {};
+	context.facesBegin = (u32)entry->begin;
+	return JIIObjLoadIndexRange(index, 0, entry->end, &context, data, options);
+}
+
+// shortest round trip float formatting, this is Ryu (Ulf Adams, 2018) for 32 bit floats
+#define JII_OBJ_FLOAT_POW5_INV_BITCOUNT 59
+#define JII_OBJ_FLOAT_POW5_BITCOUNT 61
+
+JIIPrivate const u64 jii_ObjFloatPow5InvSplit[31] = {
+	0x0800000000000001ull, 0x0666666666666667ull, 0x051eb851eb851eb9ull,
+	0x04189374bc6a7efaull, 0x068db8bac710cb2aull, 0x053e2d6238da3c22ull,
+	0x0431bde82d7b634eull, 0x06b5fca6af2bd216ull, 0x055e63b88c230e78ull,
+	0x044b82fa09b5a52dull, 0x06df37f675ef6eaeull, 0x057f5ff85e592558ull,
+	0x0465e6604b7a8447ull, 0x0709709a125da071ull, 0x05a126e1a84ae6c1ull,
+	0x0480ebe7b9d58567ull, 0x0734aca5f6226f0bull, 0x05c3bd5191b525a3ull,
+	0x049c97747490eae9ull, 0x0760f253edb4ab0eull, 0x05e72843249088d8ull,
+	0x04b8ed0283a6d3e0ull, 0x078e480405d7b966ull, 0x060b6cd004ac9452ull,
+	0x04d5f0a66a23a9dbull, 0x07bcb43d769f762bull, 0x063090312bb2c4efull,
+	0x04f3a68dbc8f03f3ull, 0x07ec3daf94180651ull, 0x065697bfa9acd1daull,
+	0x051212ffbaf0a7e2ull
+};
+
+JIIPrivate const u64 jii_ObjFloatPow5Split[47] = {
+	0x1000000000000000ull, 0x1400000000000000ull, 0x1900000000000000ull,
+	0x1f40000000000000ull, 0x1388000000000000ull, 0x186a000000000000ull,
+	0x1e84800000000000ull, 0x1312d00000000000ull, 0x17d7840000000000ull,
+	0x1dcd650000000000ull, 0x12a05f2000000000ull, 0x174876e800000000ull,
+	0x1d1a94a200000000ull, 0x12309ce540000000ull, 0x16bcc41e90000000ull,
+	0x1c6bf52634000000ull, 0x11c37937e0800000ull, 0x16345785d8a00000ull,
+	0x1bc16d674ec80000ull, 0x1158e460913d0000ull, 0x15af1d78b58c4000ull,
+	0x1b1ae4d6e2ef5000ull, 0x10f0cf064dd59200ull, 0x152d02c7e14af680ull,
+	0x1a784379d99db420ull, 0x108b2a2c28029094ull, 0x14adf4b7320334b9ull,
+	0x19d971e4fe8401e7ull, 0x1027e72f1f128130ull, 0x1431e0fae6d7217cull,
+	0x193e5939a08ce9dbull, 0x1f8def8808b02452ull, 0x13b8b5b5056e16b3ull,
+	0x18a6e32246c99c60ull, 0x1ed09bead87c0378ull, 0x13426172c74d822bull,
+	0x1812f9cf7920e2b6ull, 0x1e17b84357691b64ull, 0x12ced32a16a1b11eull,
+	0x178287f49c4a1d66ull, 0x1d6329f1c35ca4bfull, 0x125dfa371a19e6f7ull,
+	0x16f578c4e0a060b5ull, 0x1cb2d6f618c878e3ull, 0x11efc659cf7d4b8dull,
+	0x166bb7f0435c9e71ull, 0x1c06a5ec5433c60dull
+};
+
+JIIPrivate const char jii_ObjDigitPairs[200] = {
+	'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+	'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+	'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+	'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+	'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+	'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+	'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+	'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+	'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+	'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+JIIPrivate i32 JIIObjPow5Bits(i32 e) {
+	return (i32)(((u32)e * 1217359) >> 19) + 1;
+}
+
+JIIPrivate u32 JIIObjLog10Pow2(i32 e) {
+	return ((u32)e * 78913) >> 18;
+}
+
+JIIPrivate u32 JIIObjLog10Pow5(i32 e) {
+	return ((u32)e * 732923) >> 20;
+}
+
+JIIPrivate bool JIIObjMultipleOfPowerOf5(u32 value, u32 p) {
+	u32 count = 0;
+	while (value % 5 == 0) {
+		value /= 5;
+		++count;
+	}
+	return count >= p;
+}
+
+JIIPrivate bool JIIObjMultipleOfPowerOf2(u32 value, u32 p) {
+	return (value & ((1u << p) - 1)) == 0;
+}
+
+JIIPrivate u32 JIIObjMulShift(u32 m, u64 factor, i32 shift) {
+	u64 bits0 = (u64)m * (u32)factor;
+	u64 bits1 = (u64)m * (u32)(factor >> 32);
+	u64 sum = (bits0 >> 32) + bits1;
+	return (u32)(sum >> (shift - 32));
+}
+
+// value = mantissa * 10^exponent with the least amount of digits that still parses back to the same float
+JIIPrivate void JIIObjShortestDecimal(u32 ieeeMantissa, u32 ieeeExponent, u32* mantissa, i32* exponent) {
+	i32 e2;
+	u32 m2;
+	if (ieeeExponent == 0) {
+		e2 = 1 - 127 - 23 - 2;
+		m2 = ieeeMantissa;
+	}
+	else {
+		e2 = (i32)ieeeExponent - 127 - 23 - 2;
+		m2 = (1u << 23) | ieeeMantissa;
+	}
+
+	bool acceptBounds = (m2 & 1) == 0;
+
+	u32 mv = 4 * m2;
+	u32 mp = 4 * m2 + 2;
+	u32 mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+	u32 mm = 4 * m2 - 1 - mmShift;
+
+	u32 vr, vp, vm;
+	i32 e10;
+	bool vmIsTrailingZeros = false;
+	bool vrIsTrailingZeros = false;
+	u8 lastRemovedDigit = 0;
+
+	if (e2 >= 0) {
+		u32 q = JIIObjLog10Pow2(e2);
+		e10 = (i32)q;
+		i32 k = JII_OBJ_FLOAT_POW5_INV_BITCOUNT + JIIObjPow5Bits((i32)q) - 1;
+		i32 i = -e2 + (i32)q + k;
+		vr = JIIObjMulShift(mv, jii_ObjFloatPow5InvSplit[q], i);
+		vp = JIIObjMulShift(mp, jii_ObjFloatPow5InvSplit[q], i);
+		vm = JIIObjMulShift(mm, jii_ObjFloatPow5InvSplit[q], i);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			i32 l = JII_OBJ_FLOAT_POW5_INV_BITCOUNT + JIIObjPow5Bits((i32)(q - 1)) - 1;
+			lastRemovedDigit = (u8)(JIIObjMulShift(mv, jii_ObjFloatPow5InvSplit[q - 1], -e2 + (i32)q - 1 + l) % 10);
+		}
+		if (q <= 9) {
+			// only one of mp, mv, and mm can be a multiple of 5, if any
+			if (mv % 5 == 0) {
+				vrIsTrailingZeros = JIIObjMultipleOfPowerOf5(mv, q);
+			}
+			else if (acceptBounds) {
+				vmIsTrailingZeros = JIIObjMultipleOfPowerOf5(mm, q);
+			}
+			else {
+				vp -= JIIObjMultipleOfPowerOf5(mp, q);
+			}
+		}
+	}
+	else {
+		u32 q = JIIObjLog10Pow5(-e2);
+		e10 = (i32)q + e2;
+		i32 i = -e2 - (i32)q;
+		i32 k = JIIObjPow5Bits(i) - JII_OBJ_FLOAT_POW5_BITCOUNT;
+		i32 j = (i32)q - k;
+		vr = JIIObjMulShift(mv, jii_ObjFloatPow5Split[i], j);
+		vp = JIIObjMulShift(mp, jii_ObjFloatPow5Split[i], j);
+		vm = JIIObjMulShift(mm, jii_ObjFloatPow5Split[i], j);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			j = (i32)q - 1 - (JIIObjPow5Bits(i + 1) - JII_OBJ_FLOAT_POW5_BITCOUNT);
+			lastRemovedDigit = (u8)(JIIObjMulShift(mv, jii_ObjFloatPow5Split[i + 1], j) % 10);
+		}
+		if (q <= 1) {
+			vrIsTrailingZeros = true;
+			if (acceptBounds) {
+				vmIsTrailingZeros = mmShift == 1;
+			}
+			else {
+				--vp;
+			}
+		}
+		else if (q < 31) {
+			vrIsTrailingZeros = JIIObjMultipleOfPowerOf2(mv, q - 1);
+		}
+	}
+
+	i32 removed = 0;
+	u32 output;
+	if (vmIsTrailingZeros || vrIsTrailingZeros) {
+		while (vp / 10 > vm / 10) {
+			vmIsTrailingZeros &= vm % 10 == 0;
+			vrIsTrailingZeros &= lastRemovedDigit == 0;
+			lastRemovedDigit = (u8)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vmIsTrailingZeros) {
+			while (vm % 10 == 0) {
+				vrIsTrailingZeros &= lastRemovedDigit == 0;
+				lastRemovedDigit = (u8)(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
+			}
+		}
+		if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+			// round to even
+			lastRemovedDigit = 4;
+		}
+		output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+	}
+	else {
+		while (vp / 10 > vm / 10) {
+			lastRemovedDigit = (u8)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || lastRemovedDigit >= 5);
+	}
+
+	*mantissa = output;
+	*exponent = e10 + removed;
+}
+
+JIIPrivate u32 JIIObjDecimalLength(u32 value) {
+	u32 length = 1;
+	while (value >= 10) {
+		value /= 10;
+		++length;
+	}
+	return length;
+}
+
+// writes exactly length digits of value ending right before end
+JIIPrivate void JIIObjWriteDigits(u32 value, char* end) {
+	while (value >= 100) {
+		u32 pair = (value % 100) * 2;
+		value /= 100;
+		end -= 2;
+		end[0] = jii_ObjDigitPairs[pair];
+		end[1] = jii_ObjDigitPairs[pair + 1];
+	}
+	if (value >= 10) {
+		end -= 2;
+		end[0] = jii_ObjDigitPairs[value * 2];
+		end[1] = jii_ObjDigitPairs[value * 2 + 1];
+	}
+	else {
+		*(--end) = (char)('0' + value);
+	}
+}
+
+JIIPrivate u32 JIIObjFormatU32(u32 value, char* buffer) {
+	u32 length = JIIObjDecimalLength(value);
+	JIIObjWriteDigits(value, buffer + length);
+	return length;
+}
+
+// at most 15 characters, no terminator
+JIIPrivate u32 JIIObjFormatFloat(float value, char* buffer) {
+	u32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	bool sign = (bits >> 31) != 0;
+	u32 ieeeMantissa = bits & ((1u << 23) - 1);
+	u32 ieeeExponent = (bits >> 23) & 0xff;
+
+	char* cursor = buffer;
+
+	if (ieeeExponent == 0xff) {
+		if (ieeeMantissa) {
+			memcpy(cursor, "nan", 3);
+			return 3;
+		}
+		if (sign) {
+			*cursor++ = '-';
+		}
+		memcpy(cursor, "inf", 3);
+		return (u32)(cursor - buffer) + 3;
+	}
+
+	if (sign) {
+		*cursor++ = '-';
+	}
+
+	if (ieeeExponent == 0 && ieeeMantissa == 0) {
+		*cursor++ = '0';
+		return (u32)(cursor - buffer);
+	}
+
+	u32 mantissa;
+	i32 exponent;
+	JIIObjShortestDecimal(ieeeMantissa, ieeeExponent, &mantissa, &exponent);
+
+	i32 length = (i32)JIIObjDecimalLength(mantissa);
+	// position of the decimal point relative to the first digit
+	i32 point = length + exponent;
+
+	if (exponent >= 0 && point <= 9) {
+		// integer, 1200 instead of 1.2e3
+		JIIObjWriteDigits(mantissa, cursor + length);
+		cursor += length;
+		for (i32 i = 0; i < exponent; ++i) {
+			*cursor++ = '0';
+		}
+	}
+	else if (point > 0 && point <= 9) {
+		// 12.34
+		JIIObjWriteDigits(mantissa, cursor + length + 1);
+		memmove(cursor, cursor + 1, point);
+		cursor[point] = '.';
+		cursor += length + 1;
+	}
+	else if (point <= 0 && point > -4) {
+		// 0.001234
+		*cursor++ = '0';
+		*cursor++ = '.';
+		for (i32 i = 0; i < -point; ++i) {
+			*cursor++ = '0';
+		}
+		JIIObjWriteDigits(mantissa, cursor + length);
+		cursor += length;
+	}
+	else {
+		// 1.234e-7
+		JIIObjWriteDigits(mantissa, cursor + length + 1);
+		cursor[0] = cursor[1];
+		if (length > 1) {
+			cursor[1] = '.';
+			cursor += length + 1;
+		}
+		else {
+			cursor += 1;
+		}
+
+		i32 scientificExponent = point - 1;
+		*cursor++ = 'e';
+		if (scientificExponent < 0) {
+			*cursor++ = '-';
+			scientificExponent = -scientificExponent;
+		}
+		cursor += JIIObjFormatU32((u32)scientificExponent, cursor);
+	}
+
+	return (u32)(cursor - buffer);
+}
+
+enum JIIObjWriteSectionType {
+	WritePositions,
+	WriteUVs,
+	WriteNormals,
+	WriteFaces
+};
+
+// the widest line of every section, "f " + 3 * " p/t/n" + '\n' for faces
+#define JII_OBJ_WRITE_ATTRIBUTE_LINE_SIZE (3 + 3 * 16 + 1)
+#define JII_OBJ_WRITE_FACE_LINE_SIZE (2 + 3 * (1 + 3 * 11) + 1)
+
+struct JIIObjWriteContext {
+	JIIObjModelData* data;
+
+	// attributes are read with a stride so vertices can be written without copying them out first
+	const u8* positions;
+	u32 positionsStride;
+	u32 numberOfPositions;
+
+	const u8* uvs;
+	u32 uvsStride;
+	u32 numberOfUVs;
+
+	const u8* normals;
+	u32 normalsStride;
+	u32 numberOfNormals;
+
+	// NULL when every vertex has its own attributes
+	u32* positionIndices;
+	u32* uvIndices;
+	u32* normalIndices;
+
+	bool writeUVs;
+	bool writeNormals;
+};
+
+struct JIIObjWriteTask {
+	JIIObjWriteContext* context;
+	JIIObjWriteSectionType section;
+	u32 begin;
+	u32 end;
+
+	char* buffer;
+	u64 size;
+};
+
+struct JIIObjWriter;
+
+struct JIIObjWriteWorker {
+	JIIObjWriter* writer;
+	u32 index;
+
+	JIIObjThread thread;
+};
+
+// the workers format a batch into one set of tasks while the calling thread writes the other set
+struct JIIObjWriter {
+	JIIObjWriteTask* tasks;
+	u32 numberOfTasks;
+
+	JIIObjWriteWorker workers[JII_OBJ_MAX_THREADS];
+	u32 startedWorkers;
+
+	JIIObjMonitor monitor;
+	u32 batch;
+	u32 pending;
+	bool stop;
+
+	// where the next batch starts
+	u32 counts[4];
+	u32 section;
+	u64 begin;
+};
+
+JIIPrivate char* JIIObjWriteAttributeLine(char* cursor, const char* prefix, u32 prefixSize, const float* values, u32 components) {
+	memcpy(cursor, prefix, prefixSize);
+	cursor += prefixSize;
+
+	for (u32 i = 0; i < components; ++i) {
+		*cursor++ = ' ';
+		cursor += JIIObjFormatFloat(values[i], cursor);
+	}
+
+	*cursor++ = '\n';
+	return cursor;
+}
+
+JIIPrivate char* JIIObjWriteFaceCorner(JIIObjWriteContext* context, char* cursor, u32 vertex) {
+	u32 position = context->positionIndices ? context->positionIndices[vertex] : vertex;
+
+	*cursor++ = ' ';
+	cursor += JIIObjFormatU32(position + 1, cursor);
+
+	if (context->writeUVs || context->writeNormals) {
+		*cursor++ = '/';
+	}
+
+	if (context->writeUVs) {
+		u32 uv = context->uvIndices ? context->uvIndices[vertex] : vertex;
+		cursor += JIIObjFormatU32(uv + 1, cursor);
+	}
+
+	if (context->writeNormals) {
+		u32 normal = context->normalIndices ? context->normalIndices[vertex] : vertex;
+		*cursor++ = '/';
+		cursor += JIIObjFormatU32(normal + 1, cursor);
+	}
+
+	return cursor;
+}
+
+JIIPrivate void JIIObjWriteTaskProc(void* data) {
+	JIIObjWriteTask* task = (JIIObjWriteTask*)data;
+	JIIObjWriteContext* context = task->context;
+
+	char* cursor = task->buffer;
+
+	switch (task->section) {
+		case JIIObjWriteSectionType::WritePositions: {
+			for (u32 i = task->begin; i < task->end; ++i) {
+				const float* values = (const float*)(context->positions + (u64)i * context->positionsStride);
+				cursor = JIIObjWriteAttributeLine(cursor, "v", 1, values, 3);
+			}
+			break;
+		}
+		case JIIObjWriteSectionType::WriteUVs: {
+			for (u32 i = task->begin; i < task->end; ++i) {
+				const float* values = (const float*)(context->uvs + (u64)i * context->uvsStride);
+				// w is optional and almost always 0
+				cursor = JIIObjWriteAttributeLine(cursor, "vt", 2, values, values[2] != 0 ? 3 : 2);
+			}
+			break;
+		}
+		case JIIObjWriteSectionType::WriteNormals: {
+			for (u32 i = task->begin; i < task->end; ++i) {
+				const float* values = (const float*)(context->normals + (u64)i * context->normalsStride);
+				cursor = JIIObjWriteAttributeLine(cursor, "vn", 2, values, 3);
+			}
+			break;
+		}
+		case JIIObjWriteSectionType::WriteFaces: {
+			for (u32 i = task->begin; i < task->end; ++i) {
+				*cursor++ = 'f';
+				cursor = JIIObjWriteFaceCorner(context, cursor, JIIObjGetFaceIndex(context->data, i, 0));
+				cursor = JIIObjWriteFaceCorner(context, cursor, JIIObjGetFaceIndex(context->data, i, 1));
+				cursor = JIIObjWriteFaceCorner(context, cursor, JIIObjGetFaceIndex(context->data, i, 2));
+				*cursor++ = '\n';
+			}
+			break;
+		}
+	}
+
+	task->size = (u64)(cursor - task->buffer);
+}
+
+// every worker formats its own task of each batch, the batch counter picks the set of tasks
+JIIPrivate void JIIObjWriteWorkerProc(void* data) {
+	JIIObjWriteWorker* worker = (JIIObjWriteWorker*)data;
+	JIIObjWriter* writer = worker->writer;
+
+	u32 seen = 0;
+
+	JIIObjLockMonitor(&writer->monitor);
+	for (;;) {
+		while (writer->batch == seen && !writer->stop) {
+			JIIObjWaitMonitor(&writer->monitor);
+		}
+		if (writer->batch == seen) {
+			break;
+		}
+
+		seen = writer->batch;
+		JIIObjWriteTask* task = &writer->tasks[(seen & 1) * writer->numberOfTasks + worker->index];
+
+		JIIObjUnlockMonitor(&writer->monitor);
+		JIIObjWriteTaskProc(task);
+		JIIObjLockMonitor(&writer->monitor);
+
+		if (--writer->pending == 0) {
+			JIIObjWakeMonitor(&writer->monitor);
+		}
+	}
+	JIIObjUnlockMonitor(&writer->monitor);
+}
+
+// fills the tasks of a set with the next batch, a batch never spans two sections
+JIIPrivate bool JIIObjPrepareWriteBatch(JIIObjWriter* writer, u32 set) {
+	while (writer->section <= JIIObjWriteSectionType::WriteFaces && writer->begin >= writer->counts[writer->section]) {
+		++writer->section;
+		writer->begin = 0;
+	}
+	if (writer->section > JIIObjWriteSectionType::WriteFaces) {
+		return false;
+	}
+
+	u64 count = writer->counts[writer->section];
+	for (u32 i = 0; i < writer->numberOfTasks; ++i) {
+		u64 taskBegin = writer->begin + (u64)i * JII_OBJ_WRITE_CHUNK_SIZE;
+		u64 taskEnd = taskBegin + JII_OBJ_WRITE_CHUNK_SIZE;
+
+		// tasks past the end format nothing
+		JIIObjWriteTask* task = &writer->tasks[set * writer->numberOfTasks + i];
+		task->section = (JIIObjWriteSectionType)writer->section;
+		task->begin = (u32)(taskBegin < count ? taskBegin : count);
+		task->end = (u32)(taskEnd < count ? taskEnd : count);
+	}
+
+	writer->begin += (u64)writer->numberOfTasks * JII_OBJ_WRITE_CHUNK_SIZE;
+	return true;
+}
+
+// hands the prepared set to the workers, the tasks without a worker are left to the caller
+JIIPrivate void JIIObjStartWriteBatch(JIIObjWriter* writer) {
+	JIIObjLockMonitor(&writer->monitor);
+	++writer->batch;
+	writer->pending = writer->startedWorkers;
+	JIIObjWakeMonitor(&writer->monitor);
+	JIIObjUnlockMonitor(&writer->monitor);
+}
+
+JIIPrivate void JIIObjFinishWriteBatch(JIIObjWriter* writer) {
+	u32 set = writer->batch & 1;
+	for (u32 i = writer->startedWorkers; i < writer->numberOfTasks; ++i) {
+		JIIObjWriteTaskProc(&writer->tasks[set * writer->numberOfTasks + i]);
+	}
+
+	JIIObjLockMonitor(&writer->monitor);
+	while (writer->pending) {
+		JIIObjWaitMonitor(&writer->monitor);
+	}
+	JIIObjUnlockMonitor(&writer->monitor);
+}
+
+// batch n + 1 gets formatted while batch n is written
+JIIPrivate JIIObjStatus JIIObjWriteBatches(JIIObjWriter* writer, FILE* file) {
+	JIIAssert(writer && file);
+
+	u32 set = (writer->batch + 1) & 1;
+	if (!JIIObjPrepareWriteBatch(writer, set)) {
+		return JIIObjStatus::Ok;
+	}
+	JIIObjStartWriteBatch(writer);
+	JIIObjFinishWriteBatch(writer);
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+	for (;;) {
+		bool hasNext = JIIObjPrepareWriteBatch(writer, set ^ 1);
+		if (hasNext) {
+			JIIObjStartWriteBatch(writer);
+		}
+
+		for (u32 i = 0; i < writer->numberOfTasks; ++i) {
+			JIIObjWriteTask* task = &writer->tasks[set * writer->numberOfTasks + i];
+			if (fwrite(task->buffer, 1, task->size, file) != task->size) {
+				status = JIIObjStatus::Error;
+				break;
+			}
+		}
+
+		if (!hasNext) {
+			break;
+		}
+
+		JIIObjFinishWriteBatch(writer);
+		if (status != JIIObjStatus::Ok) {
+			break;
+		}
+		set ^= 1;
+	}
+
+	return status;
+}
+
+JIIPrivate u32 JIIObjHashFloats(const float* values, u32 components) {
+	u32 hash = 2166136261u;
+	for (u32 i = 0; i < components; ++i) {
+		u32 bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+		hash = (hash ^ bits) * 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+// unique gets the packed distinct values, indices the value index of every element
+JIIPrivate u32 JIIObjDeduplicateAttribute(const u8* source, u32 stride, u32 count, float* unique, u32* indices) {
+	u32 tableSize = 16;
+	while (tableSize < count * 2) {
+		tableSize <<= 1;
+	}
+
+	u32* table = (u32*)JIIMalloc(sizeof(u32) * tableSize);
+	memset(table, 0xff, sizeof(u32) * tableSize);
+
+	u32 numberOfUnique = 0;
+	for (u32 i = 0; i < count; ++i) {
+		const float* values = (const float*)(source + (u64)i * stride);
+
+		u32 slot = JIIObjHashFloats(values, 3) & (tableSize - 1);
+		while (table[slot] != UINT32_MAX && memcmp(&unique[table[slot] * 3], values, sizeof(float) * 3) != 0) {
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (table[slot] == UINT32_MAX) {
+			memcpy(&unique[numberOfUnique * 3], values, sizeof(float) * 3);
+			table[slot] = numberOfUnique++;
+		}
+
+		indices[i] = table[slot];
+	}
+
+	JIIFree(table);
+
+	return numberOfUnique;
+}
+
+JIIPrivate JIIObjStatus JIIObjWriteFile(FILE* file, JIIObjModelData* data, JIIObjHint hints) {
+	JIIAssert(file && data);
+
+	JIIObjWriteContext context = {};
+	context.data = data;
+
+	// without faces there are no vertices either, so just the attributes get written
+	bool writeVertices = data->numberOfFaces > 0 && data->numberOfVertices > 0;
+
+	context.writeUVs = data->numberOfUVs > 0;
+	context.writeNormals = data->numberOfNormals > 0;
+
+	float* uniqueAttributes = NULL;
+	u32* attributeIndices = NULL;
+
+	if (!writeVertices) {
+		context.positions = (const u8*)data->positions;
+		context.positionsStride = sizeof(JIIObjPosition);
+		context.numberOfPositions = data->numberOfPositions;
+		context.uvs = (const u8*)data->uvs;
+		context.uvsStride = sizeof(JIIObjUV);
+		context.numberOfUVs = data->numberOfUVs;
+		context.normals = (const u8*)data->normals;
+		context.normalsStride = sizeof(JIIObjNormal);
+		context.numberOfNormals = data->numberOfNormals;
+	}
+	else if (hints & JII_OBJ_WRITE_DEDUPLICATE) {
+		u32 count = data->numberOfVertices;
+		uniqueAttributes = (float*)JIIMalloc(sizeof(float) * 3 * 3 * (u64)count);
+		attributeIndices = (u32*)JIIMalloc(sizeof(u32) * 3 * (u64)count);
+
+		const u8* vertices = (const u8*)data->vertices;
+
+		float* uniquePositions = uniqueAttributes;
+		context.positionIndices = attributeIndices;
+		context.positions = (const u8*)uniquePositions;
+		context.positionsStride = sizeof(float) * 3;
+		context.numberOfPositions = JIIObjDeduplicateAttribute(vertices + offsetof(JIIObjVertex, position),
+			sizeof(JIIObjVertex), count, uniquePositions, context.positionIndices);
+
+		if (context.writeUVs) {
+			float* uniqueUVs = uniqueAttributes + 3 * (u64)count;
+			context.uvIndices = attributeIndices + count;
+			context.uvs = (const u8*)uniqueUVs;
+			context.uvsStride = sizeof(float) * 3;
+			context.numberOfUVs = JIIObjDeduplicateAttribute(vertices + offsetof(JIIObjVertex, uv),
+				sizeof(JIIObjVertex), count, uniqueUVs, context.uvIndices);
+		}
+
+		if (context.writeNormals) {
+			float* uniqueNormals = uniqueAttributes + 6 * (u64)count;
+			context.normalIndices = attributeIndices + 2 * (u64)count;
+			context.normals = (const u8*)uniqueNormals;
+			context.normalsStride = sizeof(float) * 3;
+			context.numberOfNormals = JIIObjDeduplicateAttribute(vertices + offsetof(JIIObjVertex, normal),
+				sizeof(JIIObjVertex), count, uniqueNormals, context.normalIndices);
+		}
+	}
+	else {
+		const u8* vertices = (const u8*)data->vertices;
+		context.positions = vertices + offsetof(JIIObjVertex, position);
+		context.positionsStride = sizeof(JIIObjVertex);
+		context.numberOfPositions = data->numberOfVertices;
+		context.uvs = vertices + offsetof(JIIObjVertex, uv);
+		context.uvsStride = sizeof(JIIObjVertex);
+		context.numberOfUVs = context.writeUVs ? data->numberOfVertices : 0;
+		context.normals = vertices + offsetof(JIIObjVertex, normal);
+		context.normalsStride = sizeof(JIIObjVertex);
+		context.numberOfNormals = context.writeNormals ? data->numberOfVertices : 0;
+	}
+
+	JIIObjWriter writer = {};
+	writer.counts[JIIObjWriteSectionType::WritePositions] = context.numberOfPositions;
+	writer.counts[JIIObjWriteSectionType::WriteUVs] = context.numberOfUVs;
+	writer.counts[JIIObjWriteSectionType::WriteNormals] = context.numberOfNormals;
+	writer.counts[JIIObjWriteSectionType::WriteFaces] = writeVertices ? data->numberOfFaces : 0;
+
+	// no more tasks than the largest section has chunks
+	u32 largest = 0;
+	for (u32 i = 0; i < 4; ++i) {
+		largest = writer.counts[i] > largest ? writer.counts[i] : largest;
+	}
+	u32 numberOfChunks = (u32)(((u64)largest + JII_OBJ_WRITE_CHUNK_SIZE - 1) / JII_OBJ_WRITE_CHUNK_SIZE);
+
+	writer.numberOfTasks = JIIObjGetThreadCount();
+	if (writer.numberOfTasks > numberOfChunks) {
+		writer.numberOfTasks = numberOfChunks ? numberOfChunks : 1;
+	}
+
+	// two sets of tasks, one being formatted and one being written
+	JIIObjStatus status = JIIObjStatus::Ok;
+	writer.tasks = (JIIObjWriteTask*)JIIMalloc(sizeof(JIIObjWriteTask) * 2 * writer.numberOfTasks);
+	if (!writer.tasks) {
+		status = JIIObjStatus::OutOfSpace;
+	}
+	for (u32 i = 0; writer.tasks && i < 2 * writer.numberOfTasks; ++i) {
+		writer.tasks[i] = {};
+		writer.tasks[i].context = &context;
+	}
+	for (u32 i = 0; status == JIIObjStatus::Ok && i < 2 * writer.numberOfTasks; ++i) {
+		writer.tasks[i].buffer = (char*)JIIMalloc((u64)JII_OBJ_WRITE_CHUNK_SIZE * JII_OBJ_WRITE_FACE_LINE_SIZE);
+		if (!writer.tasks[i].buffer) {
+			status = JIIObjStatus::OutOfSpace;
+		}
+	}
+
+	if (status == JIIObjStatus::Ok) {
+		JIIObjCreateMonitor(&writer.monitor);
+
+		// the workers live for the whole write, a task without a worker is formatted by the caller
+		for (; writer.startedWorkers < writer.numberOfTasks; ++writer.startedWorkers) {
+			JIIObjWriteWorker* worker = &writer.workers[writer.startedWorkers];
+			worker->writer = &writer;
+			worker->index = writer.startedWorkers;
+			if (!JIIObjCreateThread(&worker->thread, JIIObjWriteWorkerProc, worker)) {
+				break;
+			}
+		}
+
+		status = JIIObjWriteBatches(&writer, file);
+
+		JIIObjLockMonitor(&writer.monitor);
+		writer.stop = true;
+		JIIObjWakeMonitor(&writer.monitor);
+		JIIObjUnlockMonitor(&writer.monitor);
+
+		for (u32 i = 0; i < writer.startedWorkers; ++i) {
+			JIIObjJoinThread(&writer.workers[i].thread);
+		}
+		JIIObjDestroyMonitor(&writer.monitor);
+	}
+
+	if (writer.tasks) {
+		for (u32 i = 0; i < 2 * writer.numberOfTasks; ++i) {
+			if (writer.tasks[i].buffer) {
+				JIIFree(writer.tasks[i].buffer);
+			}
+		}
+		JIIFree(writer.tasks);
+	}
+
+	if (uniqueAttributes) {
+		JIIFree(uniqueAttributes);
+		JIIFree(attributeIndices);
+	}
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjWriteData(const char* path, JIIObjModelData* data, JIIObjHint hints) {
+	JIIAssert(path && data);
+	JIITraceScope("JIIObjWriteData");
+
+	FILE* file = JIIObjOpenFile(path, "wb");
+
+	if (!file) {
+		return JIIObjStatus::Error;
+	}
+
+	// every chunk is handed over in one piece, stdio buffering would only add a copy
+	setvbuf(file, NULL, _IONBF, 0);
+
+	JIIObjStatus status = JIIObjWriteFile(file, data, hints);
+
+	if (fclose(file) != 0) {
+		status = JIIObjStatus::Error;
+	}
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjWriteDataW(const wchar_t* path, JIIObjModelData* data, JIIObjHint hints) {
+	JIIAssert(path && data);
+	JIITraceScope("JIIObjWriteData");
+
+	FILE* file = JIIObjOpenFileW(path, L"wb");
+
+	if (!file) {
+		return JIIObjStatus::Error;
+	}
+
+	setvbuf(file, NULL, _IONBF, 0);
+
+	JIIObjStatus status = JIIObjWriteFile(file, data, hints);
+
+	if (fclose(file) != 0) {
+		status = JIIObjStatus::Error;
+	}
+
+	return status;
+}
+
+typedef JIIObjStatus(*JIIObjLineProc)(void* data, u8* line, u32 lineSize);
+
+// streams the file through buffer from the start, line ends are not part of the lines
+JIIPrivate JIIObjStatus JIIObjForEachLine(FILE* file, u8* buffer, u32 bufferSize, JIIObjLineProc proc, void* data) {
+	if (fseek(file, 0, SEEK_SET) != 0) {
+		return JIIObjStatus::Error;
+	}
+
+	u32 kept = 0;
+	while (true) {
+		u32 size = kept + (u32)fread(buffer + kept, 1, bufferSize - kept, file);
+		bool end = size == kept;
+		if (end && ferror(file)) {
+			return JIIObjStatus::Error;
+		}
+
+		u32 cursor = 0;
+		while (cursor < size) {
+			u8* newline = (u8*)memchr(buffer + cursor, '\n', size - cursor);
+			if (!newline && !end) {
+				break;
+			}
+
+			u32 lineEnd = newline ? (u32)(newline - buffer) : size;
+			u32 lineSize = lineEnd - cursor;
+			if (lineSize && buffer[lineEnd - 1] == '\r') {
+				--lineSize;
+			}
+
+			if (lineSize) {
+				JIIObjStatus status = proc(data, buffer + cursor, lineSize);
+				if (status != JIIObjStatus::Ok) {
+					return status;
+				}
+			}
+
+			cursor = lineEnd + 1;
+		}
+
+		if (end) {
+			return JIIObjStatus::Ok;
+		}
+
+		kept = size - cursor;
+		if (kept == bufferSize) {
+			return JIIObjStatus::OutOfSpace;
+		}
+		memmove(buffer, buffer + cursor, kept);
+	}
+}
+
+struct JIIObjTileTriangle {
+	u32 tile;
+	JIIObjVertexKey corners[3];
+};
+
+enum JIIObjTileTemporary {
+	TilePositions,
+	TileUVs,
+	TileNormals,
+	TileTriangles,
+	TileSorted,
+	TileTemporaries
+};
+
+JIIPrivate const char* jii_ObjTileTemporaryNames[JIIObjTileTemporary::TileTemporaries] = {
+	".positions.tmp", ".uvs.tmp", ".normals.tmp", ".triangles.tmp", ".sorted.tmp"
+};
+
+struct JIIObjTiler {
+	const char* outputPath;
+	JIIObjTileOptions options;
+
+	char temporaryPaths[JIIObjTileTemporary::TileTemporaries][4096];
+	FILE* temporaries[JIIObjTileTemporary::TileTemporaries];
+	JIIObjFileMapping mappings[JIIObjTileTemporary::TileTemporaries];
+	bool mapped[JIIObjTileTemporary::TileTemporaries];
+
+	u32 numberOfPositions;
+	u32 numberOfUVs;
+	u32 numberOfNormals;
+	u64 numberOfTriangles;
+
+	JIIObjPosition min;
+	JIIObjPosition max;
+
+	// triangles per tile, then where every tile starts in the sorted file
+	u64* tileCounts;
+	u64* tileOffsets;
+
+	// face corners of the line being parsed, triangulated as a fan
+	JIIObjVertexKey corners[3];
+	u32 numberOfCorners;
+};
+
+JIIPrivate JIIObjStatus JIIObjTileAttributeLine(void* data, u8* line, u32 lineSize) {
+	JIIObjTiler* tiler = (JIIObjTiler*)data;
+
+	if (lineSize < 2 || line[0] != 'v') {
+		return JIIObjStatus::Ok;
+	}
+
+	u32 offset = 1;
+	JIIObjTileTemporary temporary;
+	if (JIIObjIsWhitespace(line[1])) {
+		temporary = JIIObjTileTemporary::TilePositions;
+		++tiler->numberOfPositions;
+	}
+	else if (line[1] == 't') {
+		temporary = JIIObjTileTemporary::TileUVs;
+		++tiler->numberOfUVs;
+		++offset;
+	}
+	else if (line[1] == 'n') {
+		temporary = JIIObjTileTemporary::TileNormals;
+		++tiler->numberOfNormals;
+		++offset;
+	}
+	else {
+		return JIIObjStatus::Ok;
+	}
+
+	float values[3];
+	values[0] = JIIObjEatFloat(line, lineSize, &offset);
+	values[1] = JIIObjEatFloat(line, lineSize, &offset);
+	values[2] = JIIObjEatFloat(line, lineSize, &offset);
+
+	if (temporary == JIIObjTileTemporary::TilePositions) {
+		tiler->min.x = fminf(tiler->min.x, values[0]);
+		tiler->min.y = fminf(tiler->min.y, values[1]);
+		tiler->min.z = fminf(tiler->min.z, values[2]);
+		tiler->max.x = fmaxf(tiler->max.x, values[0]);
+		tiler->max.y = fmaxf(tiler->max.y, values[1]);
+		tiler->max.z = fmaxf(tiler->max.z, values[2]);
+	}
+
+	if (fwrite(values, sizeof(values), 1, tiler->temporaries[temporary]) != 1) {
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate u32 JIIObjGetTileCell(float value, float min, float max, u32 tiles) {
+	if (!(max > min)) {
+		return 0;
+	}
+
+	float cell = (value - min) / (max - min) * (float)tiles;
+	if (!(cell > 0)) {
+		return 0;
+	}
+
+	return cell >= (float)tiles ? tiles - 1 : (u32)cell;
+}
+
+JIIPrivate JIIObjStatus JIIObjAddTileTriangle(JIIObjTiler* tiler) {
+	const JIIObjPosition* positions = (const JIIObjPosition*)tiler->mappings[JIIObjTileTemporary::TilePositions].data;
+
+	JIIObjPosition center = {};
+	for (u32 i = 0; i < 3; ++i) {
+		const JIIObjPosition* position = &positions[tiler->corners[i].position];
+		center.x += position->x / 3.0f;
+		center.y += position->y / 3.0f;
+		center.z += position->z / 3.0f;
+	}
+
+	JIIObjTileOptions* options = &tiler->options;
+	u32 x = JIIObjGetTileCell(center.x, tiler->min.x, tiler->max.x, options->tilesX);
+	u32 y = JIIObjGetTileCell(center.y, tiler->min.y, tiler->max.y, options->tilesY);
+	u32 z = JIIObjGetTileCell(center.z, tiler->min.z, tiler->max.z, options->tilesZ);
+
+	JIIObjTileTriangle triangle;
+	triangle.tile = (z * options->tilesY + y) * options->tilesX + x;
+	memcpy(triangle.corners, tiler->corners, sizeof(triangle.corners));
+
+	if (fwrite(&triangle, sizeof(triangle), 1, tiler->temporaries[JIIObjTileTemporary::TileTriangles]) != 1) {
+		return JIIObjStatus::Error;
+	}
+
+	++tiler->tileCounts[triangle.tile];
+	++tiler->numberOfTriangles;
+
+	return JIIObjStatus::Ok;
+}
+
+// same corner layouts JIIObjParseFace takes, indices are checked right away since every attribute is known by now
+JIIPrivate JIIObjStatus JIIObjTileFaceLine(void* data, u8* line, u32 lineSize) {
+	JIIObjTiler* tiler = (JIIObjTiler*)data;
+
+	if (lineSize < 2 || line[0] != 'f' || !JIIObjIsWhitespace(line[1])) {
+		return JIIObjStatus::Ok;
+	}
+
+	tiler->numberOfCorners = 0;
+
+	u32 offset = 1;
+	while (offset < lineSize && JIIObjIsWhitespace(line[offset])) {
+		JIIObjEatWhitespaces(line, lineSize, &offset);
+		if (offset >= lineSize || !JIIObjIsDigit(line[offset])) {
+			break;
+		}
+
+		u32 position = JIIObjEatU32(line, lineSize, &offset);
+		u32 uv = UINT_MAX;
+		u32 normal = UINT_MAX;
+		if (offset < lineSize && line[offset] == '/') {
+			JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Error);
+			if (line[offset] != '/') {
+				uv = JIIObjEatU32(line, lineSize, &offset);
+			}
+
+			if (offset < lineSize && line[offset] == '/') {
+				JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Error);
+				normal = JIIObjEatU32(line, lineSize, &offset);
+			}
+		}
+
+		if (position - 1 >= tiler->numberOfPositions ||
+			(uv != UINT_MAX && uv - 1 >= tiler->numberOfUVs) ||
+			(normal != UINT_MAX && normal - 1 >= tiler->numberOfNormals)) {
+			return JIIObjStatus::Error;
+		}
+
+		JIIObjVertexKey key;
+		key.position = position - 1;
+		key.uv = uv != UINT_MAX ? uv - 1 : UINT_MAX;
+		key.normal = normal != UINT_MAX ? normal - 1 : UINT_MAX;
+
+		if (tiler->numberOfCorners < 3) {
+			tiler->corners[tiler->numberOfCorners++] = key;
+		}
+		else {
+			tiler->corners[1] = tiler->corners[2];
+			tiler->corners[2] = key;
+		}
+
+		if (tiler->numberOfCorners == 3) {
+			JIIObjStatus status = JIIObjAddTileTriangle(tiler);
+			if (status != JIIObjStatus::Ok) {
+				return status;
+			}
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjCloseTileTemporary(JIIObjTiler* tiler, JIIObjTileTemporary temporary) {
+	FILE* file = tiler->temporaries[temporary];
+	tiler->temporaries[temporary] = NULL;
+
+	if (fclose(file) != 0) {
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjStatus status = JIIObjMapFile(tiler->temporaryPaths[temporary], &tiler->mappings[temporary]);
+	tiler->mapped[temporary] = status == JIIObjStatus::Ok;
+
+	return status;
+}
+
+// sorts the triangles by tile without holding more than JII_OBJ_TILE_SCATTER_SIZE of them
+JIIPrivate JIIObjStatus JIIObjSortTileTriangles(JIIObjTiler* tiler, u32 numberOfTiles) {
+	JIITraceScope("JIIObjSortTileTriangles");
+
+	FILE* sorted = tiler->temporaries[JIIObjTileTemporary::TileSorted];
+	const JIIObjTileTriangle* triangles = (const JIIObjTileTriangle*)tiler->mappings[JIIObjTileTemporary::TileTriangles].data;
+
+	u64 perTile = JII_OBJ_TILE_SCATTER_SIZE / sizeof(JIIObjTileTriangle) / numberOfTiles;
+	u32 bufferSize = perTile ? (perTile < 4096 ? (u32)perTile : 4096) : 1;
+
+	JIIObjTileTriangle* buffers = (JIIObjTileTriangle*)JIIMalloc(sizeof(JIIObjTileTriangle) * bufferSize * (u64)numberOfTiles);
+	u32* buffered = (u32*)JIIMalloc(sizeof(u32) * numberOfTiles);
+	u64* cursors = (u64*)JIIMalloc(sizeof(u64) * numberOfTiles);
+	memset(buffered, 0, sizeof(u32) * numberOfTiles);
+	memcpy(cursors, tiler->tileOffsets, sizeof(u64) * numberOfTiles);
+
+	JIIObjStatus status = JIIObjStatus::Ok;
+	for (u64 i = 0; i <= tiler->numberOfTriangles && status == JIIObjStatus::Ok; ++i) {
+		// the last round flushes whatever is left
+		u32 first = 0;
+		u32 last = numberOfTiles;
+		if (i < tiler->numberOfTriangles) {
+			u32 tile = triangles[i].tile;
+			buffers[(u64)tile * bufferSize + buffered[tile]++] = triangles[i];
+			if (buffered[tile] < bufferSize) {
+				continue;
+			}
+			first = tile;
+			last = tile + 1;
+		}
+
+		for (u32 tile = first; tile < last; ++tile) {
+			if (buffered[tile] == 0) {
+				continue;
+			}
+
+			u64 offset = cursors[tile] * sizeof(JIIObjTileTriangle);
+#if defined(_WIN32) || defined(_WIN64)
+			int seek = _fseeki64(sorted, (long long)offset, SEEK_SET);
+#else
+			int seek = fseeko(sorted, (off_t)offset, SEEK_SET);
+#endif
+			if (seek != 0 ||
+				fwrite(&buffers[(u64)tile * bufferSize], sizeof(JIIObjTileTriangle), buffered[tile], sorted) != buffered[tile]) {
+				status = JIIObjStatus::Error;
+				break;
+			}
+
+			cursors[tile] += buffered[tile];
+			buffered[tile] = 0;
+		}
+	}
+
+	JIIFree(cursors);
+	JIIFree(buffered);
+	JIIFree(buffers);
+
+	return status;
+}
+
+// builds one tile with its own vertices and writes it out, attributes come out of the mapped temporaries
+JIIPrivate JIIObjStatus JIIObjWriteTile(JIIObjTiler* tiler, JIIObjTile* tile) {
+	u32 index = (tile->z * tiler->options.tilesY + tile->y) * tiler->options.tilesX + tile->x;
+	const JIIObjTileTriangle* triangles = (const JIIObjTileTriangle*)tiler->mappings[JIIObjTileTemporary::TileSorted].data + tiler->tileOffsets[index];
+	u32 numberOfTriangles = tile->numberOfTriangles;
+
+	const JIIObjPosition* positions = (const JIIObjPosition*)tiler->mappings[JIIObjTileTemporary::TilePositions].data;
+	const JIIObjUV* uvs = (const JIIObjUV*)tiler->mappings[JIIObjTileTemporary::TileUVs].data;
+	const JIIObjNormal* normals = (const JIIObjNormal*)tiler->mappings[JIIObjTileTemporary::TileNormals].data;
+
+	JIIObjContext context = {};
+	JIIObjAllocateVertexTable(&context, numberOfTriangles * 3);
+
+	JIIObjModelData model = {};
+	model.faces = (JIIObjFace*)JIIMalloc(sizeof(JIIObjFace) * numberOfTriangles);
+	model.numberOfFaces = (i32)numberOfTriangles;
+	model.vertices = (JIIObjVertex*)JIIMalloc(sizeof(JIIObjVertex) * numberOfTriangles * 3);
+
+	bool hasUVs = false;
+	bool hasNormals = false;
+	for (u32 i = 0; i < numberOfTriangles; ++i) {
+		for (u32 corner = 0; corner < 3; ++corner) {
+			const JIIObjVertexKey* key = &triangles[i].corners[corner];
+			u32 vertexIndex = JIIObjFindOrAddVertex(&context, key);
+			model.faces[i].indices[corner] = (i32)vertexIndex;
+
+			if (vertexIndex + 1 != context.usedVertices) {
+				continue;
+			}
+
+			JIIObjVertex* vertex = &model.vertices[vertexIndex];
+			*vertex = {};
+			vertex->position = positions[key->position];
+			if (key->uv != UINT_MAX) {
+				vertex->uv = uvs[key->uv];
+				hasUVs = true;
+			}
+			if (key->normal != UINT_MAX) {
+				vertex->normal = normals[key->normal];
+				hasNormals = true;
+			}
+
+			if (vertexIndex == 0) {
+				tile->min = tile->max = vertex->position;
+			}
+			tile->min.x = fminf(tile->min.x, vertex->position.x);
+			tile->min.y = fminf(tile->min.y, vertex->position.y);
+			tile->min.z = fminf(tile->min.z, vertex->position.z);
+			tile->max.x = fmaxf(tile->max.x, vertex->position.x);
+			tile->max.y = fmaxf(tile->max.y, vertex->position.y);
+			tile->max.z = fmaxf(tile->max.z, vertex->position.z);
+		}
+	}
+
+	// the writer takes everything from the vertices, the counts only say which attributes exist
+	model.numberOfVertices = (i32)context.usedVertices;
+	model.numberOfPositions = model.numberOfVertices;
+	model.numberOfUVs = hasUVs ? model.numberOfVertices : 0;
+	model.numberOfNormals = hasNormals ? model.numberOfVertices : 0;
+
+	char tilePath[4096];
+	JIIObjStatus status = JIIObjStatus::Error;
+	if (JIIObjGetTilePath(tiler->outputPath, tile, tilePath, sizeof(tilePath))) {
+		status = JIIObjWriteData(tilePath, &model, tiler->options.hints);
+	}
+
+	JIIFree(model.vertices);
+	JIIFree(model.faces);
+	JIIObjFreeContextScratch(&context);
+
+	return status;
+}
+
+#define JII_OBJ_TILES_MAGIC 0x5449494a // JIIT
+#define JII_OBJ_TILES_VERSION 1
+
+struct JIIObjTileIndexHeader {
+	u32 magic;
+	u32 version;
+	u32 tilesX;
+	u32 tilesY;
+	u32 tilesZ;
+	u32 numberOfTiles;
+	JIIObjPosition min;
+	JIIObjPosition max;
+};
+
+JIIPrivate JIIObjStatus JIIObjWriteTileIndex(JIIObjTiler* tiler, JIIObjTile* tiles, u32 numberOfTiles) {
+	char indexPath[4096];
+	u64 length = strlen(tiler->outputPath);
+	if (length + sizeof(".jiitiles") > sizeof(indexPath)) {
+		return JIIObjStatus::Error;
+	}
+	memcpy(indexPath, tiler->outputPath, length);
+	memcpy(indexPath + length, ".jiitiles", sizeof(".jiitiles"));
+
+	FILE* file = JIIObjOpenFile(indexPath, "wb");
+	if (!file) {
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjTileIndexHeader header = {};
+	header.magic = JII_OBJ_TILES_MAGIC;
+	header.version = JII_OBJ_TILES_VERSION;
+	header.tilesX = tiler->options.tilesX;
+	header.tilesY = tiler->options.tilesY;
+	header.tilesZ = tiler->options.tilesZ;
+	header.numberOfTiles = numberOfTiles;
+	header.min = tiler->min;
+	header.max = tiler->max;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && fwrite(tiles, sizeof(JIIObjTile), numberOfTiles, file) == numberOfTiles;
+
+	if (fclose(file) != 0 || !written) {
+		remove(indexPath);
+		return JIIObjStatus::Error;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjRunTiler(JIIObjTiler* tiler, FILE* source) {
+	JIIObjTileOptions* options = &tiler->options;
+	u64 numberOfTiles = (u64)options->tilesX * options->tilesY * options->tilesZ;
+	if (numberOfTiles > UINT32_MAX) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	for (u32 i = 0; i < JIIObjTileTemporary::TileTemporaries; ++i) {
+		u64 length = strlen(tiler->outputPath);
+		u64 suffixLength = strlen(jii_ObjTileTemporaryNames[i]);
+		if (length + suffixLength + 1 > sizeof(tiler->temporaryPaths[i])) {
+			return JIIObjStatus::Error;
+		}
+		memcpy(tiler->temporaryPaths[i], tiler->outputPath, length);
+		memcpy(tiler->temporaryPaths[i] + length, jii_ObjTileTemporaryNames[i], suffixLength + 1);
+
+		tiler->temporaries[i] = JIIObjOpenFile(tiler->temporaryPaths[i], i == JIIObjTileTemporary::TileSorted ? "w+b" : "wb");
+		if (!tiler->temporaries[i]) {
+			return JIIObjStatus::Error;
+		}
+	}
+
+	u8* buffer = (u8*)JIIMalloc(JII_OBJ_TILE_READ_SIZE);
+	tiler->tileCounts = (u64*)JIIMalloc(sizeof(u64) * numberOfTiles);
+	tiler->tileOffsets = (u64*)JIIMalloc(sizeof(u64) * numberOfTiles);
+	memset(tiler->tileCounts, 0, sizeof(u64) * numberOfTiles);
+
+	tiler->min = { INFINITY, INFINITY, INFINITY };
+	tiler->max = { -INFINITY, -INFINITY, -INFINITY };
+
+	// first the attributes, faces may point at attributes further down
+	JIIObjStatus status;
+	{
+		JIITraceScope("JIIObjTileAttributes");
+		status = JIIObjForEachLine(source, buffer, JII_OBJ_TILE_READ_SIZE, JIIObjTileAttributeLine, tiler);
+	}
+	for (u32 i = JIIObjTileTemporary::TilePositions; i <= JIIObjTileTemporary::TileNormals; ++i) {
+		JIIObjStatus closeStatus = JIIObjCloseTileTemporary(tiler, (JIIObjTileTemporary)i);
+		status = status == JIIObjStatus::Ok ? closeStatus : status;
+	}
+
+	if (status == JIIObjStatus::Ok) {
+		JIITraceScope("JIIObjTileFaces");
+		status = JIIObjForEachLine(source, buffer, JII_OBJ_TILE_READ_SIZE, JIIObjTileFaceLine, tiler);
+	}
+	JIIFree(buffer);
+
+	if (status == JIIObjStatus::Ok) {
+		status = JIIObjCloseTileTemporary(tiler, JIIObjTileTemporary::TileTriangles);
+	}
+
+	JIIObjTile* tiles = NULL;
+	u32 numberOfUsedTiles = 0;
+	if (status == JIIObjStatus::Ok) {
+		u64 offset = 0;
+		for (u64 i = 0; i < numberOfTiles; ++i) {
+			tiler->tileOffsets[i] = offset;
+			offset += tiler->tileCounts[i];
+			numberOfUsedTiles += tiler->tileCounts[i] ? 1 : 0;
+		}
+
+		status = JIIObjSortTileTriangles(tiler, (u32)numberOfTiles);
+	}
+
+	if (status == JIIObjStatus::Ok) {
+		status = JIIObjCloseTileTemporary(tiler, JIIObjTileTemporary::TileSorted);
+	}
+
+	if (status == JIIObjStatus::Ok) {
+		JIITraceScope("JIIObjWriteTiles");
+
+		tiles = (JIIObjTile*)JIIMalloc(sizeof(JIIObjTile) * (numberOfUsedTiles + 1));
+		u32 usedTile = 0;
+		for (u64 i = 0; i < numberOfTiles && status == JIIObjStatus::Ok; ++i) {
+			if (tiler->tileCounts[i] == 0) {
+				continue;
+			}
+
+			if (tiler->tileCounts[i] > INT32_MAX / 3) {
+				status = JIIObjStatus::OutOfSpace;
+				break;
+			}
+
+			JIIObjTile* tile = &tiles[usedTile++];
+			*tile = {};
+			tile->x = (u32)(i % options->tilesX);
+			tile->y = (u32)(i / options->tilesX % options->tilesY);
+			tile->z = (u32)(i / options->tilesX / options->tilesY);
+			tile->numberOfTriangles = (u32)tiler->tileCounts[i];
+			status = JIIObjWriteTile(tiler, tile);
+		}
+	}
+
+	if (status == JIIObjStatus::Ok) {
+		status = JIIObjWriteTileIndex(tiler, tiles, numberOfUsedTiles);
+	}
+
+	JIIFree(tiles);
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjTileFile(const char* path, const char* outputPath, JIIObjTileOptions* options) {
+	JIIAssert(path && outputPath);
+	JIITraceScope("JIIObjTileFile");
+
+	JIIObjTiler tiler = {};
+	tiler.outputPath = outputPath;
+	if (options) {
+		tiler.options = *options;
+	}
+	tiler.options.tilesX = tiler.options.tilesX ? tiler.options.tilesX : JII_OBJ_DEFAULT_TILES;
+	tiler.options.tilesY = tiler.options.tilesY ? tiler.options.tilesY : JII_OBJ_DEFAULT_TILES;
+	tiler.options.tilesZ = tiler.options.tilesZ ? tiler.options.tilesZ : JII_OBJ_DEFAULT_TILES;
+
+	FILE* source = JIIObjOpenFile(path, "rb");
+	if (!source) {
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjStatus status = JIIObjRunTiler(&tiler, source);
+	fclose(source);
+
+	for (u32 i = 0; i < JIIObjTileTemporary::TileTemporaries; ++i) {
+		if (tiler.temporaries[i]) {
+			fclose(tiler.temporaries[i]);
+		}
+		if (tiler.mapped[i]) {
+			JIIObjUnmapFile(&tiler.mappings[i]);
+		}
+		if (tiler.temporaryPaths[i][0]) {
+			remove(tiler.temporaryPaths[i]);
+		}
+	}
+	JIIFree(tiler.tileCounts);
+	JIIFree(tiler.tileOffsets);
+
+	return status;
+}
+
+JIIDef JIIObjStatus JIIObjLoadTileIndex(const char* path, JIIObjTileIndex* index) {
+	JIIAssert(path && index);
+
+	*index = {};
+
+	FILE* file = JIIObjOpenFile(path, "rb");
+	if (!file) {
+		return JIIObjStatus::Error;
+	}
+
+	JIIObjTileIndexHeader header;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+		header.magic == JII_OBJ_TILES_MAGIC && header.version == JII_OBJ_TILES_VERSION;
+
+	if (valid) {
+		index->tiles = (JIIObjTile*)JIIMalloc(sizeof(JIIObjTile) * ((u64)header.numberOfTiles + 1));
+		valid = fread(index->tiles, sizeof(JIIObjTile), header.numberOfTiles, file) == header.numberOfTiles;
+	}
+
+	fclose(file);
+
+	if (!valid) {
+		JIIFree(index->tiles);
+		*index = {};
+		return JIIObjStatus::Error;
+	}
+
+	index->tilesX = header.tilesX;
+	index->tilesY = header.tilesY;
+	index->tilesZ = header.tilesZ;
+	index->min = header.min;
+	index->max = header.max;
+	index->numberOfTiles = header.numberOfTiles;
+
+	return JIIObjStatus::Ok;
+}
+
+JIIDef void JIIObjFreeTileIndex(JIIObjTileIndex* index) {
+	JIIAssert(index);
+
+	JIIFree(index->tiles);
+	*index = {};
+}
+
+JIIDef bool JIIObjGetTilePath(const char* outputPath, const JIIObjTile* tile, char* path, u32 maxSize) {
+	JIIAssert(outputPath && tile && path);
+
+	int length = snprintf(path, maxSize, "%s_%u_%u_%u.obj", outputPath, tile->x, tile->y, tile->z);
+	return length >= 0 && (u32)length < maxSize;
+}
+
+// binary formats come in a fixed byte order, values get swapped when it isn't ours
+JIIPrivate bool JIIObjIsLittleEndianHost() {
+	u16 value = 1;
+	u8 first;
+	memcpy(&first, &value, 1);
+	return first == 1;
+}
+
+JIIPrivate u16 JIIObjSwap16(u16 value) {
+	return (u16)((value >> 8) | (value << 8));
+}
+
+JIIPrivate u32 JIIObjSwap32(u32 value) {
+	return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+}
+
+JIIPrivate u64 JIIObjSwap64(u64 value) {
+	return ((u64)JIIObjSwap32((u32)value) << 32) | JIIObjSwap32((u32)(value >> 32));
+}
+
+JIIPrivate u32 JIIObjReadU32(const u8* source, bool swap) {
+	u32 value;
+	memcpy(&value, source, sizeof(value));
+	return swap ? JIIObjSwap32(value) : value;
+}
+
+JIIPrivate float JIIObjReadF32(const u8* source, bool swap) {
+	u32 bits = JIIObjReadU32(source, swap);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// 80 byte header, u32 triangle count, then 50 bytes per triangle: normal, 3 positions and an u16 nobody uses
+#define JII_OBJ_STL_HEADER_SIZE 84
+#define JII_OBJ_STL_TRIANGLE_SIZE 50
+
+struct JIIObjSTLContext {
+	const u8* triangles;
+	bool swap;
+	JIIObjModelData* data;
+};
+
+JIIPrivate void JIIObjSTLRangeProc(void* data, u32 begin, u32 end) {
+	JIIObjSTLContext* context = (JIIObjSTLContext*)data;
+	JIIObjModelData* model = context->data;
+	bool swap = context->swap;
+
+	for (u32 i = begin; i < end; ++i) {
+		const u8* triangle = context->triangles + (u64)i * JII_OBJ_STL_TRIANGLE_SIZE;
+
+		JIIObjNormal normal = { JIIObjReadF32(triangle, swap), JIIObjReadF32(triangle + 4, swap), JIIObjReadF32(triangle + 8, swap) };
+		model->normals[i] = normal;
+
+		JIIObjFace face = {};
+		for (u32 corner = 0; corner < 3; ++corner) {
+			const u8* source = triangle + 12 + corner * 12;
+			u32 index = i * 3 + corner;
+
+			JIIObjVertex vertex = {};
+			vertex.position = { JIIObjReadF32(source, swap), JIIObjReadF32(source + 4, swap), JIIObjReadF32(source + 8, swap) };
+			vertex.normal = normal;
+
+			model->positions[index] = vertex.position;
+			model->vertices[index] = vertex;
+			face.indices[corner] = (i32)index;
+		}
+
+		model->faces[i] = face;
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjParseSTLBuffer(const u8* buffer, u64 size, JIIObjModelData* data) {
+	JIIAssert(data);
+	JIITraceScope("JIIObjParseSTLBuffer");
+
+	*data = {};
+
+	if (size < JII_OBJ_STL_HEADER_SIZE) {
+		return JIIObjStatus::Error;
+	}
+
+	bool swap = !JIIObjIsLittleEndianHost();
+	u32 numberOfTriangles = JIIObjReadU32(buffer + 80, swap);
+
+	// ascii stl files (and broken binary ones) don't add up
+	if (JII_OBJ_STL_HEADER_SIZE + (u64)numberOfTriangles * JII_OBJ_STL_TRIANGLE_SIZE > size ||
+		(u64)numberOfTriangles * 3 > INT32_MAX) {
+		return JIIObjStatus::Error;
+	}
+
+	// stl has no indexing, every triangle gets its own corners
+	data->numberOfPositions = numberOfTriangles * 3;
+	data->numberOfNormals = numberOfTriangles;
+	data->numberOfFaces = numberOfTriangles;
+	data->numberOfVertices = numberOfTriangles * 3;
+	JIIObjAllocateModelData(data);
+
+	JIIObjSTLContext context = {};
+	context.triangles = buffer + JII_OBJ_STL_HEADER_SIZE;
+	context.swap = swap;
+	context.data = data;
+
+	JIIObjParallelFor(numberOfTriangles, 1 << 14, JIIObjSTLRangeProc, &context);
+
+	return JIIObjStatus::Ok;
+}
+
+enum JIIObjPlyFormat {
+	PlyAscii,
+	PlyBinaryLittleEndian,
+	PlyBinaryBigEndian
+};
+
+enum JIIObjPlyType {
+	PlyNone,
+	PlyInt8,
+	PlyUInt8,
+	PlyInt16,
+	PlyUInt16,
+	PlyInt32,
+	PlyUInt32,
+	PlyFloat32,
+	PlyFloat64
+};
+
+enum JIIObjPlyRole {
+	PlyIgnored,
+	PlyX,
+	PlyY,
+	PlyZ,
+	PlyNX,
+	PlyNY,
+	PlyNZ,
+	PlyU,
+	PlyV,
+	PlyVertexIndices,
+	PlyRoleCount
+};
+
+#define JII_OBJ_PLY_MAX_PROPERTIES 32
+#define JII_OBJ_PLY_MAX_ELEMENTS 16
+
+struct JIIObjPlyProperty {
+	JIIObjPlyType type;
+	// PlyNone when the property is not a list
+	JIIObjPlyType countType;
+	JIIObjPlyRole role;
+	// byte offset inside the element, only valid when the element has a fixed stride
+	u32 offset;
+};
+
+struct JIIObjPlyElement {
+	bool isVertex;
+	bool isFace;
+	u64 count;
+
+	JIIObjPlyProperty properties[JII_OBJ_PLY_MAX_PROPERTIES];
+	u32 numberOfProperties;
+
+	// 0 when some property is a list
+	u32 stride;
+};
+
+struct JIIObjPlyReader {
+	const u8* buffer;
+	u64 size;
+	u64 cursor;
+
+	JIIObjPlyFormat format;
+	bool swap;
+};
+
+JIIPrivate u32 JIIObjPlyTypeSize(JIIObjPlyType type) {
+	switch (type) {
+		case JIIObjPlyType::PlyInt8:
+		case JIIObjPlyType::PlyUInt8: return 1;
+		case JIIObjPlyType::PlyInt16:
+		case JIIObjPlyType::PlyUInt16: return 2;
+		case JIIObjPlyType::PlyInt32:
+		case JIIObjPlyType::PlyUInt32:
+		case JIIObjPlyType::PlyFloat32: return 4;
+		case JIIObjPlyType::PlyFloat64: return 8;
+		default: return 0;
+	}
+}
 
-	if (lineBuffer[*offset] == '.') {
-		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+JIIPrivate bool JIIObjWordEquals(const u8* word, u32 length, const char* literal) {
+	u32 literalLength = (u32)strlen(literal);
+	return length == literalLength && memcmp(word, literal, length) == 0;
+}
+
+JIIPrivate JIIObjPlyType JIIObjPlyParseType(const u8* word, u32 length) {
+	if (JIIObjWordEquals(word, length, "char") || JIIObjWordEquals(word, length, "int8")) return JIIObjPlyType::PlyInt8;
+	if (JIIObjWordEquals(word, length, "uchar") || JIIObjWordEquals(word, length, "uint8")) return JIIObjPlyType::PlyUInt8;
+	if (JIIObjWordEquals(word, length, "short") || JIIObjWordEquals(word, length, "int16")) return JIIObjPlyType::PlyInt16;
+	if (JIIObjWordEquals(word, length, "ushort") || JIIObjWordEquals(word, length, "uint16")) return JIIObjPlyType::PlyUInt16;
+	if (JIIObjWordEquals(word, length, "int") || JIIObjWordEquals(word, length, "int32")) return JIIObjPlyType::PlyInt32;
+	if (JIIObjWordEquals(word, length, "uint") || JIIObjWordEquals(word, length, "uint32")) return JIIObjPlyType::PlyUInt32;
+	if (JIIObjWordEquals(word, length, "float") || JIIObjWordEquals(word, length, "float32")) return JIIObjPlyType::PlyFloat32;
+	if (JIIObjWordEquals(word, length, "double") || JIIObjWordEquals(word, length, "float64")) return JIIObjPlyType::PlyFloat64;
+	return JIIObjPlyType::PlyNone;
+}
+
+JIIPrivate JIIObjPlyRole JIIObjPlyParseRole(const u8* word, u32 length, bool isVertex, bool isFace) {
+	if (isVertex) {
+		if (JIIObjWordEquals(word, length, "x")) return JIIObjPlyRole::PlyX;
+		if (JIIObjWordEquals(word, length, "y")) return JIIObjPlyRole::PlyY;
+		if (JIIObjWordEquals(word, length, "z")) return JIIObjPlyRole::PlyZ;
+		if (JIIObjWordEquals(word, length, "nx")) return JIIObjPlyRole::PlyNX;
+		if (JIIObjWordEquals(word, length, "ny")) return JIIObjPlyRole::PlyNY;
+		if (JIIObjWordEquals(word, length, "nz")) return JIIObjPlyRole::PlyNZ;
+		// nobody agrees on the texture coordinate names
+		if (JIIObjWordEquals(word, length, "u") || JIIObjWordEquals(word, length, "s") ||
+			JIIObjWordEquals(word, length, "texture_u") || JIIObjWordEquals(word, length, "texture_s")) return JIIObjPlyRole::PlyU;
+		if (JIIObjWordEquals(word, length, "v") || JIIObjWordEquals(word, length, "t") ||
+			JIIObjWordEquals(word, length, "texture_v") || JIIObjWordEquals(word, length, "texture_t")) return JIIObjPlyRole::PlyV;
 	}
+	if (isFace) {
+		if (JIIObjWordEquals(word, length, "vertex_indices") || JIIObjWordEquals(word, length, "vertex_index")) return JIIObjPlyRole::PlyVertexIndices;
+	}
+	return JIIObjPlyRole::PlyIgnored;
+}
 
-	while (JIIObjIsDigit(lineBuffer[*offset])) {
-		result = result * 10 + (lineBuffer[*offset] - '0');
-		power *= 10;
+// words are separated by spaces and tabs, returns false at the end of the line
+JIIPrivate bool JIIObjPlyNextWord(const u8* line, u32 lineSize, u32* offset, const u8** word, u32* length) {
+	while (*offset < lineSize && JIIObjIsWhitespace(line[*offset])) {
+		++(*offset);
+	}
 
-		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+	if (*offset >= lineSize) {
+		return false;
 	}
 
-	if (lineBuffer[*offset] == 'e' || lineBuffer[*offset] == 'E') {
-		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
+	*word = line + *offset;
+	while (*offset < lineSize && !JIIObjIsWhitespace(line[*offset])) {
+		++(*offset);
+	}
+	*length = (u32)(line + *offset - *word);
+
+	return true;
+}
+
+JIIPrivate JIIObjStatus JIIObjPlyParseHeader(const u8* buffer, u64 size, JIIObjPlyElement* elements, u32* numberOfElements, JIIObjPlyReader* reader) {
+	if (size < 4 || memcmp(buffer, "ply", 3) != 0 || !JIIObjIsLineEnd(buffer[3])) {
+		return JIIObjStatus::Error;
+	}
+
+	*numberOfElements = 0;
+	bool hasFormat = false;
+
+	u64 cursor = 0;
+	while (cursor < size) {
+		u64 lineStart = cursor;
+		while (cursor < size && buffer[cursor] != '\n') {
+			++cursor;
+		}
+		u64 lineEnd = cursor;
+		if (lineEnd > lineStart && buffer[lineEnd - 1] == '\r') {
+			--lineEnd;
+		}
+		// skip the '\n'
+		++cursor;
+
+		const u8* line = buffer + lineStart;
+		u32 lineSize = (u32)(lineEnd - lineStart);
+		u32 offset = 0;
+
+		const u8* word;
+		u32 length;
+		if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+			continue;
+		}
+
+		if (JIIObjWordEquals(word, length, "end_header")) {
+			if (!hasFormat || cursor > size) {
+				return JIIObjStatus::Error;
+			}
+			reader->buffer = buffer;
+			reader->size = size;
+			reader->cursor = cursor;
+			return JIIObjStatus::Ok;
+		}
+		else if (JIIObjWordEquals(word, length, "format")) {
+			if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+				return JIIObjStatus::Error;
+			}
+
+			if (JIIObjWordEquals(word, length, "ascii")) {
+				reader->format = JIIObjPlyFormat::PlyAscii;
+			}
+			else if (JIIObjWordEquals(word, length, "binary_little_endian")) {
+				reader->format = JIIObjPlyFormat::PlyBinaryLittleEndian;
+			}
+			else if (JIIObjWordEquals(word, length, "binary_big_endian")) {
+				reader->format = JIIObjPlyFormat::PlyBinaryBigEndian;
+			}
+			else {
+				return JIIObjStatus::Error;
+			}
+
+			bool fileIsLittleEndian = reader->format == JIIObjPlyFormat::PlyBinaryLittleEndian;
+			reader->swap = reader->format != JIIObjPlyFormat::PlyAscii && fileIsLittleEndian != JIIObjIsLittleEndianHost();
+			hasFormat = true;
+		}
+		else if (JIIObjWordEquals(word, length, "element")) {
+			if (*numberOfElements >= JII_OBJ_PLY_MAX_ELEMENTS) {
+				return JIIObjStatus::OutOfSpace;
+			}
+
+			JIIObjPlyElement* element = &elements[(*numberOfElements)++];
+			*element = {};
+
+			if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+				return JIIObjStatus::Error;
+			}
+			element->isVertex = JIIObjWordEquals(word, length, "vertex");
+			element->isFace = JIIObjWordEquals(word, length, "face");
+
+			if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+				return JIIObjStatus::Error;
+			}
+			for (u32 i = 0; i < length; ++i) {
+				if (!JIIObjIsDigit(word[i])) {
+					return JIIObjStatus::Error;
+				}
+				element->count = element->count * 10 + (word[i] - '0');
+			}
+		}
+		else if (JIIObjWordEquals(word, length, "property")) {
+			if (*numberOfElements == 0) {
+				return JIIObjStatus::Error;
+			}
+
+			JIIObjPlyElement* element = &elements[*numberOfElements - 1];
+			if (element->numberOfProperties >= JII_OBJ_PLY_MAX_PROPERTIES) {
+				return JIIObjStatus::OutOfSpace;
+			}
+
+			JIIObjPlyProperty* property = &element->properties[element->numberOfProperties++];
+			*property = {};
+
+			if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+				return JIIObjStatus::Error;
+			}
+
+			if (JIIObjWordEquals(word, length, "list")) {
+				if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+					return JIIObjStatus::Error;
+				}
+				property->countType = JIIObjPlyParseType(word, length);
+				if (property->countType == JIIObjPlyType::PlyNone) {
+					return JIIObjStatus::Error;
+				}
+
+				if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+					return JIIObjStatus::Error;
+				}
+			}
+
+			property->type = JIIObjPlyParseType(word, length);
+			if (property->type == JIIObjPlyType::PlyNone) {
+				return JIIObjStatus::Error;
+			}
+
+			if (!JIIObjPlyNextWord(line, lineSize, &offset, &word, &length)) {
+				return JIIObjStatus::Error;
+			}
+			property->role = JIIObjPlyParseRole(word, length, element->isVertex, element->isFace);
+		}
+		// comment, obj_info and whatever else can be skipped
+	}
+
+	return JIIObjStatus::Error;
+}
+
+JIIPrivate void JIIObjPlyComputeStride(JIIObjPlyElement* element) {
+	u32 stride = 0;
+	for (u32 i = 0; i < element->numberOfProperties; ++i) {
+		JIIObjPlyProperty* property = &element->properties[i];
+		if (property->countType != JIIObjPlyType::PlyNone) {
+			element->stride = 0;
+			return;
+		}
+		property->offset = stride;
+		stride += JIIObjPlyTypeSize(property->type);
+	}
+	element->stride = stride;
+}
+
+JIIPrivate double JIIObjPlyDecodeBinary(const u8* source, JIIObjPlyType type, bool swap) {
+	switch (type) {
+		case JIIObjPlyType::PlyInt8: return (double)(i8)source[0];
+		case JIIObjPlyType::PlyUInt8: return (double)source[0];
+		case JIIObjPlyType::PlyInt16: {
+			u16 value;
+			memcpy(&value, source, 2);
+			return (double)(i16)(swap ? JIIObjSwap16(value) : value);
+		}
+		case JIIObjPlyType::PlyUInt16: {
+			u16 value;
+			memcpy(&value, source, 2);
+			return (double)(swap ? JIIObjSwap16(value) : value);
+		}
+		case JIIObjPlyType::PlyInt32: return (double)(i32)JIIObjReadU32(source, swap);
+		case JIIObjPlyType::PlyUInt32: return (double)JIIObjReadU32(source, swap);
+		case JIIObjPlyType::PlyFloat32: return (double)JIIObjReadF32(source, swap);
+		case JIIObjPlyType::PlyFloat64: {
+			u64 bits;
+			memcpy(&bits, source, 8);
+			if (swap) {
+				bits = JIIObjSwap64(bits);
+			}
+			double value;
+			memcpy(&value, &bits, 8);
+			return value;
+		}
+		default: return 0;
+	}
+}
+
+JIIPrivate bool JIIObjPlyIsSpace(u8 c) {
+	return JIIObjIsWhitespace(c) || JIIObjIsLineEnd(c);
+}
+
+JIIPrivate bool JIIObjPlyReadValue(JIIObjPlyReader* reader, JIIObjPlyType type, double* value) {
+	if (reader->format != JIIObjPlyFormat::PlyAscii) {
+		u32 size = JIIObjPlyTypeSize(type);
+		if (reader->cursor + size > reader->size) {
+			return false;
+		}
+		*value = JIIObjPlyDecodeBinary(reader->buffer + reader->cursor, type, reader->swap);
+		reader->cursor += size;
+		return true;
+	}
+
+	while (reader->cursor < reader->size && JIIObjPlyIsSpace(reader->buffer[reader->cursor])) {
+		++reader->cursor;
+	}
+
+	u64 tokenStart = reader->cursor;
+	while (reader->cursor < reader->size && !JIIObjPlyIsSpace(reader->buffer[reader->cursor])) {
+		++reader->cursor;
+	}
+
+	u64 tokenSize = reader->cursor - tokenStart;
+	if (tokenSize == 0 || tokenSize > 64) {
+		return false;
+	}
+
+	u8* token = (u8*)reader->buffer + tokenStart;
+	u32 offset = 0;
+	if (type == JIIObjPlyType::PlyFloat32 || type == JIIObjPlyType::PlyFloat64) {
+		*value = JIIObjEatFloat(token, (u32)tokenSize, &offset);
 	}
 	else {
-		return sign * (result / power);
+		// floats would lose precision on big indices
+		bool negative = token[0] == '-';
+		offset = negative ? 1 : 0;
+		double integer = offset < tokenSize ? (double)JIIObjEatU32(token, (u32)tokenSize, &offset) : 0;
+		*value = negative ? -integer : integer;
 	}
 
-	i8 eSign = 1;
-	switch (lineBuffer[*offset]) {
-		case '-': {
-			eSign = -1;
-			++(*offset);
-			break;
+	return true;
+}
+
+JIIPrivate bool JIIObjPlySkipProperty(JIIObjPlyReader* reader, JIIObjPlyProperty* property) {
+	double value;
+	if (property->countType == JIIObjPlyType::PlyNone) {
+		return JIIObjPlyReadValue(reader, property->type, &value);
+	}
+
+	if (!JIIObjPlyReadValue(reader, property->countType, &value) || value < 0) {
+		return false;
+	}
+
+	u64 count = (u64)value;
+	if (reader->format != JIIObjPlyFormat::PlyAscii) {
+		u64 size = count * JIIObjPlyTypeSize(property->type);
+		if (reader->cursor + size > reader->size) {
+			return false;
 		}
-		case '+': {
-			++(*offset);
-			break;
+		reader->cursor += size;
+		return true;
+	}
+
+	for (u64 i = 0; i < count; ++i) {
+		if (!JIIObjPlyReadValue(reader, property->type, &value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+JIIPrivate bool JIIObjPlySkipElement(JIIObjPlyReader* reader, JIIObjPlyElement* element) {
+	if (reader->format != JIIObjPlyFormat::PlyAscii && element->stride) {
+		u64 size = element->count * element->stride;
+		if (reader->cursor + size > reader->size) {
+			return false;
+		}
+		reader->cursor += size;
+		return true;
+	}
+
+	for (u64 item = 0; item < element->count; ++item) {
+		for (u32 i = 0; i < element->numberOfProperties; ++i) {
+			if (!JIIObjPlySkipProperty(reader, &element->properties[i])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+JIIPrivate void JIIObjPlyStoreVertexValue(JIIObjVertex* vertex, JIIObjPlyRole role, double value) {
+	switch (role) {
+		case JIIObjPlyRole::PlyX: vertex->position.x = (float)value; break;
+		case JIIObjPlyRole::PlyY: vertex->position.y = (float)value; break;
+		case JIIObjPlyRole::PlyZ: vertex->position.z = (float)value; break;
+		case JIIObjPlyRole::PlyNX: vertex->normal.x = (float)value; break;
+		case JIIObjPlyRole::PlyNY: vertex->normal.y = (float)value; break;
+		case JIIObjPlyRole::PlyNZ: vertex->normal.z = (float)value; break;
+		case JIIObjPlyRole::PlyU: vertex->uv.u = (float)value; break;
+		case JIIObjPlyRole::PlyV: vertex->uv.v = (float)value; break;
+		default: break;
+	}
+}
+
+JIIPrivate void JIIObjPlyStoreVertex(JIIObjModelData* data, u32 index, JIIObjVertex* vertex) {
+	data->vertices[index] = *vertex;
+	data->positions[index] = vertex->position;
+	if (data->numberOfNormals) {
+		data->normals[index] = vertex->normal;
+	}
+	if (data->numberOfUVs) {
+		data->uvs[index] = vertex->uv;
+	}
+}
+
+struct JIIObjPlyVertexContext {
+	const u8* vertices;
+	JIIObjPlyElement* element;
+	bool swap;
+	JIIObjModelData* data;
+};
+
+// fixed stride binary vertices, the bulk of every scan
+JIIPrivate void JIIObjPlyVertexRangeProc(void* data, u32 begin, u32 end) {
+	JIIObjPlyVertexContext* context = (JIIObjPlyVertexContext*)data;
+	JIIObjPlyElement* element = context->element;
+
+	for (u32 i = begin; i < end; ++i) {
+		const u8* source = context->vertices + (u64)i * element->stride;
+
+		JIIObjVertex vertex = {};
+		for (u32 p = 0; p < element->numberOfProperties; ++p) {
+			JIIObjPlyProperty* property = &element->properties[p];
+			if (property->role == JIIObjPlyRole::PlyIgnored) {
+				continue;
+			}
+
+			double value;
+			if (property->type == JIIObjPlyType::PlyFloat32) {
+				value = JIIObjReadF32(source + property->offset, context->swap);
+			}
+			else {
+				value = JIIObjPlyDecodeBinary(source + property->offset, property->type, context->swap);
+			}
+			JIIObjPlyStoreVertexValue(&vertex, property->role, value);
+		}
+
+		JIIObjPlyStoreVertex(context->data, i, &vertex);
+	}
+}
+
+JIIPrivate JIIObjStatus JIIObjPlyReadVertices(JIIObjPlyReader* reader, JIIObjPlyElement* element, JIIObjModelData* data) {
+	if (reader->format != JIIObjPlyFormat::PlyAscii && element->stride) {
+		u64 size = element->count * element->stride;
+		if (reader->cursor + size > reader->size) {
+			return JIIObjStatus::Error;
+		}
+
+		JIIObjPlyVertexContext context = {};
+		context.vertices = reader->buffer + reader->cursor;
+		context.element = element;
+		context.swap = reader->swap;
+		context.data = data;
+
+		JIIObjParallelFor((u32)element->count, 1 << 14, JIIObjPlyVertexRangeProc, &context);
+
+		reader->cursor += size;
+		return JIIObjStatus::Ok;
+	}
+
+	for (u32 i = 0; i < (u32)element->count; ++i) {
+		JIIObjVertex vertex = {};
+		for (u32 p = 0; p < element->numberOfProperties; ++p) {
+			JIIObjPlyProperty* property = &element->properties[p];
+			if (property->countType != JIIObjPlyType::PlyNone) {
+				if (!JIIObjPlySkipProperty(reader, property)) {
+					return JIIObjStatus::Error;
+				}
+				continue;
+			}
+
+			double value;
+			if (!JIIObjPlyReadValue(reader, property->type, &value)) {
+				return JIIObjStatus::Error;
+			}
+			JIIObjPlyStoreVertexValue(&vertex, property->role, value);
+		}
+
+		JIIObjPlyStoreVertex(data, i, &vertex);
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// faces are fans, with count == 0 only the triangles get counted
+JIIPrivate JIIObjStatus JIIObjPlyReadFaces(JIIObjPlyReader* reader, JIIObjPlyElement* element, JIIObjModelData* data, u64* numberOfTriangles, bool count) {
+	u32 usedFaces = 0;
+
+	for (u64 item = 0; item < element->count; ++item) {
+		for (u32 p = 0; p < element->numberOfProperties; ++p) {
+			JIIObjPlyProperty* property = &element->properties[p];
+			if (property->role != JIIObjPlyRole::PlyVertexIndices || property->countType == JIIObjPlyType::PlyNone) {
+				if (!JIIObjPlySkipProperty(reader, property)) {
+					return JIIObjStatus::Error;
+				}
+				continue;
+			}
+
+			double value;
+			if (!JIIObjPlyReadValue(reader, property->countType, &value) || value < 0) {
+				return JIIObjStatus::Error;
+			}
+			u64 corners = (u64)value;
+
+			if (count) {
+				*numberOfTriangles += corners >= 3 ? corners - 2 : 0;
+				JIIObjPlyProperty indices = *property;
+				indices.countType = JIIObjPlyType::PlyNone;
+				for (u64 i = 0; i < corners; ++i) {
+					if (!JIIObjPlySkipProperty(reader, &indices)) {
+						return JIIObjStatus::Error;
+					}
+				}
+				continue;
+			}
+
+			i32 first = 0;
+			i32 previous = 0;
+			for (u64 i = 0; i < corners; ++i) {
+				if (!JIIObjPlyReadValue(reader, property->type, &value)) {
+					return JIIObjStatus::Error;
+				}
+				if (value < 0 || value >= data->numberOfVertices) {
+					return JIIObjStatus::Error;
+				}
+
+				i32 index = (i32)value;
+				if (i == 0) {
+					first = index;
+				}
+				else if (i >= 2) {
+					JIIObjFace* face = &data->faces[usedFaces++];
+					face->index0 = first;
+					face->index1 = previous;
+					face->index2 = index;
+				}
+				previous = index;
+			}
+		}
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+JIIPrivate JIIObjStatus JIIObjParsePLYBuffer(const u8* buffer, u64 size, JIIObjModelData* data) {
+	JIIAssert(data);
+	JIITraceScope("JIIObjParsePLYBuffer");
+
+	*data = {};
+
+	JIIObjPlyElement elements[JII_OBJ_PLY_MAX_ELEMENTS];
+	u32 numberOfElements;
+	JIIObjPlyReader reader = {};
+
+	JIIObjStatus status = JIIObjPlyParseHeader(buffer, size, elements, &numberOfElements, &reader);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
+
+	// everything gets sized from the header, except the faces that need to be triangulated
+	for (u32 i = 0; i < numberOfElements; ++i) {
+		JIIObjPlyElement* element = &elements[i];
+		JIIObjPlyComputeStride(element);
+
+		if (element->isVertex) {
+			if (element->count > INT32_MAX) {
+				return JIIObjStatus::Error;
+			}
+
+			data->numberOfPositions = (i32)element->count;
+			data->numberOfVertices = (i32)element->count;
+			for (u32 p = 0; p < element->numberOfProperties; ++p) {
+				JIIObjPlyRole role = element->properties[p].role;
+				if (role == JIIObjPlyRole::PlyNX || role == JIIObjPlyRole::PlyNY || role == JIIObjPlyRole::PlyNZ) {
+					data->numberOfNormals = (i32)element->count;
+				}
+				if (role == JIIObjPlyRole::PlyU || role == JIIObjPlyRole::PlyV) {
+					data->numberOfUVs = (i32)element->count;
+				}
+			}
+		}
+	}
+
+	JIIObjAllocateModelData(data);
+
+	bool facesRead = false;
+	for (u32 i = 0; i < numberOfElements && status == JIIObjStatus::Ok; ++i) {
+		JIIObjPlyElement* element = &elements[i];
+
+		if (element->isVertex) {
+			status = JIIObjPlyReadVertices(&reader, element, data);
+		}
+		else if (element->isFace && !facesRead) {
+			u64 faceStart = reader.cursor;
+			u64 numberOfTriangles = 0;
+
+			status = JIIObjPlyReadFaces(&reader, element, data, &numberOfTriangles, true);
+			if (status != JIIObjStatus::Ok) {
+				break;
+			}
+			if (numberOfTriangles > INT32_MAX) {
+				status = JIIObjStatus::Error;
+				break;
+			}
+
+			JIIFree(data->faces);
+			data->numberOfFaces = (i32)numberOfTriangles;
+			data->faces = (JIIObjFace*)JIIMalloc(sizeof(JIIObjFace) * numberOfTriangles);
+			facesRead = true;
+
+			reader.cursor = faceStart;
+			status = JIIObjPlyReadFaces(&reader, element, data, &numberOfTriangles, false);
+		}
+		else if (!JIIObjPlySkipElement(&reader, element)) {
+			status = JIIObjStatus::Error;
+		}
+	}
+
+	if (status != JIIObjStatus::Ok) {
+		JIIObjFreeData(data);
+		*data = {};
+	}
+
+	return status;
+}
+
+// welding shares positions between vertices and merges vertices, the uvs and normals follow the vertices
+// that are left so vertex i still has uv i and normal i, keys say where they were before
+JIIPrivate JIIObjStatus JIIObjRealignImportedAttributes(JIIObjModelData* data, const JIIObjVertexKey* keys) {
+	JIIAssert(data && keys);
+
+	u32 numberOfVertices = (u32)data->numberOfVertices;
+
+	JIIObjUV* uvs = NULL;
+	JIIObjNormal* normals = NULL;
+	if (data->numberOfUVs) {
+		uvs = (JIIObjUV*)JIIMalloc(sizeof(JIIObjUV) * numberOfVertices);
+	}
+	if (data->numberOfNormals) {
+		normals = (JIIObjNormal*)JIIMalloc(sizeof(JIIObjNormal) * numberOfVertices);
+	}
+	if (numberOfVertices && ((data->numberOfUVs && !uvs) || (data->numberOfNormals && !normals))) {
+		JIIFree(uvs);
+		JIIFree(normals);
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	for (u32 i = 0; i < numberOfVertices; ++i) {
+		if (uvs) {
+			uvs[i] = keys[i].uv != UINT_MAX ? data->uvs[keys[i].uv] : JIIObjUV{};
+		}
+		if (normals) {
+			normals[i] = keys[i].normal != UINT_MAX ? data->normals[keys[i].normal] : JIIObjNormal{};
+		}
+	}
+
+	if (data->numberOfUVs) {
+		JIIFree(data->uvs);
+		data->uvs = uvs;
+		data->numberOfUVs = (i32)numberOfVertices;
+	}
+	if (data->numberOfNormals) {
+		JIIFree(data->normals);
+		data->normals = normals;
+		data->numberOfNormals = (i32)numberOfVertices;
+	}
+
+	return JIIObjStatus::Ok;
+}
+
+// imported vertices are never shared, vertex i has position i, uv i and normal i (or one normal per
+// triangle, after welding that becomes one per vertex too)
+JIIPrivate JIIObjStatus JIIObjFinishImportedData(JIIObjModelData* data, JIIObjStatus status, JIIObjLoadOptions* options, bool normalPerTriangle) {
+	if (status == JIIObjStatus::Ok) {
+		JIIObjVertexKey* keys = NULL;
+		if (options && (options->hints & (JII_OBJ_WELD_POSITIONS | JII_OBJ_COMPACT))) {
+			keys = (JIIObjVertexKey*)JIIMalloc(sizeof(JIIObjVertexKey) * data->numberOfVertices);
+			if (!keys && data->numberOfVertices) {
+				JIIObjFreeData(data);
+				*data = {};
+				return JIIObjStatus::OutOfSpace;
+			}
+			for (i32 i = 0; i < data->numberOfVertices; ++i) {
+				keys[i].position = (u32)i;
+				keys[i].uv = i < data->numberOfUVs ? (u32)i : UINT_MAX;
+				keys[i].normal = normalPerTriangle ? (u32)i / 3 : (i < data->numberOfNormals ? (u32)i : UINT_MAX);
+			}
 		}
-		default: {
-			break;
+
+		status = JIIObjFinishLoad(data, keys, options, true);
+		// compacting gathers them in the order the vertices use them and leaves the keys behind
+		if (status == JIIObjStatus::Ok && keys && (options->hints & JII_OBJ_WELD_POSITIONS) && !(options->hints & JII_OBJ_COMPACT)) {
+			status = JIIObjRealignImportedAttributes(data, keys);
 		}
+		JIIFree(keys);
 	}
 
-	if (*offset >= lineSize) {
-		return sign * (result / power);
+	if (status != JIIObjStatus::Ok) {
+		JIIObjFreeData(data);
+		*data = {};
 	}
 
-	i32 power2 = 0;
-	while (JIIObjIsDigit(lineBuffer[*offset])) {
-		power2 = power2 * 10 + (lineBuffer[*offset] - '0');
+	return status;
+}
 
-		JII_ADVANCE_CHECK_RETURN(*offset, lineSize, sign * (result / power));
-	}
+JIIDef JIIObjStatus JIIObjLoadSTL(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
 
-	while (power2 != 0) {
-		power *= (eSign == 1) ? 0.1 : 10;
-		--power2;
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFile(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
 	}
 
-	return sign * (result / power);
+	status = JIIObjParseSTLBuffer(mapping.data, mapping.size, data);
+
+	JIIObjUnmapFile(&mapping);
+
+	return JIIObjFinishImportedData(data, status, options, true);
 }
 
-// this function is the definition of spray and pray
-JIIPrivate JIIObjStatus JIIObjParseVertexAttribute(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset) {
-	JIIAssert(context && lineBuffer && lineSize);
+JIIDef JIIObjStatus JIIObjLoadSTLW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
 
-	if (offset + 1 >= lineSize) {
-		return JIIObjStatus::Eof;
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFileW(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
 	}
 
-	// function is always called after 'v' was already detected
-	++offset;
-	switch (lineBuffer[offset]) {
-		case ' ': {
-			// going to be position
-			++offset;
-			float x = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float y = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float z = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			context->modelData.positions[context->usedPositions++] = {x, y, z};
-			break;
-		}
-
-		case 't': {
-			// going to be uv
-			++offset;
-			float u = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float v = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float w = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			context->modelData.uvs[context->usedUVs++] = { u, v, w };
-			break;
-		}
+	status = JIIObjParseSTLBuffer(mapping.data, mapping.size, data);
 
-		case 'n': {
-			// going to be normal
-			++offset;
-			float x = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float y = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			float z = JIIObjEatFloat(lineBuffer, lineSize, &offset);
-			context->modelData.normals[context->usedNormals++] = { x, y, z };
-			break;
-		}
-	}
+	JIIObjUnmapFile(&mapping);
 
-	return JIIObjStatus::Ok;
+	return JIIObjFinishImportedData(data, status, options, true);
 }
 
-JIIPrivate JIIObjStatus JIIObjParseFace(JIIObjContext* context, u8* lineBuffer, u32 lineSize, u32 offset) {
-	JIIAssert(context && lineBuffer && lineSize);
-	JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+JIIDef JIIObjStatus JIIObjLoadPLY(const char* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
 
-	u32 verticesInFace = 0;
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFile(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
 
-	u32 cachedIndex0;
-	u32 cachedIndex1;
+	status = JIIObjParsePLYBuffer(mapping.data, mapping.size, data);
 
-	while (JIIObjIsWhitespace(lineBuffer[offset])) {
-		JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
+	JIIObjUnmapFile(&mapping);
 
-		u32 position = UINT_MAX;
-		u32 uv = UINT_MAX;
-		u32 normal = UINT_MAX;
+	return JIIObjFinishImportedData(data, status, options, false);
+}
 
-		position = JIIObjEatU32(lineBuffer, lineSize, &offset);
-		if (offset < lineSize && lineBuffer[offset] == '/') {
-			JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
-			// f p//n p//n p//n is accepted input
-			if (lineBuffer[offset] != '/') {
-				uv = JIIObjEatU32(lineBuffer, lineSize, &offset);
-			}
+JIIDef JIIObjStatus JIIObjLoadPLYW(const wchar_t* path, JIIObjModelData* data, JIIObjLoadOptions* options) {
+	JIIAssert(path && data);
 
-			if (offset < lineSize && lineBuffer[offset] == '/') {
-				JII_ADVANCE_CHECK_RETURN(offset, lineSize, JIIObjStatus::Eof);
-				normal = JIIObjEatU32(lineBuffer, lineSize, &offset);
-			}
-		}
+	JIIObjFileMapping mapping;
+	JIIObjStatus status = JIIObjMapFileW(path, &mapping);
+	if (status != JIIObjStatus::Ok) {
+		return status;
+	}
 
-		JIIObjVertex vertex = {};
+	status = JIIObjParsePLYBuffer(mapping.data, mapping.size, data);
 
-		vertex.position = context->modelData.positions[position + context->positionsOffset];
-		if (uv != UINT_MAX) {
-			vertex.uv = context->modelData.uvs[uv + context->uvsOffset];
-		}
-		if (normal != UINT_MAX) {
-			vertex.normal = context->modelData.normals[normal + context->normalsOffset];
-		}
+	JIIObjUnmapFile(&mapping);
 
-		context->modelData.vertices[context->usedVertices++] = vertex;
+	return JIIObjFinishImportedData(data, status, options, false);
+}
 
-		++verticesInFace;
-		if (verticesInFace == 3) {
-			JIIObjFace face = {};
-			face.indices[0] = context->usedVertices - 2;
-			face.indices[1] = context->usedVertices - 1;
-			face.indices[2] = context->usedVertices;
+#define JII_OBJ_SCAN_BLOCK_SIZE (1 << 16)
 
-			context->modelData.faces[context->usedFaces++] = face;
+struct JIIObjScanTask {
+	u32* values;
+	u32 count;
+	u32* blockSums;
+};
 
-			cachedIndex0 = face.indices[0];
-			cachedIndex1 = face.indices[2];
-		}
-		else if(verticesInFace > 3){
-			// triangulate face
-			JIIObjFace face = {};
-			face.indices[0] = cachedIndex0;
-			face.indices[1] = cachedIndex1;
-			face.indices[2] = context->usedVertices;
+JIIPrivate void JIIObjScanSumProc(void* data, u32 begin, u32 end) {
+	JIIObjScanTask* task = (JIIObjScanTask*)data;
 
-			context->modelData.faces[context->usedFaces++] = face;
+	for (u32 block = begin; block < end; ++block) {
+		u32 first = block * JII_OBJ_SCAN_BLOCK_SIZE;
+		u32 last = first + JII_OBJ_SCAN_BLOCK_SIZE < task->count ? first + JII_OBJ_SCAN_BLOCK_SIZE : task->count;
 
-			cachedIndex1 = face.indices[2];
+		u32 sum = 0;
+		for (u32 i = first; i < last; ++i) {
+			sum += task->values[i];
 		}
+		task->blockSums[block] = sum;
 	}
 }
 
-JIIPrivate JIIObjStatus JIIObjParseLine(JIIObjContext* context, u8* lineBuffer, u32 lineSize) {
-	JIIAssert(context && lineBuffer && lineSize);
+JIIPrivate void JIIObjScanOffsetProc(void* data, u32 begin, u32 end) {
+	JIIObjScanTask* task = (JIIObjScanTask*)data;
 
-	JIIObjStatus status = JIIObjStatus::Ok;
+	for (u32 block = begin; block < end; ++block) {
+		u32 first = block * JII_OBJ_SCAN_BLOCK_SIZE;
+		u32 last = first + JII_OBJ_SCAN_BLOCK_SIZE < task->count ? first + JII_OBJ_SCAN_BLOCK_SIZE : task->count;
 
-	u32 offset = 0;
-	switch (lineBuffer[offset]) {
-		case 'v': {
-			status = JIIObjParseVertexAttribute(context, lineBuffer, lineSize, offset);
-			break;
-		}
-		case 'f': {
-			status = JIIObjParseFace(context, lineBuffer, lineSize, offset);
-			break;
-		}
-		default: {
-			break;
+		u32 running = task->blockSums[block];
+		for (u32 i = first; i < last; ++i) {
+			u32 value = task->values[i];
+			task->values[i] = running;
+			running += value;
 		}
-		// not caring about other attributes for now
 	}
-
-	return status;
 }
 
-JIIPrivate void JIIObjTryPeekAttribute(JIIObjContext* context) {
-	JIIAssert(context);
+// exclusive prefix sum in place, values has room for count + 1 and the last one becomes the total,
+// blocks get summed in parallel, then the block sums are scanned and every block is offset in parallel
+JIIPrivate u32 JIIObjPrefixSum(u32* values, u32 count) {
+	u32 numberOfBlocks = (count + JII_OBJ_SCAN_BLOCK_SIZE - 1) / JII_OBJ_SCAN_BLOCK_SIZE;
 
-	switch (context->fileBuffer[context->fileCursor]) {
-		case 'v': {
-			if (context->fileCursor + 1 < context->fileSize) {
-				switch (context->fileBuffer[context->fileCursor + 1]) {
-					case ' ': {
-						++context->modelData.numberOfPositions;
-						break;
-					}
-					case 't': {
-						++context->modelData.numberOfUVs;
-						break;
-					}
-					case 'n': {
-						++context->modelData.numberOfNormals;
-						break;
-					}
-				}
+	JIIObjScanTask task;
+	task.values = values;
+	task.count = count;
+	task.blockSums = (u32*)JIIMalloc(sizeof(u32) * (numberOfBlocks + 1));
+
+	JIIObjParallelFor(numberOfBlocks, 1, JIIObjScanSumProc, &task);
+
+	u32 total = 0;
+	for (u32 block = 0; block < numberOfBlocks; ++block) {
+		u32 sum = task.blockSums[block];
+		task.blockSums[block] = total;
+		total += sum;
+	}
+
+	JIIObjParallelFor(numberOfBlocks, 1, JIIObjScanOffsetProc, &task);
+
+	JIIFree(task.blockSums);
+
+	values[count] = total;
+	return total;
+}
+
+// rows are short, insertion sort for those and heap sort for the odd huge one
+JIIPrivate void JIIObjSortU32(u32* values, u32 count) {
+	if (count <= 16) {
+		for (u32 i = 1; i < count; ++i) {
+			u32 value = values[i];
+			u32 j = i;
+			for (; j > 0 && values[j - 1] > value; --j) {
+				values[j] = values[j - 1];
 			}
-			break;
+			values[j] = value;
 		}
-		// this is more fragile than my ego
-		case 'f': {
-			// skip whitespace right after
-			JII_ADVANCE_CHECK_RETURN_NOVALUE(context->fileCursor, context->fileSize);
-			JII_ADVANCE_CHECK_RETURN_NOVALUE(context->fileCursor, context->fileSize);
+		return;
+	}
 
-			u32 spaces = 0;
-			while (!JIIObjIsLineEnd(context->fileBuffer[context->fileCursor])) {
-				if (JIIObjIsWhitespace(context->fileBuffer[context->fileCursor])) {
-					++spaces;
-				}
-				JII_ADVANCE_CHECK_BREAK(context->fileCursor, context->fileSize);
+	for (u32 i = count / 2; i-- > 0;) {
+		for (u32 root = i; root * 2 + 1 < count;) {
+			u32 child = root * 2 + 1;
+			if (child + 1 < count && values[child + 1] > values[child]) {
+				++child;
+			}
+			if (values[root] >= values[child]) {
+				break;
 			}
+			u32 swap = values[root];
+			values[root] = values[child];
+			values[child] = swap;
+			root = child;
+		}
+	}
 
-			u32 verticesPerFace = spaces + 1;
-			
-			JIIAssert(verticesPerFace == 3 || verticesPerFace > 3);
+	for (u32 end = count - 1; end > 0; --end) {
+		u32 swap = values[0];
+		values[0] = values[end];
+		values[end] = swap;
 
-			if (verticesPerFace > 3) {
-				// when we triangulate faces we will get more faces from non-triangulated face
-				context->modelData.numberOfFaces += verticesPerFace - 2;
+		for (u32 root = 0; root * 2 + 1 < end;) {
+			u32 child = root * 2 + 1;
+			if (child + 1 < end && values[child + 1] > values[child]) {
+				++child;
 			}
-			else if(verticesPerFace == 3){
-				++context->modelData.numberOfFaces;
+			if (values[root] >= values[child]) {
+				break;
 			}
-			
-			break;
+			u32 swap = values[root];
+			values[root] = values[child];
+			values[child] = swap;
+			root = child;
 		}
 	}
 }
 
-JIIPrivate JIIObjStatus JIIObjPeekFile(JIIObjContext* context) {
-	JIIAssert(context);
+// first element in a sorted range that is bigger than value
+JIIPrivate u32 JIIObjUpperBound(const u32* values, u32 count, u32 value) {
+	u32 low = 0;
+	u32 high = count;
+	while (low < high) {
+		u32 middle = low + (high - low) / 2;
+		if (values[middle] <= value) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
 
-	u32 saveCursor = context->fileCursor;
+struct JIIObjAdjacencyContext {
+	JIIObjModelData* data;
+	JIIObjAdjacency* adjacency;
 
-	JIIObjStatus status;
-	while (true) {
-		JIIObjTryPeekAttribute(context);
-		status = JIIObjSkipToNextLine(context);
-		if (status != JIIObjStatus::Ok) {
-			break;
+	// per row counters, first the counts and then the cursors of the fill
+	u32* cursors;
+
+	// vertex to vertex candidates, two per vertex to face entry
+	u32* candidates;
+	// the first edge of every vertex, the edges of a vertex go to its bigger neighbours
+	u32* vertexEdgeOffsets;
+};
+
+// the corners of a face that aren't repeats of an earlier corner
+JIIPrivate u32 JIIObjGetDistinctCorners(JIIObjModelData* data, u32 face, u32* corners) {
+	u32 count = 0;
+	for (u32 corner = 0; corner < 3; ++corner) {
+		u32 index = JIIObjGetFaceIndex(data, face, corner);
+		if ((count < 1 || corners[0] != index) && (count < 2 || corners[1] != index)) {
+			corners[count++] = index;
 		}
 	}
+	return count;
+}
 
-	context->fileCursor = saveCursor;
+JIIPrivate void JIIObjCountVertexFacesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
 
-	return JIIObjStatus::Ok;
+	for (u32 face = begin; face < end; ++face) {
+		u32 corners[3];
+		u32 count = JIIObjGetDistinctCorners(context->data, face, corners);
+		for (u32 i = 0; i < count; ++i) {
+			JIIObjAtomicAdd32(&context->cursors[corners[i]], 1);
+		}
+	}
 }
 
-JIIPrivate JIIObjStatus JIIObjParseBuffer(JIIObjContext* context) {
-	JIIAssert(context);
+JIIPrivate void JIIObjFillVertexFacesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
 
-	// peek in order to preallocate all the needed space
-	JIIObjPeekFile(context);
-	// TODO(Sarmis) cache vertices
-	context->modelData.numberOfVertices = context->modelData.numberOfFaces * 3;
-	context->modelData.positions = (JIIObjPosition*)JIIMalloc(sizeof(JIIObjPosition) * context->modelData.numberOfPositions);
-	context->modelData.normals = (JIIObjNormal*)JIIMalloc(sizeof(JIIObjNormal) * context->modelData.numberOfNormals);
-	context->modelData.uvs = (JIIObjUV*)JIIMalloc(sizeof(JIIObjUV) * context->modelData.numberOfUVs);
-	context->modelData.faces = (JIIObjFace*)JIIMalloc(sizeof(JIIObjFace) * context->modelData.numberOfFaces);
-	context->modelData.vertices = (JIIObjVertex*)JIIMalloc(sizeof(JIIObjVertex) * context->modelData.numberOfVertices);
-	
-	u8 lineBuffer[256];
-	u32 lineSize;
-	JIIObjStatus status;
-	while (true) {
-		status = JIIObjReadLine(context, lineBuffer, &lineSize, 256);
-		if (status != JIIObjStatus::Ok) {
-			return status;
+	for (u32 face = begin; face < end; ++face) {
+		u32 corners[3];
+		u32 count = JIIObjGetDistinctCorners(context->data, face, corners);
+		for (u32 i = 0; i < count; ++i) {
+			u32 slot = JIIObjAtomicAdd32(&context->cursors[corners[i]], 1);
+			context->adjacency->vertexFaces[slot] = face;
 		}
+	}
+}
 
-		if (lineSize != 0) {
-			status = JIIObjParseLine(context, lineBuffer, lineSize);
-			if (status != JIIObjStatus::Ok) {
-				return status;
-			}
-		}
+// the fill order depends on the threads, sorting the rows makes the tables the same every time
+JIIPrivate void JIIObjSortVertexFacesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacency* adjacency = ((JIIObjAdjacencyContext*)data)->adjacency;
+
+	for (u32 vertex = begin; vertex < end; ++vertex) {
+		u32 first = adjacency->vertexFaceOffsets[vertex];
+		JIIObjSortU32(adjacency->vertexFaces + first, adjacency->vertexFaceOffsets[vertex + 1] - first);
 	}
 }
 
-JIIDef JIIObjStatus JIIObjLoadData(const char* path, JIIObjModelData* data) {
-	JIIAssert(path && data);
+// gathers the other corners of every face around a vertex, sorted and unique, and counts them
+JIIPrivate void JIIObjGatherNeighboursProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
+	JIIObjAdjacency* adjacency = context->adjacency;
+
+	for (u32 vertex = begin; vertex < end; ++vertex) {
+		u32* neighbours = context->candidates + adjacency->vertexFaceOffsets[vertex] * 2;
+
+		u32 count = 0;
+		for (u32 i = adjacency->vertexFaceOffsets[vertex]; i < adjacency->vertexFaceOffsets[vertex + 1]; ++i) {
+			u32 corners[3];
+			u32 numberOfCorners = JIIObjGetDistinctCorners(context->data, adjacency->vertexFaces[i], corners);
+			for (u32 corner = 0; corner < numberOfCorners; ++corner) {
+				if (corners[corner] != vertex) {
+					neighbours[count++] = corners[corner];
+				}
+			}
+		}
 
-	JIIObjContext context = {};
+		JIIObjSortU32(neighbours, count);
 
-	JIIObjStatus status;
+		u32 unique = 0;
+		for (u32 i = 0; i < count; ++i) {
+			if (unique == 0 || neighbours[unique - 1] != neighbours[i]) {
+				neighbours[unique++] = neighbours[i];
+			}
+		}
 
-	status = JIIObjReadFile(path, &context.fileBuffer, &context.fileSize);
-	if (status != JIIObjStatus::Ok) {
-		return status;
+		adjacency->vertexVertexOffsets[vertex] = unique;
+		context->vertexEdgeOffsets[vertex] = unique - JIIObjUpperBound(neighbours, unique, vertex);
 	}
+}
 
-	status = JIIObjParseBuffer(&context);
-	if (status != JIIObjStatus::Ok && status != JIIObjStatus::Eof) {
-		return status;
+JIIPrivate void JIIObjFillNeighboursProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
+	JIIObjAdjacency* adjacency = context->adjacency;
+
+	for (u32 vertex = begin; vertex < end; ++vertex) {
+		u32 first = adjacency->vertexVertexOffsets[vertex];
+		u32 count = adjacency->vertexVertexOffsets[vertex + 1] - first;
+		u32* neighbours = adjacency->vertexVertices + first;
+		memcpy(neighbours, context->candidates + adjacency->vertexFaceOffsets[vertex] * 2, sizeof(u32) * count);
+
+		// every edge belongs to its smaller vertex
+		u32 firstBigger = JIIObjUpperBound(neighbours, count, vertex);
+		u32 edge = context->vertexEdgeOffsets[vertex];
+		for (u32 i = firstBigger; i < count; ++i, ++edge) {
+			adjacency->edges[edge].vertex0 = vertex;
+			adjacency->edges[edge].vertex1 = neighbours[i];
+		}
 	}
+}
 
-	JIIFree(context.fileBuffer);
+JIIPrivate u32 JIIObjFindEdge(JIIObjAdjacencyContext* context, u32 vertex0, u32 vertex1) {
+	if (vertex0 == vertex1) {
+		return JII_OBJ_NO_EDGE;
+	}
+	if (vertex0 > vertex1) {
+		u32 swap = vertex0;
+		vertex0 = vertex1;
+		vertex1 = swap;
+	}
 
-	*data = context.modelData;
+	JIIObjAdjacency* adjacency = context->adjacency;
+	u32 first = adjacency->vertexVertexOffsets[vertex0];
+	u32 count = adjacency->vertexVertexOffsets[vertex0 + 1] - first;
+	u32* neighbours = adjacency->vertexVertices + first;
 
-	return JIIObjStatus::Ok;
+	u32 firstBigger = JIIObjUpperBound(neighbours, count, vertex0);
+	u32 position = JIIObjUpperBound(neighbours, count, vertex1) - 1;
+	return context->vertexEdgeOffsets[vertex0] + position - firstBigger;
 }
 
-JIIDef JIIObjStatus JIIObjLoadDataW(const wchar_t* path, JIIObjModelData* data) {
-	JIIAssert(path && data);
+JIIPrivate void JIIObjFaceEdgesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
+	JIIObjAdjacency* adjacency = context->adjacency;
 
-	JIIObjContext context = {};
+	for (u32 face = begin; face < end; ++face) {
+		u32 indices[3];
+		for (u32 corner = 0; corner < 3; ++corner) {
+			indices[corner] = JIIObjGetFaceIndex(context->data, face, corner);
+		}
 
-	JIIObjStatus status;
+		u32* edges = adjacency->faceEdges + face * 3;
+		for (u32 corner = 0; corner < 3; ++corner) {
+			edges[corner] = JIIObjFindEdge(context, indices[corner], indices[corner == 2 ? 0 : corner + 1]);
 
-	status = JIIObjReadFileW(path, &context.fileBuffer, &context.fileSize);
-	if (status != JIIObjStatus::Ok) {
-		return status;
+			// a face only counts once per edge, even a degenerate one that walks it twice
+			bool repeated = (corner > 0 && edges[0] == edges[corner]) || (corner > 1 && edges[1] == edges[corner]);
+			if (edges[corner] != JII_OBJ_NO_EDGE && !repeated) {
+				JIIObjAtomicAdd32(&context->cursors[edges[corner]], 1);
+			}
+		}
 	}
+}
 
-	status = JIIObjParseBuffer(&context);
-	if (status != JIIObjStatus::Ok && status != JIIObjStatus::Eof) {
-		return status;
+JIIPrivate void JIIObjFillEdgeFacesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacencyContext* context = (JIIObjAdjacencyContext*)data;
+	JIIObjAdjacency* adjacency = context->adjacency;
+
+	for (u32 face = begin; face < end; ++face) {
+		u32* edges = adjacency->faceEdges + face * 3;
+		for (u32 corner = 0; corner < 3; ++corner) {
+			bool repeated = (corner > 0 && edges[0] == edges[corner]) || (corner > 1 && edges[1] == edges[corner]);
+			if (edges[corner] != JII_OBJ_NO_EDGE && !repeated) {
+				u32 slot = JIIObjAtomicAdd32(&context->cursors[edges[corner]], 1);
+				adjacency->edgeFaces[slot] = face;
+			}
+		}
 	}
+}
 
-	JIIFree(context.fileBuffer);
+JIIPrivate void JIIObjSortEdgeFacesProc(void* data, u32 begin, u32 end) {
+	JIIObjAdjacency* adjacency = ((JIIObjAdjacencyContext*)data)->adjacency;
 
-	*data = context.modelData;
-	return JIIObjStatus::Ok;
+	for (u32 edge = begin; edge < end; ++edge) {
+		u32 first = adjacency->edgeFaceOffsets[edge];
+		JIIObjSortU32(adjacency->edgeFaces + first, adjacency->edgeFaceOffsets[edge + 1] - first);
+	}
 }
 
-JIIDef void JIIObjFreeData(JIIObjModelData* data) {
-	JIIAssert(data);
+#define JII_OBJ_ADJACENCY_GRAIN (1 << 14)
 
-	JIIFree(data->positions);
-	JIIFree(data->uvs);
-	JIIFree(data->normals);
-	JIIFree(data->faces);
-	JIIFree(data->vertices);
+JIIDef JIIObjStatus JIIObjBuildAdjacency(JIIObjModelData* data, JIIObjAdjacency* adjacency) {
+	JIIAssert(data && adjacency);
+	JIITraceScope("JIIObjBuildAdjacency");
+
+	*adjacency = {};
+
+	// the neighbour candidates take 2 slots per corner
+	if ((u64)data->numberOfFaces * 6 > UINT32_MAX || data->numberOfVertices < 0) {
+		return JIIObjStatus::OutOfSpace;
+	}
+
+	u32 numberOfVertices = (u32)data->numberOfVertices;
+	u32 numberOfFaces = (u32)data->numberOfFaces;
+	adjacency->numberOfVertices = numberOfVertices;
+	adjacency->numberOfFaces = numberOfFaces;
+
+	JIIObjAdjacencyContext context = {};
+	context.data = data;
+	context.adjacency = adjacency;
+
+	// vertex to face, count, scan, fill through the cursors and sort the rows
+	adjacency->vertexFaceOffsets = (u32*)JIIMalloc(sizeof(u32) * (numberOfVertices + 1));
+	memset(adjacency->vertexFaceOffsets, 0, sizeof(u32) * (numberOfVertices + 1));
+	context.cursors = adjacency->vertexFaceOffsets;
+	JIIObjParallelFor(numberOfFaces, JII_OBJ_ADJACENCY_GRAIN, JIIObjCountVertexFacesProc, &context);
+	u32 numberOfVertexFaces = JIIObjPrefixSum(adjacency->vertexFaceOffsets, numberOfVertices);
+
+	context.cursors = (u32*)JIIMalloc(sizeof(u32) * (numberOfVertices + 1));
+	memcpy(context.cursors, adjacency->vertexFaceOffsets, sizeof(u32) * (numberOfVertices + 1));
+	adjacency->vertexFaces = (u32*)JIIMalloc(sizeof(u32) * numberOfVertexFaces);
+	JIIObjParallelFor(numberOfFaces, JII_OBJ_ADJACENCY_GRAIN, JIIObjFillVertexFacesProc, &context);
+	JIIObjParallelFor(numberOfVertices, JII_OBJ_ADJACENCY_GRAIN, JIIObjSortVertexFacesProc, &context);
+
+	// vertex to vertex, the rows get built in the candidates first and compacted once the scan is done,
+	// the edges come out of the same pass
+	context.candidates = (u32*)JIIMalloc(sizeof(u32) * numberOfVertexFaces * 2);
+	context.vertexEdgeOffsets = (u32*)JIIMalloc(sizeof(u32) * (numberOfVertices + 1));
+	adjacency->vertexVertexOffsets = (u32*)JIIMalloc(sizeof(u32) * (numberOfVertices + 1));
+	JIIObjParallelFor(numberOfVertices, JII_OBJ_ADJACENCY_GRAIN, JIIObjGatherNeighboursProc, &context);
+	u32 numberOfNeighbours = JIIObjPrefixSum(adjacency->vertexVertexOffsets, numberOfVertices);
+	adjacency->numberOfEdges = JIIObjPrefixSum(context.vertexEdgeOffsets, numberOfVertices);
+
+	adjacency->vertexVertices = (u32*)JIIMalloc(sizeof(u32) * numberOfNeighbours);
+	adjacency->edges = (JIIObjEdge*)JIIMalloc(sizeof(JIIObjEdge) * adjacency->numberOfEdges);
+	JIIObjParallelFor(numberOfVertices, JII_OBJ_ADJACENCY_GRAIN, JIIObjFillNeighboursProc, &context);
+
+	JIIFree(context.candidates);
+	JIIFree(context.cursors);
+
+	// half edges to edges and edge to face, counted while the half edges get resolved
+	u32 numberOfEdges = adjacency->numberOfEdges;
+	adjacency->faceEdges = (u32*)JIIMalloc(sizeof(u32) * numberOfFaces * 3);
+	adjacency->edgeFaceOffsets = (u32*)JIIMalloc(sizeof(u32) * (numberOfEdges + 1));
+	memset(adjacency->edgeFaceOffsets, 0, sizeof(u32) * (numberOfEdges + 1));
+	context.cursors = adjacency->edgeFaceOffsets;
+	JIIObjParallelFor(numberOfFaces, JII_OBJ_ADJACENCY_GRAIN, JIIObjFaceEdgesProc, &context);
+	u32 numberOfEdgeFaces = JIIObjPrefixSum(adjacency->edgeFaceOffsets, numberOfEdges);
+
+	context.cursors = (u32*)JIIMalloc(sizeof(u32) * (numberOfEdges + 1));
+	memcpy(context.cursors, adjacency->edgeFaceOffsets, sizeof(u32) * (numberOfEdges + 1));
+	adjacency->edgeFaces = (u32*)JIIMalloc(sizeof(u32) * numberOfEdgeFaces);
+	JIIObjParallelFor(numberOfFaces, JII_OBJ_ADJACENCY_GRAIN, JIIObjFillEdgeFacesProc, &context);
+	JIIObjParallelFor(numberOfEdges, JII_OBJ_ADJACENCY_GRAIN, JIIObjSortEdgeFacesProc, &context);
+
+	JIIFree(context.cursors);
+	JIIFree(context.vertexEdgeOffsets);
+
+	JIITraceCounter("JIIObjEdges", numberOfEdges);
+
+	return JIIObjStatus::Ok;
+}
+
+JIIDef void JIIObjFreeAdjacency(JIIObjAdjacency* adjacency) {
+	JIIAssert(adjacency);
+
+	JIIFree(adjacency->vertexFaceOffsets);
+	JIIFree(adjacency->vertexFaces);
+	JIIFree(adjacency->vertexVertexOffsets);
+	JIIFree(adjacency->vertexVertices);
+	JIIFree(adjacency->edges);
+	JIIFree(adjacency->faceEdges);
+	JIIFree(adjacency->edgeFaceOffsets);
+	JIIFree(adjacency->edgeFaces);
+	*adjacency = {};
 }
 
 #endif // JII_OBJ_IMPLMENTATION
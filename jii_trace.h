@@ -0,0 +1,353 @@
+/* Copyright (C) 2024 Streanga Sarmis-Stefan - All Rights Reserved
+ * You may use, distribute and modify this code under the
+ * terms of the CC0 license. Which can be found
+ * here: https://creativecommons.org/public-domain/cc0/
+ *
+ * JII aims to be a set of libraries really easy to use and link.
+ * It should take away the headache C++ libraries tend to give nowadays
+ * with self building libraries that don't build out of the box,
+ * have weird dependencies and waste precious time that could
+ * be spent doing actual work.
+ *
+ * #define JII_TRACE_IMPLMENTATION in some C/C++ file to compile the functions
+ * so the symbols can be found
+ *
+ * Don't define JII_TRACE_IMPLMENTATION in more than one file because
+ * there will be duplicated symbols, I am pretty sure people don't even
+ * read these comments on the top of the header but a man can hope.
+ *
+ * Tracing is only compiled in when JII_TRACE_ENABLED is defined (before including
+ * any jii header), otherwise all the macros below expand to nothing. jii_obj.h and
+ * jii_window.h include this header by themselves when JII_TRACE_ENABLED is defined.
+ *
+ * Every thread records into its own ring buffer, once the ring is full the oldest
+ * events get overwritten. Names must be string literals (or at least outlive the dump).
+
+	void Frame() {
+		JIITraceScope("Frame");
+		JIITraceCounter("Entities", entityCount);
+		...
+	}
+
+	int main(){
+		...
+		JIITraceDumpChromeJSON("trace.json"); // open with chrome://tracing or ui.perfetto.dev
+	}
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#ifndef JII_PRIMITIVE_DEFINES
+#define JII_PRIMITIVE_DEFINES
+#include <stdint.h>
+typedef int64_t i64;
+typedef int32_t i32;
+typedef int16_t i16;
+typedef int8_t i8;
+typedef uint64_t u64;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t u8;
+#endif
+
+#ifndef JII_TRACE_RING_CAPACITY
+// events per thread, has to be a power of 2
+#define JII_TRACE_RING_CAPACITY (1 << 16)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef JIIDef
+#ifdef JII_TRACE_STATIC
+#define JIIDef static
+#else
+#define JIIDef extern
+#endif
+#endif
+
+JIIDef void JIITraceBeginEvent(const char* name);
+JIIDef void JIITraceEndEvent(const char* name);
+JIIDef void JIITraceCounterEvent(const char* name, i64 value);
+
+// returns false if the file could not be opened
+JIIDef bool JIITraceDumpChromeJSON(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef JII_TRACE_ENABLED
+
+struct JIITraceScopeGuard {
+	const char* name;
+
+	JIITraceScopeGuard(const char* name) : name(name) {
+		JIITraceBeginEvent(name);
+	}
+
+	~JIITraceScopeGuard() {
+		JIITraceEndEvent(name);
+	}
+};
+
+#define JII_TRACE_CONCAT_(a, b) a##b
+#define JII_TRACE_CONCAT(a, b) JII_TRACE_CONCAT_(a, b)
+
+#define JIITraceBegin(name) JIITraceBeginEvent(name)
+#define JIITraceEnd(name) JIITraceEndEvent(name)
+#define JIITraceCounter(name, value) JIITraceCounterEvent(name, (i64)(value))
+#define JIITraceScope(name) JIITraceScopeGuard JII_TRACE_CONCAT(jiiTraceScope, __LINE__)(name)
+
+#else
+
+#define JIITraceBegin(name)
+#define JIITraceEnd(name)
+#define JIITraceCounter(name, value)
+#define JIITraceScope(name)
+
+#endif // JII_TRACE_ENABLED
+
+#ifdef JII_TRACE_IMPLMENTATION
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#ifndef JIIPrivate
+#define JIIPrivate static
+#endif
+
+#ifndef JIIAssert
+#include <assert.h>
+#define JIIAssert(...) assert(__VA_ARGS__)
+#endif
+
+#ifndef JIIMalloc
+#include <stdlib.h>
+#define JIIMalloc(...) malloc(__VA_ARGS__)
+#endif
+
+#ifndef JIIFree
+#include <stdlib.h>
+#define JIIFree(...) free(__VA_ARGS__)
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define JIITraceAtomicLoad(pointer) ((u64)_InterlockedOr64((volatile long long*)(pointer), 0))
+#define JIITraceAtomicLoadPointer(pointer) (*(void* volatile*)(pointer))
+#define JIITraceAtomicStore(pointer, value) _InterlockedExchange64((volatile long long*)(pointer), (long long)(value))
+#define JIITraceAtomicCASPointer(pointer, expected, desired) \
+	(_InterlockedCompareExchangePointer((void* volatile*)(pointer), (desired), (expected)) == (expected))
+#else
+#define JIITraceAtomicLoad(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define JIITraceAtomicLoadPointer(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define JIITraceAtomicStore(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+#define JIITraceAtomicCASPointer(pointer, expected, desired) \
+	__atomic_compare_exchange_n((pointer), &(expected), (desired), false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#endif
+
+enum JIITraceEventType {
+	TraceBegin,
+	TraceEnd,
+	TraceCounter
+};
+
+struct JIITraceEvent {
+	const char* name;
+	u64 timestamp;
+	i64 value;
+	JIITraceEventType type;
+};
+
+// single producer (the owning thread), the dumper only ever reads
+struct JIITraceRing {
+	JIITraceEvent* events;
+	u32 capacity;
+	u32 threadId;
+
+	// total number of events ever written, only the owning thread stores it
+	u64 head;
+
+	JIITraceRing* next;
+};
+
+JIIPrivate JIITraceRing* jii_TraceRings = NULL;
+JIIPrivate thread_local JIITraceRing* jii_TraceThreadRing = NULL;
+
+JIIPrivate u64 JIITraceTimestamp() {
+#if defined(_WIN32) || defined(_WIN64)
+	static LARGE_INTEGER frequency = {};
+	if (!frequency.QuadPart) {
+		QueryPerformanceFrequency(&frequency);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	u64 seconds = counter.QuadPart / frequency.QuadPart;
+	u64 remainder = counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000ull + (remainder * 1000000000ull) / frequency.QuadPart;
+#else
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (u64)time.tv_sec * 1000000000ull + (u64)time.tv_nsec;
+#endif
+}
+
+JIIPrivate u32 JIITraceCurrentThreadId() {
+#if defined(_WIN32) || defined(_WIN64)
+	return (u32)GetCurrentThreadId();
+#elif defined(__linux__)
+	return (u32)syscall(SYS_gettid);
+#else
+	static u32 nextThreadId = 1;
+	return __atomic_fetch_add(&nextThreadId, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+JIIPrivate u32 JIITraceCurrentProcessId() {
+#if defined(_WIN32) || defined(_WIN64)
+	return (u32)GetCurrentProcessId();
+#else
+	return (u32)getpid();
+#endif
+}
+
+JIIPrivate JIITraceRing* JIITraceGetThreadRing() {
+	if (jii_TraceThreadRing) {
+		return jii_TraceThreadRing;
+	}
+
+	JIIAssert((JII_TRACE_RING_CAPACITY & (JII_TRACE_RING_CAPACITY - 1)) == 0);
+
+	// rings are never freed, threads that exited still have to show up in the dump
+	JIITraceRing* ring = (JIITraceRing*)JIIMalloc(sizeof(JIITraceRing));
+	ring->events = (JIITraceEvent*)JIIMalloc(sizeof(JIITraceEvent) * JII_TRACE_RING_CAPACITY);
+	ring->capacity = JII_TRACE_RING_CAPACITY;
+	ring->threadId = JIITraceCurrentThreadId();
+	ring->head = 0;
+
+	JIITraceRing* expected;
+	do {
+		expected = (JIITraceRing*)JIITraceAtomicLoadPointer(&jii_TraceRings);
+		ring->next = expected;
+	} while (!JIITraceAtomicCASPointer(&jii_TraceRings, expected, ring));
+
+	jii_TraceThreadRing = ring;
+	return ring;
+}
+
+JIIPrivate void JIITracePushEvent(const char* name, JIITraceEventType type, i64 value) {
+	JIITraceRing* ring = JIITraceGetThreadRing();
+
+	u64 head = ring->head;
+	JIITraceEvent* event = &ring->events[head & (ring->capacity - 1)];
+	event->name = name;
+	event->timestamp = JIITraceTimestamp();
+	event->value = value;
+	event->type = type;
+
+	JIITraceAtomicStore(&ring->head, head + 1);
+}
+
+JIIDef void JIITraceBeginEvent(const char* name) {
+	JIITracePushEvent(name, JIITraceEventType::TraceBegin, 0);
+}
+
+JIIDef void JIITraceEndEvent(const char* name) {
+	JIITracePushEvent(name, JIITraceEventType::TraceEnd, 0);
+}
+
+JIIDef void JIITraceCounterEvent(const char* name, i64 value) {
+	JIITracePushEvent(name, JIITraceEventType::TraceCounter, value);
+}
+
+JIIPrivate void JIITraceWriteName(FILE* file, const char* name) {
+	fputc('"', file);
+	for (const char* c = name; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+		}
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+JIIDef bool JIITraceDumpChromeJSON(const char* path) {
+	JIIAssert(path);
+
+	FILE* file = fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+	u32 processId = JIITraceCurrentProcessId();
+	JIITraceEvent* snapshot = (JIITraceEvent*)JIIMalloc(sizeof(JIITraceEvent) * JII_TRACE_RING_CAPACITY);
+
+	fputs("{\"traceEvents\":[\n", file);
+
+	bool first = true;
+	for (JIITraceRing* ring = (JIITraceRing*)JIITraceAtomicLoadPointer(&jii_TraceRings); ring; ring = ring->next) {
+		u64 head = JIITraceAtomicLoad(&ring->head);
+		u64 copied = head > ring->capacity ? head - ring->capacity : 0;
+
+		for (u64 i = copied; i < head; ++i) {
+			snapshot[i - copied] = ring->events[i & (ring->capacity - 1)];
+		}
+
+		// the owner kept writing while we copied, whatever it could have overwritten
+		// (including the slot it is writing right now) is not trustworthy
+		u64 begin = copied;
+		u64 newHead = JIITraceAtomicLoad(&ring->head);
+		if (newHead + 1 > begin + ring->capacity) {
+			begin = newHead + 1 - ring->capacity;
+		}
+
+		for (u64 i = begin; i < head; ++i) {
+			JIITraceEvent* event = &snapshot[i - copied];
+
+			fputs(first ? "" : ",\n", file);
+			first = false;
+
+			fputs("{\"name\":", file);
+			JIITraceWriteName(file, event->name);
+
+			double timestamp = (double)event->timestamp / 1000.0;
+			switch (event->type) {
+				case JIITraceEventType::TraceBegin: {
+					fprintf(file, ",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", timestamp, processId, ring->threadId);
+					break;
+				}
+				case JIITraceEventType::TraceEnd: {
+					fprintf(file, ",\"ph\":\"E\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", timestamp, processId, ring->threadId);
+					break;
+				}
+				case JIITraceEventType::TraceCounter: {
+					fprintf(file, ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"value\":%lld}}",
+						timestamp, processId, ring->threadId, (long long)event->value);
+					break;
+				}
+			}
+		}
+	}
+
+	fputs("\n]}\n", file);
+
+	JIIFree(snapshot);
+	fclose(file);
+
+	return true;
+}
+
+#endif // JII_TRACE_IMPLMENTATION
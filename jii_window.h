@@ -15,6 +15,16 @@
  * Don't define JII_WIN_IMPLMENTATION in more than one file because
  * there will be duplicated symbols, I am pretty sure people don't even
  * read these comments on the top of the header but a man can hope.
+ *
+ * On Windows the window goes through Win32 (and WGL for JII_NEED_OPENGL), on Linux
+ * it goes through XCB, link with -lxcb -lxcb-xkb (and -lpthread on older glibc for JII_INPUT_THREAD).
+ * XKB only turns off the fake key releases X sends while a key is held, #define JII_WIN_NO_XKB
+ * (done automatically when <xcb/xkb.h> can't be found) to drop -lxcb-xkb and filter them out instead.
+ * JII_NEED_OPENGL is not supported on XCB, JIIWinCreateWindow returns Error for it there.
+ * Without a display the XCB backend can be driven headlessly through Xvfb, for example
+ * `xvfb-run ./app`.
+ * #define JII_WIN_NO_XCB (done automatically when <xcb/xcb.h> can't be found) to build
+ * without XCB at all, only JII_HEADLESS windows can be created then.
 	
 	void Callback0(JIIWindow* data, JIIWinKeyState state, JIIWinKeyCode code, int scancode) {
 	}
@@ -50,25 +60,91 @@
 		JIIWinCleanWindow(&window);
 		...
 	}
+
+	// no window or display at all, input only comes from the JIIWinInject* functions and goes
+	// through the same callbacks and JIIWinPollEvent as it would on a real window
+	JIIWinCreateWindow("Benchmark", 640, 480, &window, JII_HEADLESS);
+	JIIWinSetKeyboardCallback(&window, Callback0);
+
+	JIIWinInjectKey(&window, JIIWinKeyState::Down, JIIWinKeyCode::KeyW, 17);
+	JIIWinPollEvent(&window); // Callback0 gets called here
+
+	// with JII_EVENT_QUEUE the callbacks are not called, the backend queues typed events
+	// instead and a whole frame worth of them gets drained at once. Every event has a
+	// timestamp, JII_COALESCE_MOUSE_MOVE merges the moves in between other events and
+	// JII_RAW_MOUSE gives unaccelerated deltas (Win32 only)
+	JIIWinCreateWindow("Some window title", 640, 480, &window, JII_EVENT_QUEUE | JII_COALESCE_MOUSE_MOVE | JII_RAW_MOUSE);
+
+	JIIWinEvent events[256];
+	u32 count = JIIWinPollEvents(&window, events, 256);
+	for (u32 i = 0; i < count; ++i) {
+		switch (events[i].type) {
+			case JIIWinEventType::Key: {
+				// events[i].key.code, events[i].key.state
+				break;
+			}
+			...
+		}
+	}
+
+	// the OS events get pumped on a thread of their own, a long frame no longer delays the
+	// input timestamps or makes the window unresponsive. Implies JII_EVENT_QUEUE, the window
+	// must not move in memory while it is open
+	JIIWinCreateWindow("Some window title", 640, 480, &window, JII_INPUT_THREAD);
+
+	// or no events at all, the backend keeps a snapshot of the keyboard and mouse
+	JIIWinBeginInputFrame(&window);
+	JIIWinPollEvents(&window, events, 256);
+	if (JIIWinIsKeyDown(&window, JIIWinKeyCode::KeyW)) {
+	}
+	if (JIIWinWasKeyPressed(&window, JIIWinKeyCode::MouseLeftButton)) {
+	}
  */
 
 #pragma once
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
+#else
+#if !defined(JII_WIN_NO_XCB) && defined(__has_include)
+#if !__has_include(<xcb/xcb.h>)
+#define JII_WIN_NO_XCB
+#endif
+#endif
+
+#ifndef JII_WIN_NO_XCB
+#include <xcb/xcb.h>
+#include <pthread.h>
+
+#if !defined(JII_WIN_NO_XKB) && defined(__has_include)
+#if !__has_include(<xcb/xkb.h>)
+#define JII_WIN_NO_XKB
+#endif
+#endif
+
+#ifndef JII_WIN_NO_XKB
+#include <xcb/xkb.h>
+#endif
+#endif
 #endif
 
 #ifndef JII_PRIMITIVE_DEFINES
 #define JII_PRIMITIVE_DEFINES
 #include <stdint.h>
+typedef int64_t i64;
 typedef int32_t i32;
 typedef int16_t i16;
 typedef int8_t i8;
+typedef uint64_t u64;
 typedef uint32_t u32;
 typedef uint16_t u16;
 typedef uint8_t u8;
 #endif
 
+#ifdef JII_TRACE_ENABLED
+#include "jii_trace.h"
+#endif
+
 typedef u32 JIIWinHint;
 
 enum JIIWinKeyState {
@@ -198,6 +274,83 @@ enum JIIWinKeyCode {
 	KeyRightControl,
 	KeyLeftAlt,
 	KeyRightAlt,
+	// whatever the backend has no code for, the scancode still comes with it
+	KeyUnknown
+};
+
+#define JII_WIN_KEY_COUNT (JIIWinKeyCode::KeyUnknown + 1)
+#define JII_WIN_KEY_WORDS ((JII_WIN_KEY_COUNT + 63) / 64)
+
+// mouse buttons are JIIWinKeyCodes as well so they live in the same bitsets as the keys
+struct JIIWinInputState {
+	u64 down[JII_WIN_KEY_WORDS];
+
+	// transitions since the last JIIWinBeginInputFrame, a key tapped within one frame is in both
+	u64 pressed[JII_WIN_KEY_WORDS];
+	u64 released[JII_WIN_KEY_WORDS];
+
+	double mouseX;
+	double mouseY;
+
+	// summed mouse move deltas since the last JIIWinBeginInputFrame
+	double mouseDeltaX;
+	double mouseDeltaY;
+};
+
+enum JIIWinEventType {
+	None,
+	Quit,
+	Key,
+	MouseMove,
+	MouseButton,
+	Resize,
+	Focus
+};
+
+struct JIIWinKeyEvent {
+	JIIWinKeyState state;
+	JIIWinKeyCode code;
+	int scancode;
+};
+
+struct JIIWinMouseMoveEvent {
+	double x;
+	double y;
+
+	// movement since the previous mouse move event, with JII_RAW_MOUSE these are the
+	// device counts before pointer acceleration
+	double deltaX;
+	double deltaY;
+};
+
+struct JIIWinMouseButtonEvent {
+	JIIWinKeyState state;
+	JIIWinKeyCode code;
+};
+
+struct JIIWinResizeEvent {
+	i32 width;
+	i32 height;
+};
+
+struct JIIWinFocusEvent {
+	bool focused;
+};
+
+struct JIIWinEvent {
+	JIIWinEventType type;
+
+	// nanoseconds, same clock as JIIWinGetTimestamp
+	u64 timestamp;
+
+	// only the member matching type is valid
+	union {
+		JIIWinKeyEvent key;
+		JIIWinMouseMoveEvent mouseMove;
+		JIIWinMouseButtonEvent mouseButton;
+		JIIWinResizeEvent resize;
+		JIIWinFocusEvent focus;
+	};
 };
 
 struct JIIWindow;
@@ -205,12 +358,55 @@ typedef void(*JIIWinSetKeyboardCallbackType)(JIIWindow* window, JIIWinKeyState s
 typedef void(*JIIWinSetMousePositionCallbackType)(JIIWindow* window, double x, double y);
 typedef void(*JIIWinSetMouseButtonCallbackType)(JIIWindow* window, JIIWinKeyState state, JIIWinKeyCode code);
 
+#if defined(_WIN32) || defined(_WIN64)
 struct JIIWin32Context{
 	WNDCLASSA windowClass;
 	HWND windowHandle;
 
 	HGLRC glContext;
 	HDC deviceContext;
+
+	// JII_INPUT_THREAD, the window gets created on that thread since only it sees the messages
+	HANDLE inputThread;
+	HANDLE inputThreadReady;
+	bool inputThreadCreatedWindow;
+};
+#elif !defined(JII_WIN_NO_XCB)
+struct JIIWinXcbContext {
+	xcb_connection_t* connection;
+	xcb_window_t windowHandle;
+
+	// WM_DELETE_WINDOW, what the window manager sends when the window gets closed
+	xcb_atom_t deleteWindowAtom;
+
+	// XKB detectable autorepeat is on, held keys only repeat their presses
+	bool detectableAutoRepeat;
+
+	// size from the last ConfigureNotify, only touched by whoever reads the events
+	i32 width;
+	i32 height;
+	bool quitReported;
+
+	// JII_INPUT_THREAD
+	pthread_t inputThread;
+	bool hasInputThread;
+	u32 stopInputThread;
+};
+#endif
+
+// single producer (the backend) single consumer (JIIWinPollEvents) ring
+struct JIIWinEventQueue {
+	JIIWinEvent* events;
+	u32 capacity;
+
+	// only the consumer stores head, only the producer stores tail
+	u32 head;
+	u32 tail;
+
+	// events thrown away because the queue was full, only the producer stores it
+	u32 dropped;
+	// what the consumer had seen of dropped on its last poll
+	u32 seenDropped;
 };
 
 struct JIIWindowCallabacks {
@@ -227,18 +423,37 @@ struct JIIWindow {
 
 	JIIWinHint hints;
 
+#if defined(_WIN32) || defined(_WIN64)
 	JIIWin32Context win32;
+#elif !defined(JII_WIN_NO_XCB)
+	JIIWinXcbContext xcb;
+#endif
 
 	JIIWindowCallabacks callbacks;
-};
 
-enum JIIWinEventType {
-	None,
-	Quit
-};
+	// only used by JII_EVENT_QUEUE windows
+	JIIWinEventQueue eventQueue;
 
-struct JIIWinEvent {
-	JIIWinEventType type;
+	// last cursor position the backend has seen, mouse move deltas are relative to it
+	double mouseX;
+	double mouseY;
+	bool hasMousePosition;
+
+	// with JII_COALESCE_MOUSE_MOVE moves wait here until something else shows up or the poll ends
+	JIIWinEvent pendingMouseMove;
+	bool hasPendingMouseMove;
+
+	// timestamp of the event that is going through the callbacks right now
+	u64 eventTimestamp;
+
+	JIIWinInputState input;
+
+	// set by the input thread once it stops, a Quit that did not fit in the queue still ends the window
+	u32 inputThreadQuit;
+
+	// only used by JII_HEADLESS windows, dispatched in order by the next poll
+	JIIWinEvent* injectedEvents;
+	u32 injectedEventCount;
 };
 
 enum JIIWinStatus {
@@ -260,7 +475,33 @@ extern "C" {
 
 	JIIDef const JIIWinHint JII_NO_HINT = 0;
 	JIIDef const JIIWinHint JII_NEED_OPENGL = 1;
-
+	// no OS window (or display connection) gets created, events only come from JIIWinInject*
+	JIIDef const JIIWinHint JII_HEADLESS = 2;
+	// input is queued as JIIWinEvents for JIIWinPollEvents instead of going through the callbacks
+	JIIDef const JIIWinHint JII_EVENT_QUEUE = 4;
+	// consecutive mouse moves within one poll are merged into a single event with the deltas summed
+	JIIDef const JIIWinHint JII_COALESCE_MOUSE_MOVE = 8;
+	// mouse move deltas come from raw input before pointer acceleration, only Win32 has it,
+	// XCB keeps computing them from the cursor positions
+	JIIDef const JIIWinHint JII_RAW_MOUSE = 16;
+	// the OS events are pumped on a thread of their own and drained with JIIWinPollEvents,
+	// implies JII_EVENT_QUEUE, JII_HEADLESS windows ignore it since there is nothing to pump
+	JIIDef const JIIWinHint JII_INPUT_THREAD = 32;
+
+	// monotonic nanoseconds, the clock every JIIWinEvent::timestamp is taken from
+	JIIDef u64 JIIWinGetTimestamp();
+	// for callbacks, the timestamp of the event being dispatched
+	JIIDef u64 JIIWinGetEventTimestamp(JIIWindow* window);
+
+	// the input state is kept up to date by every poll whatever the hints, call JIIWinBeginInputFrame
+	// once per frame before polling to reset the pressed/released edges and the mouse deltas
+	JIIDef void JIIWinBeginInputFrame(JIIWindow* window);
+	JIIDef bool JIIWinIsKeyDown(JIIWindow* window, JIIWinKeyCode code);
+	JIIDef bool JIIWinWasKeyPressed(JIIWindow* window, JIIWinKeyCode code);
+	JIIDef bool JIIWinWasKeyReleased(JIIWindow* window, JIIWinKeyCode code);
+	JIIDef const JIIWinInputState* JIIWinGetInputState(JIIWindow* window);
+
+	// always false on XCB, a JII_NEED_OPENGL window can't be created there in the first place
 	JIIDef bool JIIWinGLMakeContextCurrent(JIIWindow* window);
 
 	JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height, JIIWindow* window, JIIWinHint hints=JII_NO_HINT);
@@ -274,6 +515,21 @@ extern "C" {
 	JIIDef JIIWinEvent JIIWinPollEvent(JIIWindow* window);
 	JIIDef JIIWinEvent JIIWinWaitEvent(JIIWindow* window);
 
+	// only for JII_EVENT_QUEUE windows, handles everything the OS has pending (unless the input
+	// thread already does) and copies up to maxEvents queued events into events, returns how
+	// many were copied. Whatever did not fit stays queued for the next call.
+	JIIDef u32 JIIWinPollEvents(JIIWindow* window, JIIWinEvent* events, u32 maxEvents);
+
+	// only for JII_HEADLESS windows, these queue an event for the next JIIWinPollEvent/JIIWinWaitEvent
+	// and return false once JII_WIN_INJECT_CAPACITY events are pending. Not thread safe, inject from
+	// the thread that polls.
+	JIIDef bool JIIWinInjectKey(JIIWindow* window, JIIWinKeyState state, JIIWinKeyCode code, int scancode);
+	JIIDef bool JIIWinInjectMouseMove(JIIWindow* window, double x, double y);
+	JIIDef bool JIIWinInjectMouseButton(JIIWindow* window, JIIWinKeyState state, JIIWinKeyCode code);
+	JIIDef bool JIIWinInjectResize(JIIWindow* window, i32 width, i32 height);
+	JIIDef bool JIIWinInjectFocus(JIIWindow* window, bool focused);
+	JIIDef bool JIIWinInjectQuit(JIIWindow* window);
+
 #ifdef __cplusplus
 }
 #endif
@@ -299,299 +555,839 @@ extern "C" {
 #define JIIFree(...) free(__VA_ARGS__)
 #endif
 
+#ifndef JIITraceScope
+#define JIITraceScope(...)
+#endif
+
 #define JIIHasHint(hints, hint) (hints & hint)
 
-JIIPrivate JIIWinKeyCode jii_WinKeyCodeMap[0xff] = {};
-
-JIIPrivate void JIIWinInitializeKeycodes() {
-	jii_WinKeyCodeMap[VK_LBUTTON] = JIIWinKeyCode::MouseLeftButton;
-	jii_WinKeyCodeMap[VK_RBUTTON] = JIIWinKeyCode::MouseRightButton;
-	jii_WinKeyCodeMap[VK_CANCEL] = JIIWinKeyCode::KeyBreak;
-	jii_WinKeyCodeMap[VK_MBUTTON] = JIIWinKeyCode::MouseMiddleButton;
-	jii_WinKeyCodeMap[VK_XBUTTON1] = JIIWinKeyCode::MouseX1Button;
-	jii_WinKeyCodeMap[VK_XBUTTON2] = JIIWinKeyCode::MouseX2Button;
-	jii_WinKeyCodeMap[VK_BACK] = JIIWinKeyCode::KeyBackspace;
-	jii_WinKeyCodeMap[VK_TAB] = JIIWinKeyCode::KeyTab;
-	jii_WinKeyCodeMap[VK_CLEAR] = JIIWinKeyCode::KeyClear;
-	jii_WinKeyCodeMap[VK_RETURN] = JIIWinKeyCode::KeyEnter;
-	jii_WinKeyCodeMap[VK_SHIFT] = JIIWinKeyCode::KeyShift;
-	jii_WinKeyCodeMap[VK_CONTROL] = JIIWinKeyCode::KeyControl;
-	jii_WinKeyCodeMap[VK_MENU] = JIIWinKeyCode::KeyAlt;
-	jii_WinKeyCodeMap[VK_PAUSE] = JIIWinKeyCode::KeyPause;
-	jii_WinKeyCodeMap[VK_CAPITAL] = JIIWinKeyCode::KeyCapsLock;
-	jii_WinKeyCodeMap[VK_ESCAPE] = JIIWinKeyCode::KeyEsc;
-	jii_WinKeyCodeMap[VK_SPACE] = JIIWinKeyCode::KeySpace;
-	jii_WinKeyCodeMap[VK_PRIOR] = JIIWinKeyCode::KeyPageUp;
-	jii_WinKeyCodeMap[VK_NEXT] = JIIWinKeyCode::KeyPageDown;
-	jii_WinKeyCodeMap[VK_END] = JIIWinKeyCode::KeyEnd;
-	jii_WinKeyCodeMap[VK_HOME] = JIIWinKeyCode::KeyHome;
-	jii_WinKeyCodeMap[VK_LEFT] = JIIWinKeyCode::KeyLeft;
-	jii_WinKeyCodeMap[VK_UP] = JIIWinKeyCode::KeyUp;
-	jii_WinKeyCodeMap[VK_RIGHT] = JIIWinKeyCode::KeyRight;
-	jii_WinKeyCodeMap[VK_DOWN] = JIIWinKeyCode::KeyDown;
-	jii_WinKeyCodeMap[VK_SELECT] = JIIWinKeyCode::KeySelect;
-	jii_WinKeyCodeMap[VK_PRINT] = JIIWinKeyCode::KeyPrint;
-	jii_WinKeyCodeMap[VK_EXECUTE] = JIIWinKeyCode::KeyExecute;
-	jii_WinKeyCodeMap[VK_SNAPSHOT] = JIIWinKeyCode::KeyPrintScreen;
-	jii_WinKeyCodeMap[VK_INSERT] = JIIWinKeyCode::KeyIns;
-	jii_WinKeyCodeMap[VK_DELETE] = JIIWinKeyCode::KeyDel;
-	jii_WinKeyCodeMap[VK_HELP] = JIIWinKeyCode::KeyHelp;
-	jii_WinKeyCodeMap[0x30] = JIIWinKeyCode::Key0; 
-	jii_WinKeyCodeMap[0x31] = JIIWinKeyCode::Key1;
-	jii_WinKeyCodeMap[0x32] = JIIWinKeyCode::Key2;
-	jii_WinKeyCodeMap[0x33] = JIIWinKeyCode::Key3;
-	jii_WinKeyCodeMap[0x34] = JIIWinKeyCode::Key4;
-	jii_WinKeyCodeMap[0x35] = JIIWinKeyCode::Key5;
-	jii_WinKeyCodeMap[0x36] = JIIWinKeyCode::Key6;
-	jii_WinKeyCodeMap[0x37] = JIIWinKeyCode::Key7;
-	jii_WinKeyCodeMap[0x38] = JIIWinKeyCode::Key8;
-	jii_WinKeyCodeMap[0x39] = JIIWinKeyCode::Key9;
-	jii_WinKeyCodeMap[0x41] = JIIWinKeyCode::KeyA;
-	jii_WinKeyCodeMap[0x42] = JIIWinKeyCode::KeyB;
-	jii_WinKeyCodeMap[0x43] = JIIWinKeyCode::KeyC;
-	jii_WinKeyCodeMap[0x44] = JIIWinKeyCode::KeyD;
-	jii_WinKeyCodeMap[0x45] = JIIWinKeyCode::KeyE;
-	jii_WinKeyCodeMap[0x46] = JIIWinKeyCode::KeyF;
-	jii_WinKeyCodeMap[0x47] = JIIWinKeyCode::KeyG;
-	jii_WinKeyCodeMap[0x48] = JIIWinKeyCode::KeyH;
-	jii_WinKeyCodeMap[0x49] = JIIWinKeyCode::KeyI;
-	jii_WinKeyCodeMap[0x4A] = JIIWinKeyCode::KeyJ;
-	jii_WinKeyCodeMap[0x4B] = JIIWinKeyCode::KeyK;
-	jii_WinKeyCodeMap[0x4C] = JIIWinKeyCode::KeyL;
-	jii_WinKeyCodeMap[0x4D] = JIIWinKeyCode::KeyM;
-	jii_WinKeyCodeMap[0x4E] = JIIWinKeyCode::KeyN;
-	jii_WinKeyCodeMap[0x4F] = JIIWinKeyCode::KeyO;
-	jii_WinKeyCodeMap[0x50] = JIIWinKeyCode::KeyP;
-	jii_WinKeyCodeMap[0x51] = JIIWinKeyCode::KeyQ;
-	jii_WinKeyCodeMap[0x52] = JIIWinKeyCode::KeyR;
-	jii_WinKeyCodeMap[0x53] = JIIWinKeyCode::KeyS;
-	jii_WinKeyCodeMap[0x54] = JIIWinKeyCode::KeyT;
-	jii_WinKeyCodeMap[0x55] = JIIWinKeyCode::KeyU;
-	jii_WinKeyCodeMap[0x56] = JIIWinKeyCode::KeyV;
-	jii_WinKeyCodeMap[0x57] = JIIWinKeyCode::KeyW;
-	jii_WinKeyCodeMap[0x58] = JIIWinKeyCode::KeyX;
-	jii_WinKeyCodeMap[0x59] = JIIWinKeyCode::KeyY;
-	jii_WinKeyCodeMap[0x5A] = JIIWinKeyCode::KeyZ;
-	jii_WinKeyCodeMap[VK_LWIN] = JIIWinKeyCode::KeyLeftWindows;
-	jii_WinKeyCodeMap[VK_RWIN] = JIIWinKeyCode::KeyRightWindows;
-	jii_WinKeyCodeMap[VK_APPS] = JIIWinKeyCode::KeyApplications;
-	jii_WinKeyCodeMap[VK_SLEEP] = JIIWinKeyCode::KeySleep;
-	jii_WinKeyCodeMap[VK_NUMPAD0] = JIIWinKeyCode::KeyNumpad0;
-	jii_WinKeyCodeMap[VK_NUMPAD1] = JIIWinKeyCode::KeyNumpad1;
-	jii_WinKeyCodeMap[VK_NUMPAD2] = JIIWinKeyCode::KeyNumpad2;
-	jii_WinKeyCodeMap[VK_NUMPAD3] = JIIWinKeyCode::KeyNumpad3;
-	jii_WinKeyCodeMap[VK_NUMPAD4] = JIIWinKeyCode::KeyNumpad4;
-	jii_WinKeyCodeMap[VK_NUMPAD5] = JIIWinKeyCode::KeyNumpad5;
-	jii_WinKeyCodeMap[VK_NUMPAD6] = JIIWinKeyCode::KeyNumpad6;
-	jii_WinKeyCodeMap[VK_NUMPAD7] = JIIWinKeyCode::KeyNumpad7;
-	jii_WinKeyCodeMap[VK_NUMPAD8] = JIIWinKeyCode::KeyNumpad8;
-	jii_WinKeyCodeMap[VK_NUMPAD9] = JIIWinKeyCode::KeyNumpad9;
-	jii_WinKeyCodeMap[VK_MULTIPLY] = JIIWinKeyCode::KeyMultiply;
-	jii_WinKeyCodeMap[VK_ADD] = JIIWinKeyCode::KeyPlus;
-	jii_WinKeyCodeMap[VK_SEPARATOR] = JIIWinKeyCode::KeySeparator;
-	jii_WinKeyCodeMap[VK_SUBTRACT] = JIIWinKeyCode::KeyMinus;
-	jii_WinKeyCodeMap[VK_DECIMAL] = JIIWinKeyCode::KeyDot;
-	jii_WinKeyCodeMap[VK_DIVIDE] = JIIWinKeyCode::KeyDivide;
-	jii_WinKeyCodeMap[VK_F1] = JIIWinKeyCode::KeyF1;
-	jii_WinKeyCodeMap[VK_F2] = JIIWinKeyCode::KeyF2;
-	jii_WinKeyCodeMap[VK_F3] = JIIWinKeyCode::KeyF3;
-	jii_WinKeyCodeMap[VK_F4] = JIIWinKeyCode::KeyF4;
-	jii_WinKeyCodeMap[VK_F5] = JIIWinKeyCode::KeyF5;
-	jii_WinKeyCodeMap[VK_F6] = JIIWinKeyCode::KeyF6;
-	jii_WinKeyCodeMap[VK_F7] = JIIWinKeyCode::KeyF7;
-	jii_WinKeyCodeMap[VK_F8] = JIIWinKeyCode::KeyF8;
-	jii_WinKeyCodeMap[VK_F9] = JIIWinKeyCode::KeyF9;
-	// ???
-	jii_WinKeyCodeMap[VK_F10] = JIIWinKeyCode::KeyF10;
-	jii_WinKeyCodeMap[VK_F11] = JIIWinKeyCode::KeyF11;
-	jii_WinKeyCodeMap[VK_F12] = JIIWinKeyCode::KeyF12;
-	jii_WinKeyCodeMap[VK_F13] = JIIWinKeyCode::KeyF13;
-	jii_WinKeyCodeMap[VK_F14] = JIIWinKeyCode::KeyF14;
-	jii_WinKeyCodeMap[VK_F15] = JIIWinKeyCode::KeyF15;
-	jii_WinKeyCodeMap[VK_F16] = JIIWinKeyCode::KeyF16;
-	jii_WinKeyCodeMap[VK_F17] = JIIWinKeyCode::KeyF17;
-	jii_WinKeyCodeMap[VK_F18] = JIIWinKeyCode::KeyF18;
-	jii_WinKeyCodeMap[VK_F19] = JIIWinKeyCode::KeyF19;
-	jii_WinKeyCodeMap[VK_F20] = JIIWinKeyCode::KeyF20;
-	jii_WinKeyCodeMap[VK_F21] = JIIWinKeyCode::KeyF21;
-	jii_WinKeyCodeMap[VK_F22] = JIIWinKeyCode::KeyF22;
-	jii_WinKeyCodeMap[VK_F23] = JIIWinKeyCode::KeyF23;
-	jii_WinKeyCodeMap[VK_F24] = JIIWinKeyCode::KeyF24;
-	jii_WinKeyCodeMap[VK_NUMLOCK] = JIIWinKeyCode::KeyNumlock;
-	jii_WinKeyCodeMap[VK_SCROLL] = JIIWinKeyCode::KeyScrollLock;
-	jii_WinKeyCodeMap[VK_LSHIFT] = JIIWinKeyCode::KeyLeftShift;
-	jii_WinKeyCodeMap[VK_RSHIFT] = JIIWinKeyCode::KeyRightShift;
-	jii_WinKeyCodeMap[VK_LCONTROL] = JIIWinKeyCode::KeyLeftControl;
-	jii_WinKeyCodeMap[VK_RCONTROL] = JIIWinKeyCode::KeyRightControl;
-	jii_WinKeyCodeMap[VK_LMENU] = JIIWinKeyCode::KeyLeftAlt;
-	jii_WinKeyCodeMap[VK_RMENU] = JIIWinKeyCode::KeyRightAlt;
-}
+#ifndef JII_WIN_INJECT_CAPACITY
+#define JII_WIN_INJECT_CAPACITY 4096
+#endif
 
-JIIDef bool JIIWinGLMakeContextCurrent(JIIWindow* window) {
-	// TODO(Sarmis) we could silently ignore and just notify so the user handles the error
-	// TODO(Sarmis) platform specific
-	JIIAssert(window && window->win32.deviceContext && window->win32.glContext);
+#ifndef JII_WIN_EVENT_QUEUE_CAPACITY
+// has to be a power of 2
+#define JII_WIN_EVENT_QUEUE_CAPACITY 1024
+#endif
 
-	return wglMakeCurrent(window->win32.deviceContext, window->win32.glContext);
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <time.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define JIIWinAtomicLoad32(pointer) ((u32)_InterlockedOr((volatile long*)(pointer), 0))
+#define JIIWinAtomicStore32(pointer, value) _InterlockedExchange((volatile long*)(pointer), (long)(value))
+#else
+#define JIIWinAtomicLoad32(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define JIIWinAtomicStore32(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+#endif
+
+JIIDef u64 JIIWinGetTimestamp() {
+#if defined(_WIN32) || defined(_WIN64)
+	static LARGE_INTEGER frequency = {};
+	if (!frequency.QuadPart) {
+		QueryPerformanceFrequency(&frequency);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	u64 seconds = counter.QuadPart / frequency.QuadPart;
+	u64 remainder = counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000ull + (remainder * 1000000000ull) / frequency.QuadPart;
+#else
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (u64)time.tv_sec * 1000000000ull + (u64)time.tv_nsec;
+#endif
 }
 
-JIIDef JIIWinEvent JIIWinWaitEvent(JIIWindow* window) {
-	JIIAssert(window && window->win32.windowHandle);
+JIIPrivate void JIIWinResetInput(JIIWindow* window) {
+	window->injectedEvents = NULL;
+	window->injectedEventCount = 0;
 
-	JIIWinEvent result = {};
-	result.type = JIIWinEventType::None;
+	window->mouseX = 0;
+	window->mouseY = 0;
+	window->hasMousePosition = false;
 
-	MSG msg;
-	if (GetMessageA(&msg, NULL, 0, 0)) {
-		TranslateMessage(&msg);
-		DispatchMessageA(&msg);
+	window->pendingMouseMove = {};
+	window->hasPendingMouseMove = false;
 
-		switch (msg.message) {
-			case WM_QUIT: {
-				window->exited = true;
-				result.type = JIIWinEventType::Quit;
-				break;
-			}
-		}
-	}
+	window->eventTimestamp = 0;
 
-	return result;
+	window->input = {};
+
+	window->inputThreadQuit = 0;
 }
 
-JIIDef JIIWinEvent JIIWinPollEvent(JIIWindow* window) {
-	JIIAssert(window && window->win32.windowHandle);
+#define JIIWinTestKeyBit(bits, code) (((bits)[(code) / 64] >> ((code) % 64)) & 1)
 
-	JIIWinEvent result = {};
-	result.type = JIIWinEventType::None;
-	
-	MSG msg;
-	if (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE)) {
-		TranslateMessage(&msg);
-		DispatchMessageA(&msg);
+JIIPrivate void JIIWinUpdateKeyState(JIIWinInputState* input, JIIWinKeyCode code, JIIWinKeyState state) {
+	u32 word = code / 64;
+	u64 bit = 1ull << (code % 64);
 
-		switch (msg.message) {
-			case WM_QUIT: {
-				window->exited = true;
-				result.type = JIIWinEventType::Quit;
-				break;
-			}
+	if (state == JIIWinKeyState::Down) {
+		// held keys repeat their down events, only the first one is an edge
+		if (!(input->down[word] & bit)) {
+			input->pressed[word] |= bit;
 		}
+		input->down[word] |= bit;
+	} else {
+		if (input->down[word] & bit) {
+			input->released[word] |= bit;
+		}
+		input->down[word] &= ~bit;
 	}
+}
 
-	return result;
+JIIPrivate void JIIWinReleaseAllKeys(JIIWinInputState* input) {
+	for (u32 i = 0; i < JII_WIN_KEY_WORDS; ++i) {
+		input->released[i] |= input->down[i];
+		input->down[i] = 0;
+	}
 }
 
-JIIPrivate JIIWinStatus JIIWinGLCreateContext(JIIWindow* window) {
-	JIIAssert(window);
+// what an event changes on the window itself, runs on whichever thread owns the window state
+JIIPrivate void JIIWinApplyEvent(JIIWindow* window, JIIWinEvent* event) {
+	JIIWinInputState* input = &window->input;
 
-	if (!JIIHasHint(window->hints, JII_NEED_OPENGL)) {
-		return JIIWinStatus::Ok;
+	switch (event->type) {
+		case JIIWinEventType::Quit: {
+			window->exited = true;
+			break;
+		}
+		case JIIWinEventType::Resize: {
+			window->width = event->resize.width;
+			window->height = event->resize.height;
+			break;
+		}
+		case JIIWinEventType::Key: {
+			JIIWinUpdateKeyState(input, event->key.code, event->key.state);
+			break;
+		}
+		case JIIWinEventType::MouseButton: {
+			JIIWinUpdateKeyState(input, event->mouseButton.code, event->mouseButton.state);
+			break;
+		}
+		case JIIWinEventType::MouseMove: {
+			input->mouseX = event->mouseMove.x;
+			input->mouseY = event->mouseMove.y;
+			input->mouseDeltaX += event->mouseMove.deltaX;
+			input->mouseDeltaY += event->mouseMove.deltaY;
+			break;
+		}
+		case JIIWinEventType::Focus: {
+			// the releases go to whatever window has the focus now, let go of everything
+			if (!event->focus.focused) {
+				JIIWinReleaseAllKeys(input);
+			}
+			break;
+		}
+		default: {
+			break;
+		}
 	}
+}
 
-	// https://www.khronos.org/opengl/wiki/Creating_an_OpenGL_Context_(WGL)
-	PIXELFORMATDESCRIPTOR pfd = {
-		sizeof(PIXELFORMATDESCRIPTOR),
-		1,
-		PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,    //Flags
-		PFD_TYPE_RGBA,        // The kind of framebuffer. RGBA or palette.
-		32,                   // Colordepth of the framebuffer.
-		0, 0, 0, 0, 0, 0,
-		0,
-		0,
-		0,
-		0, 0, 0, 0,
-		24,                   // Number of bits for the depthbuffer
-		8,                    // Number of bits for the stencilbuffer
-		0,                    // Number of Aux buffers in the framebuffer.
-		PFD_MAIN_PLANE,
-		0,
-		0, 0, 0
-	};
-
-	HDC dc = GetDC(window->win32.windowHandle);
-	window->win32.deviceContext = dc;
+JIIPrivate JIIWinStatus JIIWinCreateEventQueue(JIIWindow* window) {
+	JIIAssert((JII_WIN_EVENT_QUEUE_CAPACITY & (JII_WIN_EVENT_QUEUE_CAPACITY - 1)) == 0);
 
-	int pixelFormat = ChoosePixelFormat(dc, &pfd);
-	SetPixelFormat(dc, pixelFormat, &pfd);
+	window->eventQueue = {};
+	if (!JIIHasHint(window->hints, JII_EVENT_QUEUE)) {
+		return JIIWinStatus::Ok;
+	}
 
-	HGLRC context = wglCreateContext(dc);
-	window->win32.glContext = context;
+	window->eventQueue.events = (JIIWinEvent*)JIIMalloc(sizeof(JIIWinEvent) * JII_WIN_EVENT_QUEUE_CAPACITY);
+	if (!window->eventQueue.events) {
+		return JIIWinStatus::Error;
+	}
+	window->eventQueue.capacity = JII_WIN_EVENT_QUEUE_CAPACITY;
 
 	return JIIWinStatus::Ok;
 }
 
-JIIPrivate void JIIWinHandleMouseMove(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
-	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
-	JIIAssert(window);
-
-	if (!window->callbacks.mouseMoveCallback) {
+JIIPrivate void JIIWinPushEvent(JIIWinEventQueue* queue, JIIWinEvent* event) {
+	u32 tail = queue->tail;
+	if (tail - JIIWinAtomicLoad32(&queue->head) == queue->capacity) {
+		JIIWinAtomicStore32(&queue->dropped, queue->dropped + 1);
 		return;
 	}
 
-	u32 masklo = ((1 << 16) - 1);
-	u32 maskhi = masklo << 16;
+	queue->events[tail & (queue->capacity - 1)] = *event;
+	JIIWinAtomicStore32(&queue->tail, tail + 1);
+}
 
-	double x = masklo & lParam;
-	double y = (maskhi & lParam) >> 16;
+JIIPrivate void JIIWinDispatchEvent(JIIWindow* window, JIIWinEvent* event) {
+	if (JIIHasHint(window->hints, JII_EVENT_QUEUE)) {
+		JIIWinPushEvent(&window->eventQueue, event);
+		return;
+	}
 
-	window->callbacks.mouseMoveCallback(window, x, y);
+	switch (event->type) {
+		case JIIWinEventType::Key: {
+			if (window->callbacks.keyboardCallback) {
+				window->eventTimestamp = event->timestamp;
+				window->callbacks.keyboardCallback(window, event->key.state, event->key.code, event->key.scancode);
+			}
+			break;
+		}
+		case JIIWinEventType::MouseMove: {
+			if (window->callbacks.mouseMoveCallback) {
+				window->eventTimestamp = event->timestamp;
+				window->callbacks.mouseMoveCallback(window, event->mouseMove.x, event->mouseMove.y);
+			}
+			break;
+		}
+		case JIIWinEventType::MouseButton: {
+			if (window->callbacks.mouseButtonCallback) {
+				window->eventTimestamp = event->timestamp;
+				window->callbacks.mouseButtonCallback(window, event->mouseButton.state, event->mouseButton.code);
+			}
+			break;
+		}
+		default: {
+			// no callbacks for the rest
+			break;
+		}
+	}
 }
 
-JIIPrivate void JIIWinHandleMouseButton(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
-	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
-	JIIAssert(window);
-
-	if (!window->callbacks.mouseButtonCallback) {
-		return;
+JIIPrivate void JIIWinFlushMouseMove(JIIWindow* window) {
+	if (window->hasPendingMouseMove) {
+		window->hasPendingMouseMove = false;
+		JIIWinDispatchEvent(window, &window->pendingMouseMove);
 	}
-	
-	JIIWinKeyState state;
-	JIIWinKeyCode code;
-	switch (message) {
-		case WM_LBUTTONDOWN: { code = JIIWinKeyCode::MouseLeftButton; state = JIIWinKeyState::Down; break; }
-		case WM_LBUTTONUP: { code = JIIWinKeyCode::MouseLeftButton; state = JIIWinKeyState::Up; break; }
+}
 
-		case WM_RBUTTONDOWN: { code = JIIWinKeyCode::MouseRightButton; state = JIIWinKeyState::Down; break; }
-		case WM_RBUTTONUP: { code = JIIWinKeyCode::MouseRightButton; state = JIIWinKeyState::Up; break; }
+// every backend hands its input to this, it either gets queued or goes to the callbacks,
+// every poll has to end with a JIIWinFlushMouseMove
+JIIPrivate void JIIWinEmitEvent(JIIWindow* window, JIIWinEvent* event) {
+	if (!event->timestamp) {
+		event->timestamp = JIIWinGetTimestamp();
+	}
 
-		case WM_MBUTTONDOWN: { code = JIIWinKeyCode::MouseMiddleButton; state = JIIWinKeyState::Down; break; }
-		case WM_MBUTTONUP: { code = JIIWinKeyCode::MouseMiddleButton; state = JIIWinKeyState::Up; break; }
+	// with an input thread the render thread applies them while draining the queue
+	if (!JIIHasHint(window->hints, JII_INPUT_THREAD)) {
+		JIIWinApplyEvent(window, event);
+	}
 
-		default: {
-			// why are we even here?
+	if (event->type == JIIWinEventType::MouseMove && JIIHasHint(window->hints, JII_COALESCE_MOUSE_MOVE)) {
+		if (!window->hasPendingMouseMove) {
+			window->pendingMouseMove = *event;
+			window->hasPendingMouseMove = true;
 			return;
 		}
+
+		// the merged move has the latest position and time and the sum of the deltas
+		JIIWinMouseMoveEvent* pending = &window->pendingMouseMove.mouseMove;
+		pending->x = event->mouseMove.x;
+		pending->y = event->mouseMove.y;
+		pending->deltaX += event->mouseMove.deltaX;
+		pending->deltaY += event->mouseMove.deltaY;
+		window->pendingMouseMove.timestamp = event->timestamp;
+		return;
 	}
 
-	window->callbacks.mouseButtonCallback(window, state, code);
+	// anything else keeps its order relative to the moves
+	JIIWinFlushMouseMove(window);
+	JIIWinDispatchEvent(window, event);
 }
 
-JIIPrivate void JIIWinHandleKeyDownAndUp(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
-	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
-	JIIAssert(window);
-
-	if (!window->callbacks.keyboardCallback) {
-		return;
+// for backends that only know the cursor position, the deltas come from the previous one
+JIIPrivate void JIIWinEmitMouseMove(JIIWindow* window, JIIWinEvent* event) {
+	if (window->hasMousePosition) {
+		event->mouseMove.deltaX = event->mouseMove.x - window->mouseX;
+		event->mouseMove.deltaY = event->mouseMove.y - window->mouseY;
 	}
 
-	JIIWinKeyState state = (HIWORD(lParam) & KF_UP) ? JIIWinKeyState::Up : JIIWinKeyState::Down;
+	window->mouseX = event->mouseMove.x;
+	window->mouseY = event->mouseMove.y;
+	window->hasMousePosition = true;
 
-	i32 scancode = (HIWORD(lParam) & (KF_EXTENDED | 0xff));
-	if (!scancode) {
-		scancode = MapVirtualKeyW((UINT)wParam, MAPVK_VK_TO_VSC);
+	JIIWinEmitEvent(window, event);
+}
+
+JIIPrivate void JIIWinEmitQuit(JIIWindow* window) {
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::Quit;
+	JIIWinEmitEvent(window, &event);
+
+	// after the push, once the consumer sees this everything the thread produced is in the queue
+	if (JIIHasHint(window->hints, JII_INPUT_THREAD)) {
+		JIIWinAtomicStore32(&window->inputThreadQuit, 1);
 	}
+}
 
-	if (scancode > 0xff || scancode < 0) {
-		return;
+JIIPrivate JIIWinStatus JIIWinCreateHeadless(JIIWindow* window) {
+	// nothing to make current without a window
+	if (JIIHasHint(window->hints, JII_NEED_OPENGL)) {
+		return JIIWinStatus::Error;
 	}
 
-	JIIWinKeyCode key = jii_WinKeyCodeMap[scancode];
+	window->injectedEvents = (JIIWinEvent*)JIIMalloc(sizeof(JIIWinEvent) * JII_WIN_INJECT_CAPACITY);
+	if (!window->injectedEvents) {
+		return JIIWinStatus::Error;
+	}
 
-	window->callbacks.keyboardCallback(window, state, key, scancode);
+	return JIIWinStatus::Ok;
 }
 
-JIIPrivate LRESULT CALLBACK JIIWndProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
-	switch (message) {
+JIIPrivate JIIWinHint JIIWinResolveHints(JIIWinHint hints) {
+	if (JIIHasHint(hints, JII_HEADLESS)) {
+		hints &= ~JII_INPUT_THREAD;
+	}
+
+	if (JIIHasHint(hints, JII_INPUT_THREAD)) {
+		hints |= JII_EVENT_QUEUE;
+	}
+
+	return hints;
+}
+
+JIIPrivate void JIIWinCleanQueues(JIIWindow* window) {
+	JIIFree(window->injectedEvents);
+	window->injectedEvents = NULL;
+	window->injectedEventCount = 0;
+
+	JIIFree(window->eventQueue.events);
+	window->eventQueue = {};
+}
+
+// dispatches everything that was injected since the last poll, callbacks are allowed
+// to inject more events and those get dispatched in the same call
+JIIPrivate JIIWinEvent JIIWinPollHeadless(JIIWindow* window) {
+	JIIAssert(window->injectedEvents);
+
+	JIIWinEvent result = {};
+	result.type = JIIWinEventType::None;
+
+	for (u32 i = 0; i < window->injectedEventCount; ++i) {
+		// copied, the callbacks could be injecting into the same buffer
+		JIIWinEvent event = window->injectedEvents[i];
+
+		switch (event.type) {
+			case JIIWinEventType::Quit: {
+				JIIWinEmitQuit(window);
+				result.type = JIIWinEventType::Quit;
+				break;
+			}
+			case JIIWinEventType::MouseMove: {
+				JIIWinEmitMouseMove(window, &event);
+				break;
+			}
+			default: {
+				JIIWinEmitEvent(window, &event);
+				break;
+			}
+		}
+	}
+	window->injectedEventCount = 0;
+
+	JIIWinFlushMouseMove(window);
+
+	return result;
+}
+
+JIIPrivate JIIWinEvent* JIIWinPushInjectedEvent(JIIWindow* window, JIIWinEventType type) {
+	JIIAssert(window && JIIHasHint(window->hints, JII_HEADLESS) && window->injectedEvents);
+
+	if (window->injectedEventCount >= JII_WIN_INJECT_CAPACITY) {
+		return NULL;
+	}
+
+	JIIWinEvent* event = &window->injectedEvents[window->injectedEventCount++];
+	*event = {};
+	event->type = type;
+	// stamped when injected so the time spent waiting for the poll shows up like it would on a real window
+	event->timestamp = JIIWinGetTimestamp();
+
+	return event;
+}
+
+JIIDef bool JIIWinInjectKey(JIIWindow* window, JIIWinKeyState state, JIIWinKeyCode code, int scancode) {
+	JIIWinEvent* event = JIIWinPushInjectedEvent(window, JIIWinEventType::Key);
+	if (!event) {
+		return false;
+	}
+
+	event->key.state = state;
+	event->key.code = code;
+	event->key.scancode = scancode;
+
+	return true;
+}
+
+JIIDef bool JIIWinInjectMouseMove(JIIWindow* window, double x, double y) {
+	JIIWinEvent* event = JIIWinPushInjectedEvent(window, JIIWinEventType::MouseMove);
+	if (!event) {
+		return false;
+	}
+
+	event->mouseMove.x = x;
+	event->mouseMove.y = y;
+
+	return true;
+}
+
+JIIDef bool JIIWinInjectMouseButton(JIIWindow* window, JIIWinKeyState state, JIIWinKeyCode code) {
+	JIIWinEvent* event = JIIWinPushInjectedEvent(window, JIIWinEventType::MouseButton);
+	if (!event) {
+		return false;
+	}
+
+	event->mouseButton.state = state;
+	event->mouseButton.code = code;
+
+	return true;
+}
+
+JIIDef bool JIIWinInjectResize(JIIWindow* window, i32 width, i32 height) {
+	JIIWinEvent* event = JIIWinPushInjectedEvent(window, JIIWinEventType::Resize);
+	if (!event) {
+		return false;
+	}
+
+	event->resize.width = width;
+	event->resize.height = height;
+
+	return true;
+}
+
+JIIDef bool JIIWinInjectFocus(JIIWindow* window, bool focused) {
+	JIIWinEvent* event = JIIWinPushInjectedEvent(window, JIIWinEventType::Focus);
+	if (!event) {
+		return false;
+	}
+
+	event->focus.focused = focused;
+
+	return true;
+}
+
+JIIDef bool JIIWinInjectQuit(JIIWindow* window) {
+	return JIIWinPushInjectedEvent(window, JIIWinEventType::Quit) != NULL;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+// indexed by virtual key code
+JIIPrivate const JIIWinKeyCode jii_WinKeyCodeMap[256] = {
+	// 0x00
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::MouseLeftButton, JIIWinKeyCode::MouseRightButton, JIIWinKeyCode::KeyBreak,
+	// 0x04
+	JIIWinKeyCode::MouseMiddleButton, JIIWinKeyCode::MouseX1Button, JIIWinKeyCode::MouseX2Button, JIIWinKeyCode::KeyUnknown,
+	// 0x08
+	JIIWinKeyCode::KeyBackspace, JIIWinKeyCode::KeyTab, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x0C
+	JIIWinKeyCode::KeyClear, JIIWinKeyCode::KeyEnter, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x10
+	JIIWinKeyCode::KeyShift, JIIWinKeyCode::KeyControl, JIIWinKeyCode::KeyAlt, JIIWinKeyCode::KeyPause,
+	// 0x14
+	JIIWinKeyCode::KeyCapsLock, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x18
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyEsc,
+	// 0x1C
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x20
+	JIIWinKeyCode::KeySpace, JIIWinKeyCode::KeyPageUp, JIIWinKeyCode::KeyPageDown, JIIWinKeyCode::KeyEnd,
+	// 0x24
+	JIIWinKeyCode::KeyHome, JIIWinKeyCode::KeyLeft, JIIWinKeyCode::KeyUp, JIIWinKeyCode::KeyRight,
+	// 0x28
+	JIIWinKeyCode::KeyDown, JIIWinKeyCode::KeySelect, JIIWinKeyCode::KeyPrint, JIIWinKeyCode::KeyExecute,
+	// 0x2C
+	JIIWinKeyCode::KeyPrintScreen, JIIWinKeyCode::KeyIns, JIIWinKeyCode::KeyDel, JIIWinKeyCode::KeyHelp,
+	// 0x30
+	JIIWinKeyCode::Key0, JIIWinKeyCode::Key1, JIIWinKeyCode::Key2, JIIWinKeyCode::Key3,
+	// 0x34
+	JIIWinKeyCode::Key4, JIIWinKeyCode::Key5, JIIWinKeyCode::Key6, JIIWinKeyCode::Key7,
+	// 0x38
+	JIIWinKeyCode::Key8, JIIWinKeyCode::Key9, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x3C
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x40
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyA, JIIWinKeyCode::KeyB, JIIWinKeyCode::KeyC,
+	// 0x44
+	JIIWinKeyCode::KeyD, JIIWinKeyCode::KeyE, JIIWinKeyCode::KeyF, JIIWinKeyCode::KeyG,
+	// 0x48
+	JIIWinKeyCode::KeyH, JIIWinKeyCode::KeyI, JIIWinKeyCode::KeyJ, JIIWinKeyCode::KeyK,
+	// 0x4C
+	JIIWinKeyCode::KeyL, JIIWinKeyCode::KeyM, JIIWinKeyCode::KeyN, JIIWinKeyCode::KeyO,
+	// 0x50
+	JIIWinKeyCode::KeyP, JIIWinKeyCode::KeyQ, JIIWinKeyCode::KeyR, JIIWinKeyCode::KeyS,
+	// 0x54
+	JIIWinKeyCode::KeyT, JIIWinKeyCode::KeyU, JIIWinKeyCode::KeyV, JIIWinKeyCode::KeyW,
+	// 0x58
+	JIIWinKeyCode::KeyX, JIIWinKeyCode::KeyY, JIIWinKeyCode::KeyZ, JIIWinKeyCode::KeyLeftWindows,
+	// 0x5C
+	JIIWinKeyCode::KeyRightWindows, JIIWinKeyCode::KeyApplications, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeySleep,
+	// 0x60
+	JIIWinKeyCode::KeyNumpad0, JIIWinKeyCode::KeyNumpad1, JIIWinKeyCode::KeyNumpad2, JIIWinKeyCode::KeyNumpad3,
+	// 0x64
+	JIIWinKeyCode::KeyNumpad4, JIIWinKeyCode::KeyNumpad5, JIIWinKeyCode::KeyNumpad6, JIIWinKeyCode::KeyNumpad7,
+	// 0x68
+	JIIWinKeyCode::KeyNumpad8, JIIWinKeyCode::KeyNumpad9, JIIWinKeyCode::KeyMultiply, JIIWinKeyCode::KeyPlus,
+	// 0x6C
+	JIIWinKeyCode::KeySeparator, JIIWinKeyCode::KeyMinus, JIIWinKeyCode::KeyDot, JIIWinKeyCode::KeyDivide,
+	// 0x70
+	JIIWinKeyCode::KeyF1, JIIWinKeyCode::KeyF2, JIIWinKeyCode::KeyF3, JIIWinKeyCode::KeyF4,
+	// 0x74
+	JIIWinKeyCode::KeyF5, JIIWinKeyCode::KeyF6, JIIWinKeyCode::KeyF7, JIIWinKeyCode::KeyF8,
+	// 0x78
+	JIIWinKeyCode::KeyF9, JIIWinKeyCode::KeyF10, JIIWinKeyCode::KeyF11, JIIWinKeyCode::KeyF12,
+	// 0x7C
+	JIIWinKeyCode::KeyF13, JIIWinKeyCode::KeyF14, JIIWinKeyCode::KeyF15, JIIWinKeyCode::KeyF16,
+	// 0x80
+	JIIWinKeyCode::KeyF17, JIIWinKeyCode::KeyF18, JIIWinKeyCode::KeyF19, JIIWinKeyCode::KeyF20,
+	// 0x84
+	JIIWinKeyCode::KeyF21, JIIWinKeyCode::KeyF22, JIIWinKeyCode::KeyF23, JIIWinKeyCode::KeyF24,
+	// 0x88
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x8C
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x90
+	JIIWinKeyCode::KeyNumlock, JIIWinKeyCode::KeyScrollLock, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x94
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x98
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0x9C
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xA0
+	JIIWinKeyCode::KeyLeftShift, JIIWinKeyCode::KeyRightShift, JIIWinKeyCode::KeyLeftControl, JIIWinKeyCode::KeyRightControl,
+	// 0xA4
+	JIIWinKeyCode::KeyLeftAlt, JIIWinKeyCode::KeyRightAlt, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xA8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xAC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xB0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xB4
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xB8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xBC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xC0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xC4
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xC8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xCC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xD0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xD4
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xD8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xDC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xE0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xE4
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xE8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xEC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xF0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xF4
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xF8
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 0xFC
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+};
+
+JIIDef bool JIIWinGLMakeContextCurrent(JIIWindow* window) {
+	// TODO(Sarmis) we could silently ignore and just notify so the user handles the error
+	// TODO(Sarmis) platform specific
+	JIIAssert(window && window->win32.deviceContext && window->win32.glContext);
+
+	return wglMakeCurrent(window->win32.deviceContext, window->win32.glContext);
+}
+
+JIIDef JIIWinEvent JIIWinWaitEvent(JIIWindow* window) {
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinPollHeadless(window);
+	}
+
+	// the messages belong to the input thread, drain with JIIWinPollEvents
+	JIIAssert(window && window->win32.windowHandle && !JIIHasHint(window->hints, JII_INPUT_THREAD));
+
+	JIIWinEvent result = {};
+	result.type = JIIWinEventType::None;
+
+	MSG msg;
+	if (GetMessageA(&msg, NULL, 0, 0)) {
+		TranslateMessage(&msg);
+		DispatchMessageA(&msg);
+
+		switch (msg.message) {
+			case WM_QUIT: {
+				JIIWinEmitQuit(window);
+				result.type = JIIWinEventType::Quit;
+				break;
+			}
+		}
+	}
+
+	JIIWinFlushMouseMove(window);
+
+	return result;
+}
+
+JIIDef JIIWinEvent JIIWinPollEvent(JIIWindow* window) {
+	JIITraceScope("JIIWinPollEvent");
+
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinPollHeadless(window);
+	}
+
+	JIIAssert(window && window->win32.windowHandle && !JIIHasHint(window->hints, JII_INPUT_THREAD));
+
+	JIIWinEvent result = {};
+	result.type = JIIWinEventType::None;
+	
+	MSG msg;
+	if (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE)) {
+		TranslateMessage(&msg);
+		DispatchMessageA(&msg);
+
+		switch (msg.message) {
+			case WM_QUIT: {
+				JIIWinEmitQuit(window);
+				result.type = JIIWinEventType::Quit;
+				break;
+			}
+		}
+	}
+
+	JIIWinFlushMouseMove(window);
+
+	return result;
+}
+
+// unlike JIIWinPollEvent this goes through every message that is pending
+JIIPrivate void JIIWinPumpEvents(JIIWindow* window) {
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		JIIWinPollHeadless(window);
+		return;
+	}
+
+	JIIAssert(window->win32.windowHandle);
+
+	MSG msg;
+	while (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE)) {
+		if (msg.message == WM_QUIT) {
+			JIIWinEmitQuit(window);
+			continue;
+		}
+
+		TranslateMessage(&msg);
+		DispatchMessageA(&msg);
+	}
+
+	JIIWinFlushMouseMove(window);
+}
+
+JIIPrivate JIIWinStatus JIIWinGLCreateContext(JIIWindow* window) {
+	JIIAssert(window);
+
+	if (!JIIHasHint(window->hints, JII_NEED_OPENGL)) {
+		return JIIWinStatus::Ok;
+	}
+
+	// https://www.khronos.org/opengl/wiki/Creating_an_OpenGL_Context_(WGL)
+	PIXELFORMATDESCRIPTOR pfd = {
+		sizeof(PIXELFORMATDESCRIPTOR),
+		1,
+		PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,    //Flags
+		PFD_TYPE_RGBA,        // The kind of framebuffer. RGBA or palette.
+		32,                   // Colordepth of the framebuffer.
+		0, 0, 0, 0, 0, 0,
+		0,
+		0,
+		0,
+		0, 0, 0, 0,
+		24,                   // Number of bits for the depthbuffer
+		8,                    // Number of bits for the stencilbuffer
+		0,                    // Number of Aux buffers in the framebuffer.
+		PFD_MAIN_PLANE,
+		0,
+		0, 0, 0
+	};
+
+	HDC dc = GetDC(window->win32.windowHandle);
+	window->win32.deviceContext = dc;
+
+	int pixelFormat = ChoosePixelFormat(dc, &pfd);
+	SetPixelFormat(dc, pixelFormat, &pfd);
+
+	HGLRC context = wglCreateContext(dc);
+	window->win32.glContext = context;
+
+	return JIIWinStatus::Ok;
+}
+
+JIIPrivate void JIIWinHandleMouseMove(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	JIIAssert(window);
+
+	u32 masklo = ((1 << 16) - 1);
+	u32 maskhi = masklo << 16;
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::MouseMove;
+	event.mouseMove.x = masklo & lParam;
+	event.mouseMove.y = (maskhi & lParam) >> 16;
+
+	// the moves come from WM_INPUT, only keep track of where the cursor is
+	if (JIIHasHint(window->hints, JII_RAW_MOUSE)) {
+		window->mouseX = event.mouseMove.x;
+		window->mouseY = event.mouseMove.y;
+		window->hasMousePosition = true;
+		return;
+	}
+
+	JIIWinEmitMouseMove(window, &event);
+}
+
+JIIPrivate void JIIWinHandleRawInput(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	if (!window) {
+		return;
+	}
+
+	RAWINPUT raw;
+	UINT size = sizeof(raw);
+	if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) {
+		return;
+	}
+
+	// absolute devices (tablets, remote desktop) have no deltas to report, buttons still go through WM_*BUTTON*
+	if (raw.header.dwType != RIM_TYPEMOUSE || (raw.data.mouse.usFlags & MOUSE_MOVE_ABSOLUTE)) {
+		return;
+	}
+
+	if (!raw.data.mouse.lLastX && !raw.data.mouse.lLastY) {
+		return;
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::MouseMove;
+	event.mouseMove.x = window->mouseX;
+	event.mouseMove.y = window->mouseY;
+	event.mouseMove.deltaX = raw.data.mouse.lLastX;
+	event.mouseMove.deltaY = raw.data.mouse.lLastY;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate void JIIWinHandleMouseButton(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	JIIAssert(window);
+
+	JIIWinKeyState state;
+	JIIWinKeyCode code;
+	switch (message) {
+		case WM_LBUTTONDOWN: { code = JIIWinKeyCode::MouseLeftButton; state = JIIWinKeyState::Down; break; }
+		case WM_LBUTTONUP: { code = JIIWinKeyCode::MouseLeftButton; state = JIIWinKeyState::Up; break; }
+
+		case WM_RBUTTONDOWN: { code = JIIWinKeyCode::MouseRightButton; state = JIIWinKeyState::Down; break; }
+		case WM_RBUTTONUP: { code = JIIWinKeyCode::MouseRightButton; state = JIIWinKeyState::Up; break; }
+
+		case WM_MBUTTONDOWN: { code = JIIWinKeyCode::MouseMiddleButton; state = JIIWinKeyState::Down; break; }
+		case WM_MBUTTONUP: { code = JIIWinKeyCode::MouseMiddleButton; state = JIIWinKeyState::Up; break; }
+
+		default: {
+			// why are we even here?
+			return;
+		}
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::MouseButton;
+	event.mouseButton.state = state;
+	event.mouseButton.code = code;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate void JIIWinHandleKeyDownAndUp(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	JIIAssert(window);
+
+	JIIWinKeyState state = (HIWORD(lParam) & KF_UP) ? JIIWinKeyState::Up : JIIWinKeyState::Down;
+
+	// extended keys (right control, arrows, ...) keep the KF_EXTENDED bit so they don't collide with the numpad
+	i32 scancode = (HIWORD(lParam) & (KF_EXTENDED | 0xff));
+	if (!scancode) {
+		scancode = MapVirtualKeyW((UINT)wParam, MAPVK_VK_TO_VSC);
+	}
+
+	// the map is indexed by virtual key, shift/control/alt only come in as the generic one
+	UINT virtualKey = (UINT)wParam;
+	switch (virtualKey) {
+		case VK_SHIFT: {
+			virtualKey = MapVirtualKeyW(scancode & 0xff, MAPVK_VSC_TO_VK_EX);
+			break;
+		}
+		case VK_CONTROL: {
+			virtualKey = (scancode & KF_EXTENDED) ? VK_RCONTROL : VK_LCONTROL;
+			break;
+		}
+		case VK_MENU: {
+			virtualKey = (scancode & KF_EXTENDED) ? VK_RMENU : VK_LMENU;
+			break;
+		}
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::Key;
+	event.key.state = state;
+	event.key.code = virtualKey < 256 ? jii_WinKeyCodeMap[virtualKey] : JIIWinKeyCode::KeyUnknown;
+	event.key.scancode = scancode;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate void JIIWinHandleSize(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	// WM_SIZE can show up while CreateWindowA is still running, before the window pointer is set
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	if (!window) {
+		return;
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::Resize;
+	event.resize.width = LOWORD(lParam);
+	event.resize.height = HIWORD(lParam);
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate void JIIWinHandleFocus(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIIWindow* window = (JIIWindow*)GetWindowLongPtrA(wnd, 0);
+	if (!window) {
+		return;
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::Focus;
+	event.focus.focused = message == WM_SETFOCUS;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate LRESULT CALLBACK JIIWndProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	JIITraceScope("JIIWndProc");
+
+	switch (message) {
 		case WM_CREATE: {
 			break;
 		}
@@ -610,33 +1406,520 @@ JIIPrivate LRESULT CALLBACK JIIWndProc(HWND wnd, UINT message, WPARAM wParam, LP
 			break;
 		}
 
-		case WM_MOUSEMOVE: {
-			JIIWinHandleMouseMove(wnd, message, wParam, lParam);
-			break;
-		}
+		case WM_MOUSEMOVE: {
+			JIIWinHandleMouseMove(wnd, message, wParam, lParam);
+			break;
+		}
+
+		case WM_INPUT: {
+			JIIWinHandleRawInput(wnd, message, wParam, lParam);
+			// raw input needs DefWindowProc to clean up after it
+			return DefWindowProcA(wnd, message, wParam, lParam);
+		}
+
+		case WM_KEYUP: 
+		case WM_KEYDOWN: {
+			JIIWinHandleKeyDownAndUp(wnd, message, wParam, lParam);
+			break;
+		};
+
+		// alt and F10 come through here, DefWindowProc still has to see them for alt-f4 and the menus
+		case WM_SYSKEYUP:
+		case WM_SYSKEYDOWN: {
+			JIIWinHandleKeyDownAndUp(wnd, message, wParam, lParam);
+			return DefWindowProcA(wnd, message, wParam, lParam);
+		}
+
+		case WM_SIZE: {
+			JIIWinHandleSize(wnd, message, wParam, lParam);
+			break;
+		}
+
+		case WM_SETFOCUS:
+		case WM_KILLFOCUS: {
+			JIIWinHandleFocus(wnd, message, wParam, lParam);
+			break;
+		}
+
+		default: {
+			return DefWindowProcA(wnd, message, wParam, lParam);
+		}
+	}
+	return 0;
+
+}
+
+JIIPrivate HINSTANCE JIIWinGetInstance() {
+	return GetModuleHandle(NULL);
+}
+
+#elif !defined(JII_WIN_NO_XCB)
+
+#include <string.h>
+
+// X keycodes are the evdev key codes shifted by 8 on every server that matters (evdev and libinput),
+// so the table below is indexed by the evdev code which is what gets passed around as the scancode
+#define JII_WIN_XCB_KEYCODE_OFFSET 8
+
+JIIPrivate const JIIWinKeyCode jii_WinXcbKeyCodeMap[] = {
+	// 0
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyEsc, JIIWinKeyCode::Key1, JIIWinKeyCode::Key2,
+	// 4
+	JIIWinKeyCode::Key3, JIIWinKeyCode::Key4, JIIWinKeyCode::Key5, JIIWinKeyCode::Key6,
+	// 8
+	JIIWinKeyCode::Key7, JIIWinKeyCode::Key8, JIIWinKeyCode::Key9, JIIWinKeyCode::Key0,
+	// 12
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyBackspace, JIIWinKeyCode::KeyTab,
+	// 16
+	JIIWinKeyCode::KeyQ, JIIWinKeyCode::KeyW, JIIWinKeyCode::KeyE, JIIWinKeyCode::KeyR,
+	// 20
+	JIIWinKeyCode::KeyT, JIIWinKeyCode::KeyY, JIIWinKeyCode::KeyU, JIIWinKeyCode::KeyI,
+	// 24
+	JIIWinKeyCode::KeyO, JIIWinKeyCode::KeyP, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 28
+	JIIWinKeyCode::KeyEnter, JIIWinKeyCode::KeyLeftControl, JIIWinKeyCode::KeyA, JIIWinKeyCode::KeyS,
+	// 32
+	JIIWinKeyCode::KeyD, JIIWinKeyCode::KeyF, JIIWinKeyCode::KeyG, JIIWinKeyCode::KeyH,
+	// 36
+	JIIWinKeyCode::KeyJ, JIIWinKeyCode::KeyK, JIIWinKeyCode::KeyL, JIIWinKeyCode::KeyUnknown,
+	// 40
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyLeftShift, JIIWinKeyCode::KeyUnknown,
+	// 44
+	JIIWinKeyCode::KeyZ, JIIWinKeyCode::KeyX, JIIWinKeyCode::KeyC, JIIWinKeyCode::KeyV,
+	// 48
+	JIIWinKeyCode::KeyB, JIIWinKeyCode::KeyN, JIIWinKeyCode::KeyM, JIIWinKeyCode::KeyUnknown,
+	// 52
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyRightShift, JIIWinKeyCode::KeyMultiply,
+	// 56
+	JIIWinKeyCode::KeyLeftAlt, JIIWinKeyCode::KeySpace, JIIWinKeyCode::KeyCapsLock, JIIWinKeyCode::KeyF1,
+	// 60
+	JIIWinKeyCode::KeyF2, JIIWinKeyCode::KeyF3, JIIWinKeyCode::KeyF4, JIIWinKeyCode::KeyF5,
+	// 64
+	JIIWinKeyCode::KeyF6, JIIWinKeyCode::KeyF7, JIIWinKeyCode::KeyF8, JIIWinKeyCode::KeyF9,
+	// 68
+	JIIWinKeyCode::KeyF10, JIIWinKeyCode::KeyNumlock, JIIWinKeyCode::KeyScrollLock, JIIWinKeyCode::KeyNumpad7,
+	// 72
+	JIIWinKeyCode::KeyNumpad8, JIIWinKeyCode::KeyNumpad9, JIIWinKeyCode::KeyMinus, JIIWinKeyCode::KeyNumpad4,
+	// 76
+	JIIWinKeyCode::KeyNumpad5, JIIWinKeyCode::KeyNumpad6, JIIWinKeyCode::KeyPlus, JIIWinKeyCode::KeyNumpad1,
+	// 80
+	JIIWinKeyCode::KeyNumpad2, JIIWinKeyCode::KeyNumpad3, JIIWinKeyCode::KeyNumpad0, JIIWinKeyCode::KeyDot,
+	// 84
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyF11,
+	// 88
+	JIIWinKeyCode::KeyF12, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 92
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 96
+	JIIWinKeyCode::KeyEnter, JIIWinKeyCode::KeyRightControl, JIIWinKeyCode::KeyDivide, JIIWinKeyCode::KeyPrintScreen,
+	// 100
+	JIIWinKeyCode::KeyRightAlt, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyHome, JIIWinKeyCode::KeyUp,
+	// 104
+	JIIWinKeyCode::KeyPageUp, JIIWinKeyCode::KeyLeft, JIIWinKeyCode::KeyRight, JIIWinKeyCode::KeyEnd,
+	// 108
+	JIIWinKeyCode::KeyDown, JIIWinKeyCode::KeyPageDown, JIIWinKeyCode::KeyIns, JIIWinKeyCode::KeyDel,
+	// 112
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 116
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyPause,
+	// 120
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeySeparator, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 124
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyLeftWindows, JIIWinKeyCode::KeyRightWindows, JIIWinKeyCode::KeyApplications,
+	// 128
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 132
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 136
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyHelp, JIIWinKeyCode::KeyUnknown,
+	// 140
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeySleep, JIIWinKeyCode::KeyUnknown,
+	// 144
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 148
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 152
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 156
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 160
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 164
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 168
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 172
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 176
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown,
+	// 180
+	JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyUnknown, JIIWinKeyCode::KeyF13,
+	// 184
+	JIIWinKeyCode::KeyF14, JIIWinKeyCode::KeyF15, JIIWinKeyCode::KeyF16, JIIWinKeyCode::KeyF17,
+	// 188
+	JIIWinKeyCode::KeyF18, JIIWinKeyCode::KeyF19, JIIWinKeyCode::KeyF20, JIIWinKeyCode::KeyF21,
+	// 192
+	JIIWinKeyCode::KeyF22, JIIWinKeyCode::KeyF23, JIIWinKeyCode::KeyF24,
+};
+
+// no GLX/EGL on this backend, JIIWinCreateWindow returns Error for JII_NEED_OPENGL
+// so there is never a context to make current
+JIIDef bool JIIWinGLMakeContextCurrent(JIIWindow* window) {
+	JIIAssert(window);
+
+	return false;
+}
+
+JIIPrivate void JIIWinXcbHandleKey(JIIWindow* window, xcb_key_press_event_t* xcbEvent, JIIWinKeyState state) {
+	i32 scancode = (i32)xcbEvent->detail - JII_WIN_XCB_KEYCODE_OFFSET;
+
+	JIIWinKeyCode key = JIIWinKeyCode::KeyUnknown;
+	if (scancode >= 0 && scancode < (i32)(sizeof(jii_WinXcbKeyCodeMap) / sizeof(jii_WinXcbKeyCodeMap[0]))) {
+		key = jii_WinXcbKeyCodeMap[scancode];
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::Key;
+	event.key.state = state;
+	event.key.code = key;
+	event.key.scancode = scancode;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+JIIPrivate void JIIWinXcbHandleMouseButton(JIIWindow* window, xcb_button_press_event_t* xcbEvent, JIIWinKeyState state) {
+	JIIWinKeyCode code;
+	switch (xcbEvent->detail) {
+		case XCB_BUTTON_INDEX_1: { code = JIIWinKeyCode::MouseLeftButton; break; }
+		case XCB_BUTTON_INDEX_2: { code = JIIWinKeyCode::MouseMiddleButton; break; }
+		case XCB_BUTTON_INDEX_3: { code = JIIWinKeyCode::MouseRightButton; break; }
+		case 8: { code = JIIWinKeyCode::MouseX1Button; break; }
+		case 9: { code = JIIWinKeyCode::MouseX2Button; break; }
+
+		default: {
+			// 4 to 7 are the scroll wheel
+			return;
+		}
+	}
+
+	JIIWinEvent event = {};
+	event.type = JIIWinEventType::MouseButton;
+	event.mouseButton.state = state;
+	event.mouseButton.code = code;
+
+	JIIWinEmitEvent(window, &event);
+}
+
+// returns true if the event closes the window
+JIIPrivate bool JIIWinXcbHandleEvent(JIIWindow* window, xcb_generic_event_t* xcbEvent) {
+	switch (xcbEvent->response_type & ~0x80) {
+		case XCB_KEY_PRESS: {
+			JIIWinXcbHandleKey(window, (xcb_key_press_event_t*)xcbEvent, JIIWinKeyState::Down);
+			break;
+		}
+		case XCB_KEY_RELEASE: {
+			JIIWinXcbHandleKey(window, (xcb_key_release_event_t*)xcbEvent, JIIWinKeyState::Up);
+			break;
+		}
+
+		case XCB_BUTTON_PRESS: {
+			JIIWinXcbHandleMouseButton(window, (xcb_button_press_event_t*)xcbEvent, JIIWinKeyState::Down);
+			break;
+		}
+		case XCB_BUTTON_RELEASE: {
+			JIIWinXcbHandleMouseButton(window, (xcb_button_release_event_t*)xcbEvent, JIIWinKeyState::Up);
+			break;
+		}
+
+		case XCB_MOTION_NOTIFY: {
+			xcb_motion_notify_event_t* motion = (xcb_motion_notify_event_t*)xcbEvent;
+
+			JIIWinEvent event = {};
+			event.type = JIIWinEventType::MouseMove;
+			event.mouseMove.x = motion->event_x;
+			event.mouseMove.y = motion->event_y;
+
+			JIIWinEmitMouseMove(window, &event);
+			break;
+		}
+
+		case XCB_CONFIGURE_NOTIFY: {
+			xcb_configure_notify_event_t* configure = (xcb_configure_notify_event_t*)xcbEvent;
+
+			// moving the window sends these as well
+			if (configure->width == window->xcb.width && configure->height == window->xcb.height) {
+				break;
+			}
+
+			window->xcb.width = configure->width;
+			window->xcb.height = configure->height;
+
+			JIIWinEvent event = {};
+			event.type = JIIWinEventType::Resize;
+			event.resize.width = window->xcb.width;
+			event.resize.height = window->xcb.height;
+
+			JIIWinEmitEvent(window, &event);
+			break;
+		}
+
+		case XCB_FOCUS_IN:
+		case XCB_FOCUS_OUT: {
+			xcb_focus_in_event_t* focus = (xcb_focus_in_event_t*)xcbEvent;
+
+			// keyboard grabs (alt-tab switchers and the like) bounce the focus without the window losing it
+			if (focus->mode == XCB_NOTIFY_MODE_GRAB || focus->mode == XCB_NOTIFY_MODE_UNGRAB) {
+				break;
+			}
+
+			JIIWinEvent event = {};
+			event.type = JIIWinEventType::Focus;
+			event.focus.focused = (xcbEvent->response_type & ~0x80) == XCB_FOCUS_IN;
+
+			JIIWinEmitEvent(window, &event);
+			break;
+		}
+
+		case XCB_CLIENT_MESSAGE: {
+			xcb_client_message_event_t* message = (xcb_client_message_event_t*)xcbEvent;
+			return window->xcb.deleteWindowAtom != XCB_NONE && message->data.data32[0] == window->xcb.deleteWindowAtom;
+		}
+		case XCB_DESTROY_NOTIFY: {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// without detectable autorepeat a held key sends a release and a press with the same time for
+// every repeat, the release is dropped and the press goes out as a repeated Down like on Win32
+JIIPrivate bool JIIWinXcbIsAutoRepeatRelease(xcb_generic_event_t* xcbEvent, xcb_generic_event_t* next) {
+	if (!next || (xcbEvent->response_type & ~0x80) != XCB_KEY_RELEASE || (next->response_type & ~0x80) != XCB_KEY_PRESS) {
+		return false;
+	}
+
+	xcb_key_release_event_t* release = (xcb_key_release_event_t*)xcbEvent;
+	xcb_key_press_event_t* press = (xcb_key_press_event_t*)next;
+
+	return release->detail == press->detail && release->time == press->time;
+}
+
+// handles the event it was given and then everything xcb has already read from the socket,
+// xcb_poll_for_queued_event never touches the connection so this is a single read per call
+// (and one more when a key release is the last event read, its repeated press could be right behind)
+JIIPrivate JIIWinEvent JIIWinXcbDrainEvents(JIIWindow* window, xcb_generic_event_t* xcbEvent) {
+	JIIWinEvent result = {};
+	result.type = JIIWinEventType::None;
+
+	bool quit = false;
+	while (xcbEvent) {
+		xcb_generic_event_t* next = xcb_poll_for_queued_event(window->xcb.connection);
+
+		if (!window->xcb.detectableAutoRepeat && (xcbEvent->response_type & ~0x80) == XCB_KEY_RELEASE) {
+			if (!next) {
+				next = xcb_poll_for_event(window->xcb.connection);
+			}
+
+			if (JIIWinXcbIsAutoRepeatRelease(xcbEvent, next)) {
+				free(xcbEvent);
+				xcbEvent = next;
+				continue;
+			}
+		}
+
+		quit |= JIIWinXcbHandleEvent(window, xcbEvent);
+		free(xcbEvent);
+
+		xcbEvent = next;
+	}
+
+	JIIWinFlushMouseMove(window);
+
+	if (quit || xcb_connection_has_error(window->xcb.connection)) {
+		// a broken connection stays broken, only report it once
+		if (!window->xcb.quitReported) {
+			window->xcb.quitReported = true;
+			JIIWinEmitQuit(window);
+		}
+		result.type = JIIWinEventType::Quit;
+	}
+
+	return result;
+}
+
+JIIDef JIIWinEvent JIIWinWaitEvent(JIIWindow* window) {
+	// nothing can show up while a headless window waits, the injector is this same thread
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinPollHeadless(window);
+	}
+
+	// the events belong to the input thread, drain with JIIWinPollEvents
+	JIIAssert(window && window->xcb.connection && !JIIHasHint(window->hints, JII_INPUT_THREAD));
+
+	return JIIWinXcbDrainEvents(window, xcb_wait_for_event(window->xcb.connection));
+}
+
+JIIDef JIIWinEvent JIIWinPollEvent(JIIWindow* window) {
+	JIITraceScope("JIIWinPollEvent");
+
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinPollHeadless(window);
+	}
+
+	JIIAssert(window && window->xcb.connection && !JIIHasHint(window->hints, JII_INPUT_THREAD));
+
+	return JIIWinXcbDrainEvents(window, xcb_poll_for_event(window->xcb.connection));
+}
+
+// JIIWinPollEvent already goes through everything that is pending on xcb
+JIIPrivate void JIIWinPumpEvents(JIIWindow* window) {
+	JIIWinPollEvent(window);
+}
+
+JIIPrivate xcb_atom_t JIIWinXcbGetAtomReply(xcb_connection_t* connection, xcb_intern_atom_cookie_t cookie) {
+	xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection, cookie, NULL);
+	if (!reply) {
+		return XCB_NONE;
+	}
+
+	xcb_atom_t atom = reply->atom;
+	free(reply);
+
+	return atom;
+}
+
+#ifndef JII_WIN_NO_XKB
+// returns true once the server only repeats the presses of held keys
+JIIPrivate bool JIIWinXcbEnableDetectableAutoRepeat(xcb_connection_t* connection) {
+	// a request to an extension the server doesn't have breaks the connection
+	const xcb_query_extension_reply_t* extension = xcb_get_extension_data(connection, &xcb_xkb_id);
+	if (!extension || !extension->present) {
+		return false;
+	}
 
-		case WM_KEYUP: 
-		case WM_KEYDOWN: {
-			JIIWinHandleKeyDownAndUp(wnd, message, wParam, lParam);
-			break;
-		};
+	// the server handles them in order, both go out before waiting on any of the replies
+	xcb_xkb_use_extension_cookie_t useCookie = xcb_xkb_use_extension(connection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION);
+	xcb_xkb_per_client_flags_cookie_t flagsCookie = xcb_xkb_per_client_flags(connection, XCB_XKB_ID_USE_CORE_KBD,
+		XCB_XKB_PER_CLIENT_FLAG_DETECTABLE_AUTO_REPEAT, XCB_XKB_PER_CLIENT_FLAG_DETECTABLE_AUTO_REPEAT, 0, 0, 0);
 
-		default: {
-			return DefWindowProcA(wnd, message, wParam, lParam);
+	xcb_xkb_use_extension_reply_t* useReply = xcb_xkb_use_extension_reply(connection, useCookie, NULL);
+	xcb_xkb_per_client_flags_reply_t* flagsReply = xcb_xkb_per_client_flags_reply(connection, flagsCookie, NULL);
+
+	bool enabled = useReply && useReply->supported &&
+		flagsReply && (flagsReply->value & XCB_XKB_PER_CLIENT_FLAG_DETECTABLE_AUTO_REPEAT);
+
+	free(useReply);
+	free(flagsReply);
+
+	return enabled;
+}
+#endif
+
+JIIPrivate void* JIIWinInputThreadProc(void* data) {
+	JIIWindow* window = (JIIWindow*)data;
+
+	// xcb_wait_for_event returns NULL once the connection breaks, which reports the quit
+	while (!window->xcb.quitReported) {
+		xcb_generic_event_t* xcbEvent = xcb_wait_for_event(window->xcb.connection);
+		if (JIIWinAtomicLoad32(&window->xcb.stopInputThread)) {
+			free(xcbEvent);
+			break;
 		}
+
+		JIIWinXcbDrainEvents(window, xcbEvent);
 	}
-	return 0;
 
+	return NULL;
 }
 
-JIIPrivate HINSTANCE JIIWinGetInstance() {
-	return GetModuleHandle(NULL);
+JIIPrivate void JIIWinStopInputThread(JIIWindow* window) {
+	JIIWinAtomicStore32(&window->xcb.stopInputThread, 1);
+
+	// xcb_wait_for_event only comes back for an event, a client message with no event mask
+	// goes straight to whoever created the window
+	xcb_client_message_event_t wake = {};
+	wake.response_type = XCB_CLIENT_MESSAGE;
+	wake.format = 32;
+	wake.window = window->xcb.windowHandle;
+	wake.type = XCB_ATOM_NONE;
+
+	xcb_send_event(window->xcb.connection, 0, window->xcb.windowHandle, XCB_EVENT_MASK_NO_EVENT, (const char*)&wake);
+	xcb_flush(window->xcb.connection);
+
+	pthread_join(window->xcb.inputThread, NULL);
+	window->xcb.hasInputThread = false;
+}
+
+#else
+
+// JII_WIN_NO_XCB, no backend to talk to so only JII_HEADLESS windows exist
+
+JIIDef bool JIIWinGLMakeContextCurrent(JIIWindow* window) {
+	JIIAssert(window);
+
+	return false;
+}
+
+JIIDef JIIWinEvent JIIWinWaitEvent(JIIWindow* window) {
+	JIIAssert(window && JIIHasHint(window->hints, JII_HEADLESS));
+
+	return JIIWinPollHeadless(window);
+}
+
+JIIDef JIIWinEvent JIIWinPollEvent(JIIWindow* window) {
+	JIITraceScope("JIIWinPollEvent");
+	JIIAssert(window && JIIHasHint(window->hints, JII_HEADLESS));
+
+	return JIIWinPollHeadless(window);
+}
+
+JIIPrivate void JIIWinPumpEvents(JIIWindow* window) {
+	JIIWinPollHeadless(window);
 }
 
+#endif
+
 JIIDef bool JIIWinExited(JIIWindow* window) {
 	return window->exited;
 }
 
+JIIDef u64 JIIWinGetEventTimestamp(JIIWindow* window) {
+	return window->eventTimestamp;
+}
+
+JIIDef void JIIWinBeginInputFrame(JIIWindow* window) {
+	JIIAssert(window);
+
+	for (u32 i = 0; i < JII_WIN_KEY_WORDS; ++i) {
+		window->input.pressed[i] = 0;
+		window->input.released[i] = 0;
+	}
+
+	window->input.mouseDeltaX = 0;
+	window->input.mouseDeltaY = 0;
+}
+
+JIIDef bool JIIWinIsKeyDown(JIIWindow* window, JIIWinKeyCode code) {
+	JIIAssert(window && code < JII_WIN_KEY_COUNT);
+	return JIIWinTestKeyBit(window->input.down, code);
+}
+
+JIIDef bool JIIWinWasKeyPressed(JIIWindow* window, JIIWinKeyCode code) {
+	JIIAssert(window && code < JII_WIN_KEY_COUNT);
+	return JIIWinTestKeyBit(window->input.pressed, code);
+}
+
+JIIDef bool JIIWinWasKeyReleased(JIIWindow* window, JIIWinKeyCode code) {
+	JIIAssert(window && code < JII_WIN_KEY_COUNT);
+	return JIIWinTestKeyBit(window->input.released, code);
+}
+
+JIIDef const JIIWinInputState* JIIWinGetInputState(JIIWindow* window) {
+	JIIAssert(window);
+	return &window->input;
+}
+
 JIIDef void JIIWinSetKeyboardCallback(JIIWindow* window, JIIWinSetKeyboardCallbackType callback) {
 	JIIAssert(callback);
 	window->callbacks.keyboardCallback = callback;
@@ -652,42 +1935,71 @@ JIIDef void JIIWinSetMouseButtonCallback(JIIWindow* window, JIIWinSetMouseButton
 	window->callbacks.mouseButtonCallback = callback;
 }
 
-JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height, JIIWindow* window, JIIWinHint hints){
-	// TODO(Sarmis) platform specific
-	JIIAssert(window && title);
+JIIDef u32 JIIWinPollEvents(JIIWindow* window, JIIWinEvent* events, u32 maxEvents) {
+	JIIAssert(window && events && JIIHasHint(window->hints, JII_EVENT_QUEUE));
+	JIITraceScope("JIIWinPollEvents");
 
-	// TODO(Sarmis) this should be hard coded without a function call needed, this should not be called here, but for now
-	// this will have to do.
-	JIIWinInitializeKeycodes();
+	bool inputThread = JIIHasHint(window->hints, JII_INPUT_THREAD);
+	if (!inputThread) {
+		JIIWinPumpEvents(window);
+	}
 
-	window->callbacks.keyboardCallback = NULL;
-	window->callbacks.mouseMoveCallback = NULL;
-	window->callbacks.mouseButtonCallback = NULL;
+	JIIWinEventQueue* queue = &window->eventQueue;
 
-	// simply combine hints
-	window->hints = hints;
-	window->exited = false;
+	// loaded before the tail so a set flag means the tail below has everything
+	bool inputThreadQuit = inputThread && JIIWinAtomicLoad32(&window->inputThreadQuit);
+	u32 dropped = inputThread ? JIIWinAtomicLoad32(&queue->dropped) : 0;
 
-	window->width = width;
-	window->height = height;
-	window->title = (char*)title;
+	u32 head = queue->head;
+	u32 tail = JIIWinAtomicLoad32(&queue->tail);
+	u32 count = tail - head;
+	if (count > maxEvents) {
+		count = maxEvents;
+	}
+
+	for (u32 i = 0; i < count; ++i) {
+		events[i] = queue->events[(head + i) & (queue->capacity - 1)];
+	}
+
+	JIIWinAtomicStore32(&queue->head, head + count);
 
-	window->win32.windowClass = {};
+	if (inputThread) {
+		for (u32 i = 0; i < count; ++i) {
+			JIIWinApplyEvent(window, &events[i]);
+		}
+
+		// a dropped KeyUp or ButtonUp would leave its key held for good, resync like a focus loss does
+		if (dropped != queue->seenDropped) {
+			queue->seenDropped = dropped;
+			JIIWinReleaseAllKeys(&window->input);
+		}
+		// the Quit itself could have been dropped by a full queue, only end once it is drained
+		if (inputThreadQuit && head + count == tail) {
+			window->exited = true;
+		}
+	}
+
+	return count;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+JIIPrivate JIIWinStatus JIIWinCreateNativeWindow(JIIWindow* window) {
 	window->win32.windowClass.cbWndExtra = sizeof(JIIWindow*);
 	window->win32.windowClass.lpfnWndProc = JIIWndProc;
 	window->win32.windowClass.hInstance = JIIWinGetInstance();
-	window->win32.windowClass.lpszClassName = title;
+	window->win32.windowClass.lpszClassName = window->title;
 	
 	if (!RegisterClassA(&window->win32.windowClass)) {
 		return JIIWinStatus::Error;
 	}
 
 	window->win32.windowHandle = CreateWindowA(
-		window->win32.windowClass.lpszClassName, title,
+		window->win32.windowClass.lpszClassName, window->title,
 		WS_TILEDWINDOW,
 		CW_USEDEFAULT,
 		CW_USEDEFAULT,
-		width, height,
+		window->width, window->height,
 		NULL, NULL, window->win32.windowClass.hInstance, NULL);
 
 	if(!window->win32.windowHandle) {
@@ -696,8 +2008,128 @@ JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height,
 
 	SetWindowLongPtrA(window->win32.windowHandle, 0, (LONG_PTR)window);
 
+	if (JIIHasHint(window->hints, JII_RAW_MOUSE)) {
+		RAWINPUTDEVICE device = {};
+		device.usUsagePage = 0x01; // generic desktop
+		device.usUsage = 0x02; // mouse
+		device.hwndTarget = window->win32.windowHandle;
+
+		// without raw input the deltas come from WM_MOUSEMOVE like they would without the hint
+		if (!RegisterRawInputDevices(&device, 1, sizeof(device))) {
+			window->hints &= ~JII_RAW_MOUSE;
+		}
+	}
+
 	ShowWindow(window->win32.windowHandle, SW_NORMAL);
 
+	return JIIWinStatus::Ok;
+}
+
+JIIPrivate DWORD WINAPI JIIWinInputThreadProc(LPVOID data) {
+	JIIWindow* window = (JIIWindow*)data;
+
+	// the messages of a window only ever show up on the thread that created it
+	bool created = JIIWinCreateNativeWindow(window) == JIIWinStatus::Ok;
+	window->win32.inputThreadCreatedWindow = created;
+	SetEvent(window->win32.inputThreadReady);
+
+	if (!created) {
+		return 0;
+	}
+
+	MSG msg;
+	for (;;) {
+		// merged mouse moves go out once a burst is over, there is no poll to end it here
+		if (!PeekMessageA(&msg, NULL, 0, 0, PM_NOREMOVE)) {
+			JIIWinFlushMouseMove(window);
+		}
+
+		// 0 for WM_QUIT, -1 if something went wrong
+		if (GetMessageA(&msg, NULL, 0, 0) <= 0) {
+			break;
+		}
+
+		TranslateMessage(&msg);
+		DispatchMessageA(&msg);
+	}
+
+	JIIWinFlushMouseMove(window);
+	JIIWinEmitQuit(window);
+
+	return 0;
+}
+
+JIIPrivate JIIWinStatus JIIWinStartInputThread(JIIWindow* window) {
+	window->win32.inputThreadReady = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (!window->win32.inputThreadReady) {
+		return JIIWinStatus::Error;
+	}
+
+	window->win32.inputThread = CreateThread(NULL, 0, JIIWinInputThreadProc, window, 0, NULL);
+	if (window->win32.inputThread) {
+		WaitForSingleObject(window->win32.inputThreadReady, INFINITE);
+	}
+
+	CloseHandle(window->win32.inputThreadReady);
+	window->win32.inputThreadReady = NULL;
+
+	if (!window->win32.inputThread) {
+		return JIIWinStatus::Error;
+	}
+
+	if (!window->win32.inputThreadCreatedWindow) {
+		WaitForSingleObject(window->win32.inputThread, INFINITE);
+		CloseHandle(window->win32.inputThread);
+		window->win32.inputThread = NULL;
+		return JIIWinStatus::Error;
+	}
+
+	return JIIWinStatus::Ok;
+}
+
+JIIPrivate void JIIWinStopInputThread(JIIWindow* window) {
+	// DestroyWindow only works from the thread owning the window, WM_CLOSE gets it there
+	// and the WM_QUIT from WM_DESTROY ends the loop
+	PostMessageA(window->win32.windowHandle, WM_CLOSE, 0, 0);
+
+	WaitForSingleObject(window->win32.inputThread, INFINITE);
+	CloseHandle(window->win32.inputThread);
+	window->win32.inputThread = NULL;
+}
+
+JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height, JIIWindow* window, JIIWinHint hints){
+	// TODO(Sarmis) platform specific
+	JIIAssert(window && title);
+
+	window->callbacks.keyboardCallback = NULL;
+	window->callbacks.mouseMoveCallback = NULL;
+	window->callbacks.mouseButtonCallback = NULL;
+
+	// simply combine hints
+	window->hints = JIIWinResolveHints(hints);
+	window->exited = false;
+
+	window->width = width;
+	window->height = height;
+	window->title = (char*)title;
+
+	JIIWinResetInput(window);
+
+	window->win32 = {};
+
+	if (JIIWinCreateEventQueue(window) != JIIWinStatus::Ok) {
+		return JIIWinStatus::Error;
+	}
+
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinCreateHeadless(window);
+	}
+
+	JIIWinStatus status = JIIHasHint(window->hints, JII_INPUT_THREAD) ? JIIWinStartInputThread(window) : JIIWinCreateNativeWindow(window);
+	if (status != JIIWinStatus::Ok) {
+		return status;
+	}
+
 	if (JIIHasHint(window->hints, JII_NEED_OPENGL)) {
 		JIIWinStatus status = JIIWinGLCreateContext(window);
 		if (status != JIIWinStatus::Ok) {
@@ -717,6 +2149,181 @@ JIIDef void JIIWinCleanWindow(JIIWindow* window) {
 	if (window->win32.glContext) {
 		wglDeleteContext(window->win32.glContext);
 	}
+
+	// the input thread is still pushing into the queue until it is joined
+	if (window->win32.inputThread) {
+		JIIWinStopInputThread(window);
+	}
+
+	JIIWinCleanQueues(window);
+}
+
+#elif !defined(JII_WIN_NO_XCB)
+
+JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height, JIIWindow* window, JIIWinHint hints){
+	JIIAssert(window && title);
+
+	window->callbacks.keyboardCallback = NULL;
+	window->callbacks.mouseMoveCallback = NULL;
+	window->callbacks.mouseButtonCallback = NULL;
+
+	// simply combine hints
+	window->hints = JIIWinResolveHints(hints);
+	window->exited = false;
+
+	window->width = width;
+	window->height = height;
+	window->title = (char*)title;
+
+	JIIWinResetInput(window);
+
+	window->xcb = {};
+
+	if (JIIWinCreateEventQueue(window) != JIIWinStatus::Ok) {
+		return JIIWinStatus::Error;
+	}
+
+	if (JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinCreateHeadless(window);
+	}
+
+	// there is no GLX/EGL context on this backend
+	if (JIIHasHint(window->hints, JII_NEED_OPENGL)) {
+		return JIIWinStatus::Error;
+	}
+
+	int screenIndex = 0;
+	xcb_connection_t* connection = xcb_connect(NULL, &screenIndex);
+	if (xcb_connection_has_error(connection)) {
+		xcb_disconnect(connection);
+		return JIIWinStatus::Error;
+	}
+
+	xcb_screen_iterator_t screens = xcb_setup_roots_iterator(xcb_get_setup(connection));
+	for (int i = 0; i < screenIndex && screens.rem; ++i) {
+		xcb_screen_next(&screens);
+	}
+
+	xcb_screen_t* screen = screens.data;
+	if (!screen) {
+		xcb_disconnect(connection);
+		return JIIWinStatus::Error;
+	}
+
+	window->xcb.connection = connection;
+	window->xcb.windowHandle = xcb_generate_id(connection);
+	window->xcb.width = width;
+	window->xcb.height = height;
+
+	u32 valueMask = XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK;
+	u32 values[] = {
+		screen->black_pixel,
+		XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE |
+		XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
+		XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_STRUCTURE_NOTIFY |
+		XCB_EVENT_MASK_FOCUS_CHANGE
+	};
+
+	xcb_create_window(
+		connection, XCB_COPY_FROM_PARENT, window->xcb.windowHandle, screen->root,
+		0, 0,
+		(u16)width, (u16)height,
+		0,
+		XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual,
+		valueMask, values);
+
+	// both requests go out before waiting on any of the replies
+	xcb_intern_atom_cookie_t protocolsCookie = xcb_intern_atom(connection, 1, 12, "WM_PROTOCOLS");
+	xcb_intern_atom_cookie_t deleteWindowCookie = xcb_intern_atom(connection, 0, 16, "WM_DELETE_WINDOW");
+
+	xcb_atom_t protocolsAtom = JIIWinXcbGetAtomReply(connection, protocolsCookie);
+	window->xcb.deleteWindowAtom = JIIWinXcbGetAtomReply(connection, deleteWindowCookie);
+
+#ifndef JII_WIN_NO_XKB
+	window->xcb.detectableAutoRepeat = JIIWinXcbEnableDetectableAutoRepeat(connection);
+#endif
+
+	if (protocolsAtom != XCB_NONE && window->xcb.deleteWindowAtom != XCB_NONE) {
+		xcb_change_property(connection, XCB_PROP_MODE_REPLACE, window->xcb.windowHandle,
+			protocolsAtom, XCB_ATOM_ATOM, 32, 1, &window->xcb.deleteWindowAtom);
+	}
+
+	xcb_change_property(connection, XCB_PROP_MODE_REPLACE, window->xcb.windowHandle,
+		XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8, (u32)strlen(title), title);
+
+	xcb_map_window(connection, window->xcb.windowHandle);
+
+	if (xcb_flush(connection) <= 0) {
+		JIIWinCleanWindow(window);
+		return JIIWinStatus::Error;
+	}
+
+	if (JIIHasHint(window->hints, JII_INPUT_THREAD)) {
+		if (pthread_create(&window->xcb.inputThread, NULL, JIIWinInputThreadProc, window) != 0) {
+			JIIWinCleanWindow(window);
+			return JIIWinStatus::Error;
+		}
+		window->xcb.hasInputThread = true;
+	}
+
+	return JIIWinStatus::Ok;
+}
+
+JIIDef void JIIWinCleanWindow(JIIWindow* window) {
+	JIIAssert(window);
+
+	// the input thread is still pushing into the queue until it is joined
+	if (window->xcb.hasInputThread) {
+		JIIWinStopInputThread(window);
+	}
+
+	JIIWinCleanQueues(window);
+
+	if (window->xcb.connection) {
+		xcb_destroy_window(window->xcb.connection, window->xcb.windowHandle);
+		xcb_disconnect(window->xcb.connection);
+		window->xcb.connection = NULL;
+	}
 }
 
+#else
+
+JIIDef JIIWinStatus JIIWinCreateWindow(const char* title, int width, int height, JIIWindow* window, JIIWinHint hints){
+	JIIAssert(window && title);
+
+	window->callbacks.keyboardCallback = NULL;
+	window->callbacks.mouseMoveCallback = NULL;
+	window->callbacks.mouseButtonCallback = NULL;
+
+	// simply combine hints
+	window->hints = JIIWinResolveHints(hints);
+	window->exited = false;
+
+	window->width = width;
+	window->height = height;
+	window->title = (char*)title;
+
+	JIIWinResetInput(window);
+	window->eventQueue = {};
+
+	// built with JII_WIN_NO_XCB, there is nothing that could open a real window
+	if (!JIIHasHint(window->hints, JII_HEADLESS)) {
+		return JIIWinStatus::Error;
+	}
+
+	if (JIIWinCreateEventQueue(window) != JIIWinStatus::Ok) {
+		return JIIWinStatus::Error;
+	}
+
+	return JIIWinCreateHeadless(window);
+}
+
+JIIDef void JIIWinCleanWindow(JIIWindow* window) {
+	JIIAssert(window);
+
+	JIIWinCleanQueues(window);
+}
+
+#endif
+
 #endif // JII_WIN_IMPLMENTATION